@@ -0,0 +1,320 @@
+/**
+  ******************************************************************************
+  * @file    adversary.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   选出让玩家最难受的方块, 代替随机数产生方块
+  * @note    引擎要新方块时, 地图中没有下落的方块, 当前方块是上一次选的.
+  *          对每种候选方块k和当前方块的每个放置i, 任务(k, i)求放下i后再放k
+  *          能得到的最好评估值. 7 * 放置数个任务由线程池和调用者一起领取,
+  *          每领一个任务前检查时间, 到时就不再领取; 调用者最多等到时间上限.
+  *          所以超过上限的最多是一个任务的时间(一次放置后的全部放置).
+  *          有任务没算完时随机选择, 与引擎默认的方块一样.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include "adversary.h"
+#include "place.h"
+#include "pool.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+struct adversary_pool
+{
+    pool_t workers;
+
+    // 当前的选择
+    const eval_weights_t *weights;
+    int16_t map[TETRIS_MAP_HEIGHT];
+    uint64_t hash;
+    int8_t curr;                        // 当前方块, -1时只看候选方块本身
+    place_t root[PLACE_MAX];            // 当前方块的放置, 不包括结束游戏的
+    uint8_t count_root;
+    uint32_t tasks;                     // 7 * max(count_root, 1)
+    uint32_t next_task;                 // 下一个待领取的任务
+    uint32_t finished;                  // 完成的任务数
+    uint64_t deadline;                  // ns
+    float value[TETRIS_BRICK_TYPES][PLACE_MAX];          // 每种候选方块在当前方块每个放置之后的值
+};
+
+/* Private define ------------------------------------------------------------*/
+#define     DEAD_SCORE          (-1e30f)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  map上放type能得到的最好评估值
+ */
+static float best_place(const adversary_pool_t *pool, const int16_t *map, uint64_t hash,
+                        uint8_t type, uint8_t lines_before)
+{
+    int16_t child[TETRIS_MAP_HEIGHT];
+    place_t place[PLACE_MAX];
+    tetris_brick_t spawn;
+    uint64_t h;
+    float value, best = DEAD_SCORE;
+    uint8_t n, i, lines, landing;
+
+    tetris_brick_spawn(type, 0, &spawn);
+    n = place_list(map, type, 0, spawn.x, spawn.y, place);
+
+    for (i = 0; i < n; i++)
+    {
+        if (place[i].y < 0)
+            continue;
+
+        h = hash;
+        lines = place_drop(map, child, &h, type, place[i].rotation, place[i].x, place[i].y, &landing);
+        value = eval_board(child, landing, lines_before + lines, pool->weights);
+        if (value > best)
+            best = value;
+    }
+
+    return best;
+}
+
+
+/**
+ * \brief  领取任务直到领完或到时
+ */
+static void work(adversary_pool_t *pool)
+{
+    int16_t child[TETRIS_MAP_HEIGHT];
+    uint64_t hash;
+    uint32_t t, per = (pool->curr < 0) ? 1 : pool->count_root;
+    uint8_t type, i, lines, landing;
+    const place_t *p;
+
+    while (clock_ns() < pool->deadline
+           && (t = __atomic_fetch_add(&pool->next_task, 1, __ATOMIC_RELAXED)) < pool->tasks)
+    {
+        type = (uint8_t)(t / per);
+        i = (uint8_t)(t % per);
+
+        if (pool->curr < 0)
+        {
+            pool->value[type][0] = best_place(pool, pool->map, pool->hash, type, 0);
+        }
+        else
+        {
+            p = &pool->root[i];
+            hash = pool->hash;
+            lines = place_drop(pool->map, child, &hash, (uint8_t)pool->curr, p->rotation,
+                               p->x, p->y, &landing);
+            pool->value[type][i] = best_place(pool, child, hash, type, lines);
+        }
+
+        __atomic_fetch_add(&pool->finished, 1, __ATOMIC_RELEASE);
+    }
+
+    return;
+}
+
+
+// 线程池中一个线程的工作, 各线程领取同一组任务
+static void pick_job(void *arg, uint8_t index)
+{
+    (void)index;
+
+    work(arg);
+
+    return;
+}
+
+
+/**
+ * \brief  准备任务: 当前方块的放置
+ */
+static void prepare(adversary_pool_t *pool, const tetris_t *t, int8_t curr)
+{
+    place_t place[PLACE_MAX];
+    tetris_brick_t spawn;
+    uint8_t n, i;
+
+    tetris_get_map_r(t, pool->map);
+    pool->hash = place_hash(pool->map);
+    pool->curr = curr;
+    pool->count_root = 0;
+
+    if (curr >= 0)
+    {
+        tetris_brick_spawn((uint8_t)curr, 0, &spawn);
+        n = place_list(pool->map, (uint8_t)curr, 0, spawn.x, spawn.y, place);
+        for (i = 0; i < n; i++)
+        {
+            if (place[i].y >= 0)
+                pool->root[pool->count_root++] = place[i];
+        }
+        // 当前方块放不下, 游戏已经要结束了, 只看候选方块本身
+        if (pool->count_root == 0)
+            pool->curr = -1;
+    }
+
+    pool->tasks = TETRIS_BRICK_TYPES * ((pool->curr < 0) ? 1 : pool->count_root);
+    pool->next_task = 0;
+    pool->finished = 0;
+
+    return;
+}
+
+
+/**
+ * \brief  初始化, 启动线程池
+ *
+ * \param  a
+ * \param  threads   线程数, 包括调用adversary_pick()的线程
+ * \param  budget_us 每次选择的时间上限
+ * \param  seed      超过上限时随机选择用
+ *
+ * \return 失败时返回false
+ */
+bool adversary_init(adversary_t *a, uint8_t threads, uint32_t budget_us, uint32_t seed)
+{
+    adversary_pool_t *pool;
+
+    memset(a, 0, sizeof(*a));
+    a->budget_us = budget_us;
+    a->weights = &eval_default_weights;
+    a->seed = (seed != 0) ? seed : 1;
+    a->last = -1;
+
+    if (threads < 1)
+        threads = 1;
+    if (threads > ADVERSARY_THREADS_MAX)
+        threads = ADVERSARY_THREADS_MAX;
+
+    place_init();
+
+    pool = calloc(1, sizeof(*pool));
+    if (pool == NULL)
+        return false;
+
+    if (!pool_init(&pool->workers, threads))
+    {
+        free(pool);
+        return false;
+    }
+    a->pool = pool;
+
+    return true;
+}
+
+
+void adversary_free(adversary_t *a)
+{
+    adversary_pool_t *pool = a->pool;
+
+    if (pool == NULL)
+        return;
+
+    pool_free(&pool->workers);
+    free(pool);
+    a->pool = NULL;
+
+    return;
+}
+
+
+void adversary_reset(adversary_t *a)
+{
+    a->last = -1;
+
+    return;
+}
+
+
+/**
+ * \brief  选择方块
+ *
+ * \param  a
+ * \param  t 引擎实例, 在它的get_random中调用
+ *
+ * \return 方块种类, 取值最小的; 值相同时取种类小的
+ */
+uint8_t adversary_pick(adversary_t *a, const tetris_t *t)
+{
+    adversary_pool_t *pool = a->pool;
+    uint64_t start = clock_ns();
+    uint32_t per, used;
+    float best, worst = 0;
+    uint8_t type, i, pick = 0;
+
+    // 上一次到时后还在算的线程很快就会停下, 等它们停下才能改任务
+    pool_wait(&pool->workers);
+
+    prepare(pool, t, a->last);
+    pool->weights = a->weights;
+    pool->deadline = start + (uint64_t)a->budget_us * 1000;
+
+    pool_start(&pool->workers, pick_job, pool);
+    work(pool);
+    pool_wait_until(&pool->workers, pool->deadline);
+
+    if (__atomic_load_n(&pool->finished, __ATOMIC_ACQUIRE) < pool->tasks)
+    {
+        pick = (uint8_t)(xorshift(&a->seed) % TETRIS_BRICK_TYPES);
+        a->fallbacks++;
+    }
+    else
+    {
+        per = (pool->curr < 0) ? 1 : pool->count_root;
+        for (type = 0; type < TETRIS_BRICK_TYPES; type++)
+        {
+            best = DEAD_SCORE;
+            for (i = 0; i < per; i++)
+            {
+                if (pool->value[type][i] > best)
+                    best = pool->value[type][i];
+            }
+            if (type == 0 || best < worst)
+            {
+                worst = best;
+                pick = type;
+            }
+        }
+    }
+
+    used = (uint32_t)((clock_ns() - start) / 1000);
+    a->picks++;
+    a->total_us += used;
+    if (used > a->max_us)
+        a->max_us = used;
+    a->last = (int8_t)pick;
+
+    return pick;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
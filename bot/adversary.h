@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file    adversary.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   选出让玩家最难受的方块, 代替随机数产生方块
+  * @note    与Bastet相同: 对每种方块求玩家放下当前方块和它之后能得到的最好
+  *          局面, 选其中最差的. 引擎在create_new_brick()中同步调用get_random,
+  *          所以每次选择都有时间上限, 到时没有算完就随机选一个.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _ADVERSARY_H_
+#define _ADVERSARY_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Tetris.h"
+#include "eval.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct adversary_pool adversary_pool_t;
+
+// 前面的设置在任何两次选择之间可以修改, 其它成员只由adversary.c访问
+typedef struct
+{
+    uint32_t budget_us;                 //!< 每次选择的时间上限(微秒)
+    const eval_weights_t *weights;      //!< 玩家的评估权重, 默认eval_default_weights
+
+    uint32_t picks;                     //!< 统计: 选择的次数
+    uint32_t fallbacks;                 //!< 统计: 超过时间上限而随机选择的次数
+    uint64_t total_us;                  //!< 统计: 选择用的时间之和
+    uint32_t max_us;                    //!< 统计: 最长的一次选择
+
+    int8_t last;                        // 上一次选的种类, 即下一次选择时的当前方块
+    uint32_t seed;                      // 随机选择用
+    adversary_pool_t *pool;
+} adversary_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+#define     ADVERSARY_THREADS_MAX   16  // 线程数, 包括调用adversary_pick()的线程
+
+/* Exported functions ------------------------------------------------------- */
+// 启动threads - 1个线程, 失败时返回false
+extern bool adversary_init(adversary_t *a, uint8_t threads, uint32_t budget_us, uint32_t seed);
+extern void adversary_free(adversary_t *a);
+// 每局开始(tetris_init_r())之前调用
+extern void adversary_reset(adversary_t *a);
+
+// 在ops->get_random中调用, 返回方块种类0 - 6; 不能与7-bag一起使用
+extern uint8_t adversary_pick(adversary_t *a, const tetris_t *t);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,375 @@
+/**
+  ******************************************************************************
+  * @file    anytime.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   实时游戏用的随时可中断的机器人
+  * @note    游戏循环与后台线程之间只用一把锁, 游戏循环一侧只用trylock,
+  *          锁被后台线程占用时这一帧什么也不做, 下一帧再试, 所以搜索再慢
+  *          也不会让游戏循环错过一帧. 后台线程只在复制请求和发布结果时持锁.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "anytime.h"
+
+/* Private typedef -----------------------------------------------------------*/
+struct anytime_sync
+{
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool quit;
+
+    // 请求, 由游戏循环写入
+    uint32_t request;                   // 编号, 每个新方块加一
+    int16_t map[TETRIS_MAP_HEIGHT];
+    tetris_brick_t curr;
+    tetris_brick_t next;
+    bool bag;
+    uint8_t types;
+
+    // 结果, 由后台线程写入
+    uint32_t result;                    // 结果对应的请求编号
+    uint8_t depth;                      // 已完成的深度
+    uint8_t rotation;
+    int8_t x;
+};
+
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  后台线程: 对最新的请求迭代加深, 每完成一层发布一次
+ */
+static void *search_thread(void *arg)
+{
+    anytime_t *a = arg;
+    anytime_sync_t *s = a->sync;
+    int16_t map[TETRIS_MAP_HEIGHT];
+    tetris_brick_t curr, next;
+    bot_move_t move;
+    uint32_t seen = 0;
+    uint8_t d, depth;
+
+    pthread_mutex_lock(&s->lock);
+
+    while (!s->quit)
+    {
+        if (seen == s->request)
+        {
+            pthread_cond_wait(&s->wake, &s->lock);
+            continue;
+        }
+
+        seen = s->request;
+        memcpy(map, s->map, sizeof(map));
+        curr = s->curr;
+        next = s->next;
+        a->bot.bag = s->bag;
+        a->bot.types = s->types;
+        depth = a->depth;
+        if (depth < 1)
+            depth = 1;
+        if (depth > BOT_DEPTH_MAX)
+            depth = BOT_DEPTH_MAX;
+        pthread_mutex_unlock(&s->lock);
+
+        for (d = 1; d <= depth; d++)
+        {
+            a->bot.depth = d;
+            bot_think(&a->bot, map, &curr, &next, &move);
+
+            pthread_mutex_lock(&s->lock);
+            // 方块已经变了, 剩下的深度不再有用
+            if (s->quit || s->request != seen)
+                break;
+
+            s->result = seen;
+            s->depth = d;
+            s->rotation = move.rotation;
+            s->x = move.x;
+
+            if (d == depth)
+                break;
+            pthread_mutex_unlock(&s->lock);
+        }
+    }
+
+    pthread_mutex_unlock(&s->lock);
+
+    return NULL;
+}
+
+
+/**
+ * \brief  为当前方块发出请求
+ *
+ * \retval true  已发出
+ *         false 锁被占用, 下一帧再试
+ */
+static bool post(anytime_t *a, const int16_t *map, const tetris_brick_t *curr,
+                 const tetris_brick_t *next)
+{
+    anytime_sync_t *s = a->sync;
+
+    if (pthread_mutex_trylock(&s->lock) != 0)
+        return false;
+
+    a->request = ++s->request;
+    memcpy(s->map, map, sizeof(s->map));
+    s->curr = *curr;
+    s->next = *next;
+    s->bag = a->bag;
+    s->types = a->types;
+
+    pthread_cond_signal(&s->wake);
+    pthread_mutex_unlock(&s->lock);
+
+    return true;
+}
+
+
+/**
+ * \brief  取走比正在执行的结果更深的结果
+ */
+static void take(anytime_t *a)
+{
+    anytime_sync_t *s = a->sync;
+
+    if (pthread_mutex_trylock(&s->lock) != 0)
+        return;
+
+    if (s->result == a->request && s->depth > a->plan_depth)
+    {
+        if (a->started && (s->rotation != a->rotation || s->x != a->x))
+            a->replans++;
+
+        a->rotation = s->rotation;
+        a->x = s->x;
+        a->plan_depth = s->depth;
+        a->planned = true;
+    }
+
+    pthread_mutex_unlock(&s->lock);
+
+    return;
+}
+
+
+/**
+ * \brief  初始化
+ *
+ * \param  a
+ * \param  mode  搜索方式
+ * \param  depth 迭代加深的最大深度
+ * \param  beam  束宽
+ *
+ * \return
+ */
+bool anytime_init(anytime_t *a, bot_mode_t mode, uint8_t depth, uint16_t beam)
+{
+    memset(a, 0, sizeof(*a));
+    a->depth = depth;
+    a->rate = 10;
+    a->think_ms = 100;
+    a->types = 0x7F;
+
+    if (!bot_init(&a->bot, depth, beam))
+        return false;
+    a->bot.mode = mode;
+
+    a->sync = calloc(1, sizeof(*a->sync));
+    if (a->sync == NULL)
+    {
+        bot_free(&a->bot);
+        return false;
+    }
+
+    pthread_mutex_init(&a->sync->lock, NULL);
+    pthread_cond_init(&a->sync->wake, NULL);
+
+    if (pthread_create(&a->sync->thread, NULL, search_thread, a) != 0)
+    {
+        pthread_mutex_destroy(&a->sync->lock);
+        pthread_cond_destroy(&a->sync->wake);
+        free(a->sync);
+        bot_free(&a->bot);
+        return false;
+    }
+
+    return true;
+}
+
+
+void anytime_free(anytime_t *a)
+{
+    anytime_sync_t *s = a->sync;
+
+    pthread_mutex_lock(&s->lock);
+    s->quit = true;
+    pthread_cond_signal(&s->wake);
+    pthread_mutex_unlock(&s->lock);
+    pthread_join(s->thread, NULL);
+
+    pthread_mutex_destroy(&s->lock);
+    pthread_cond_destroy(&s->wake);
+    free(s);
+    a->sync = NULL;
+
+    bot_free(&a->bot);
+
+    return;
+}
+
+
+void anytime_reset(anytime_t *a)
+{
+    a->posted = false;
+
+    return;
+}
+
+
+/**
+ * \brief  每帧调用一次
+ *
+ * \param  a
+ * \param  map  地图, 包括正在下落的方块
+ * \param  curr 当前方块
+ * \param  next 预览方块
+ * \param  now  毫秒时钟
+ * \param  move 执行动作的函数, 如tetris_move
+ *
+ * \return 这一帧执行的动作数
+ */
+uint8_t anytime_step(anytime_t *a, const int16_t *map, const tetris_brick_t *curr,
+                     const tetris_brick_t *next, uint32_t now, anytime_move_t move)
+{
+    uint8_t n = 0;
+    int8_t x = curr->x;
+    bool blocked = false;
+
+    // 下落中的方块y只会增加, 变小或种类改变说明已经换了方块
+    if (!a->posted || a->dropped || curr->y < a->y || curr->type != a->type)
+    {
+        a->y = curr->y;
+        a->type = curr->type;
+
+        if (!post(a, map, curr, next))
+            return 0;
+
+        a->posted = true;
+        a->planned = false;
+        a->started = false;
+        a->dropped = false;
+        a->plan_depth = 0;
+        a->turned = 0;
+        a->spawn_ms = now;
+    }
+    a->y = curr->y;
+
+    take(a);
+
+    // 还没有结果, 或者还可以等更深的结果
+    if (!a->planned || (!a->started && a->plan_depth < a->depth
+                        && (uint32_t)(now - a->spawn_ms) < a->think_ms))
+    {
+        a->last_ms = now;
+        a->credit = 1000;
+        return 0;
+    }
+
+    if (!a->started)
+    {
+        a->started = true;
+        a->decisions++;
+        a->depth_sum += a->plan_depth;
+    }
+
+    a->credit += (uint32_t)(now - a->last_ms) * a->rate;
+    a->last_ms = now;
+
+    while (a->credit >= 1000 && !a->dropped)
+    {
+        a->credit -= 1000;
+        n++;
+
+        if (((a->rotation - a->turned) & 0x03) != 0)
+        {
+            if (!move(dire_rotate))
+            {
+                blocked = true;
+                break;
+            }
+            a->turned++;
+        }
+        else if (x > a->x)
+        {
+            if (!move(dire_left))
+            {
+                blocked = true;
+                break;
+            }
+            x--;
+        }
+        else if (x < a->x)
+        {
+            if (!move(dire_right))
+            {
+                blocked = true;
+                break;
+            }
+            x++;
+        }
+        else
+        {
+            while (move(dire_down));
+            a->dropped = true;
+        }
+    }
+
+    // 动作被挡住(方块在等待时已经落低了), 从当前位置重新搜索
+    if (blocked)
+    {
+        a->failures++;
+        a->posted = false;
+    }
+
+    return n;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,106 @@
+/**
+  ******************************************************************************
+  * @file    anytime.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   实时游戏用的随时可中断的机器人
+  * @note    搜索在后台线程中迭代加深: 深度1, 2, ...依次完成, 每完成一层就
+  *          发布一次结果. 游戏循环每帧调用anytime_step(), 它从不等待后台线程,
+  *          只取走已经发布的最好结果, 按每秒动作数的限制执行其中的几步.
+  *          新方块出现后等到搜索完成最大深度或超过think_ms才开始执行;
+  *          执行中得到更深的结果时改为执行新的结果.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _ANYTIME_H_
+#define _ANYTIME_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Tetris.h"
+#include "bot.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct anytime_sync anytime_sync_t;
+
+// 执行动作的函数, 与tetris_move()相同
+typedef bool (*anytime_move_t)(dire_t direction);
+
+// 前面的设置由游戏循环在任何时候修改, 其它成员只由anytime.c访问
+typedef struct
+{
+    uint8_t depth;                      //!< 迭代加深的最大深度
+    uint16_t rate;                      //!< 每秒最多执行的动作数, 落到底算一个动作
+    uint16_t think_ms;                  //!< 新方块出现后最多等待这么久就开始执行
+    bool bag;                           //!< 游戏使用7-bag, 由tetris_get_bag()取得
+    uint8_t types;                      //!< 预览之后的方块可能的种类, 由tetris_get_bag()取得
+
+    uint32_t decisions;                 //!< 统计: 开始执行的放置数
+    uint32_t depth_sum;                 //!< 统计: 开始执行时已完成的深度之和
+    uint32_t replans;                   //!< 统计: 执行中改为更深结果的次数
+    uint32_t failures;                  //!< 统计: 动作被挡住而重新搜索的次数
+
+    bot_t bot;                          //!< 后台线程使用
+    anytime_sync_t *sync;
+
+    // 游戏循环一侧的执行状态
+    uint32_t request;                   // 当前方块的请求编号
+    bool posted;                        // 已经为当前方块发出请求
+    bool planned;                       // 已经有结果
+    bool started;                       // 已经开始执行
+    bool dropped;                       // 已经落到底, 等待下一个方块
+    uint8_t plan_depth;                 // 正在执行的结果的深度
+    uint8_t rotation;                   // 目标: 从请求时的位置旋转的次数
+    int8_t x;                           // 目标: x坐标
+    uint8_t turned;                     // 已经旋转的次数
+    uint8_t type;                       // 上一帧的方块
+    int8_t y;
+    uint32_t spawn_ms;                  // 发出请求的时间
+    uint32_t last_ms;
+    uint32_t credit;                    // 可以执行的动作数 * 1000
+} anytime_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+// 初始化并启动后台线程, 失败时返回false
+extern bool anytime_init(anytime_t *a, bot_mode_t mode, uint8_t depth, uint16_t beam);
+// 结束后台线程, 释放内存
+extern void anytime_free(anytime_t *a);
+// 丢弃当前的结果, 下一次anytime_step()时重新搜索, 例如玩家交出控制时
+extern void anytime_reset(anytime_t *a);
+
+// 每帧调用一次, 从不阻塞. 参数来自tetris_get_map()和tetris_get_brick(),
+// now为毫秒时钟. 这一帧的动作通过move执行, 返回执行的动作数
+extern uint8_t anytime_step(anytime_t *a, const int16_t *map, const tetris_brick_t *curr,
+                            const tetris_brick_t *next, uint32_t now, anytime_move_t move);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
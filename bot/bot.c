@@ -0,0 +1,842 @@
+/**
+  ******************************************************************************
+  * @file    bot.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   放置方块的机器人
+  * @note    方块的移动在地图的位数组上模拟, 规则与引擎相同: 先在原地旋转,
+  *          再水平移动, 最后落下; 方块落下时还有部分在地图外即为游戏结束.
+  *
+  *          期望搜索的线程池: 每次搜索发布一个任务, 各线程(包括调用者)
+  *          用原子计数器领取第一层的放置, 各自使用自己的置换表, 不共享状态.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include "bot.h"
+#include "place.h"
+#include "pool.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+struct bot_node
+{
+    int16_t map[TETRIS_MAP_HEIGHT];
+    uint64_t hash;                      // 地图的散列值
+    float score;                        // 评估分数
+    float acc;                          // 路径上各次放置的PLACE_SCORE之和
+    uint8_t landing;
+    uint8_t lines;
+    uint8_t root;                       // 第一步的放置序号
+};
+
+struct bot_entry
+{
+    uint64_t key;
+    float value;
+    uint32_t stamp;
+    uint32_t node;                      // 去重记录: 局面在下一层中的序号
+};
+
+// 一个线程的搜索状态
+typedef struct
+{
+    const bot_t *bot;
+    bot_entry_t *table;                 // 缓存未知方块处的估计值
+    uint16_t width;                     // 每层展开的放置数
+    uint64_t salt;                      // 与估计值的键混合, 由value_salt()取得
+    uint64_t placements;
+} search_t;
+
+// 期望搜索的线程池和当前任务
+struct bot_pool
+{
+    pool_t workers;
+    search_t search[BOT_THREADS_MAX];   // search[0]由调用bot_think()的线程使用
+    uint8_t count;                      // 线程数, 包括调用者
+
+    // 当前任务: 对map中的当前方块的每个放置求值
+    const int16_t *map;
+    uint64_t hash;
+    const place_t *root;
+    uint8_t count_root;
+    uint8_t type;                       // 当前方块
+    uint8_t rotation;
+    uint8_t next_type;
+    uint32_t next_root;                 // 下一个待领取的放置
+    float value[4 * TETRIS_MAP_WIDTH];  // 每个放置的值, 即PLACE_MAX个
+};
+
+/* Private define ------------------------------------------------------------*/
+#define     MAP_HEIGHT          TETRIS_MAP_HEIGHT
+
+#define     UNKNOWN_BRICK       TETRIS_BRICK_TYPES     // 预览之后的方块
+
+#define     TABLE_BITS          16              // 置换表大小
+#define     TABLE_SIZE          (1u << TABLE_BITS)
+#define     STAMP_VALUE         0xFFFFFFFFu     // 表项是缓存的估计值而不是去重记录
+
+#define     DEAD_SCORE          (-1.0e6f)
+
+#define     TYPES_ALL           ((1 << TETRIS_BRICK_TYPES) - 1)
+
+/* Private macro -------------------------------------------------------------*/
+// 路径上每次放置的得分: 评估中只与这次放置有关的两项, 之后的放置不再计算它们
+#define     PLACE_SCORE(wt, lines, landing) ((wt)->w[EVAL_LINES] * (lines) + (wt)->w[EVAL_LANDING] * (landing))
+
+/* Private variables ---------------------------------------------------------*/
+// Zobrist散列, 与地图的散列值(place_hash())合用: 下一个方块的种类, 去重时的层数,
+// 估计时的剩余深度和可能出现的种类
+static uint64_t zobrist_brick[TETRIS_BRICK_TYPES + 1];
+static uint64_t zobrist_ply[BOT_DEPTH_MAX];
+static uint64_t zobrist_depth[BOT_DEPTH_MAX + 1];
+static uint64_t zobrist_types[TYPES_ALL + 1];
+
+static bool tables_ready = false;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static void make_tables(void)
+{
+    uint64_t s = 0xB07;
+    uint16_t i;
+
+    if (tables_ready)
+        return;
+
+    place_init();
+
+    for (i = 0; i <= TETRIS_BRICK_TYPES; i++)
+        zobrist_brick[i] = splitmix64(&s);
+    for (i = 0; i < BOT_DEPTH_MAX; i++)
+        zobrist_ply[i] = splitmix64(&s);
+    for (i = 0; i <= BOT_DEPTH_MAX; i++)
+        zobrist_depth[i] = splitmix64(&s);
+    for (i = 0; i <= TYPES_ALL; i++)
+        zobrist_types[i] = splitmix64(&s);
+
+    tables_ready = true;
+
+    return;
+}
+
+
+/**
+ * \brief  估计值的键中除局面外的部分: 展开宽度和是否7-bag不同时值也不同,
+ *         表项在两次搜索之间保留, 束宽或模式改变后不能再用旧的值
+ *
+ * \param  width
+ * \param  bag
+ *
+ * \return
+ */
+static uint64_t value_salt(uint16_t width, bool bag)
+{
+    uint64_t x = ((uint64_t)width << 1) | bag;
+
+    return splitmix64(&x);
+}
+
+
+/**
+ * \brief  置换表: 本次搜索中key已经出现过时返回它的表项, 否则记下key和node
+ */
+static const bot_entry_t *seen_before(bot_t *bot, uint64_t key, uint32_t node)
+{
+    bot_entry_t *e = &bot->table[key & (TABLE_SIZE - 1)];
+
+    if (e->key == key && e->stamp == bot->stamp)
+        return e;
+
+    e->key = key;
+    e->stamp = bot->stamp;
+    e->node = node;
+
+    return NULL;
+}
+
+
+/**
+ * \brief  取出type后可能出现的种类
+ *
+ * \param  bag   使用7-bag
+ * \param  types 取出type之前可能出现的种类
+ * \param  type
+ *
+ * \return
+ */
+static uint8_t types_after(bool bag, uint8_t types, uint8_t type)
+{
+    if (!bag)
+        return TYPES_ALL;
+
+    types &= ~(0x01 << type);
+
+    // 袋空了重新装满
+    return (types != 0) ? types : TYPES_ALL;
+}
+
+
+static float chance(search_t *s, const int16_t *map, uint64_t hash, uint8_t depth, uint8_t types);
+
+
+/**
+ * \brief  已知方块种类时的最好放置的值
+ *
+ * \param  s
+ * \param  map
+ * \param  hash
+ * \param  type
+ * \param  depth 包括这个方块在内还要放置的方块数, 至少为1
+ * \param  types 这个方块之后可能出现的种类
+ *
+ * \return 所有放置都结束游戏时为DEAD_SCORE
+ */
+static float best_place(search_t *s, const int16_t *map, uint64_t hash, uint8_t type,
+                        uint8_t depth, uint8_t types)
+{
+    eval_block_t block[PLACE_MAX / EVAL_LANES];
+    float score[PLACE_MAX], best = DEAD_SCORE, value;
+    int16_t child[PLACE_MAX][MAP_HEIGHT];
+    uint64_t child_hash[PLACE_MAX];
+    uint8_t lines[PLACE_MAX], landing[PLACE_MAX], order[PLACE_MAX];
+    place_t place[PLACE_MAX];
+    tetris_brick_t spawn;
+    uint8_t n, i, j, count;
+
+    tetris_brick_spawn(type, 0, &spawn);
+    n = place_list(map, type, 0, spawn.x, spawn.y, place);
+    s->placements += n;
+
+    for (i = 0, count = 0; i < n; i++)
+    {
+        if (place[i].y < 0)
+            continue;
+
+        child_hash[count] = hash;
+        lines[count] = place_drop(map, child[count], &child_hash[count], type,
+                                  place[i].rotation, place[i].x, place[i].y, &landing[count]);
+        eval_block_put(&block[count / EVAL_LANES], count % EVAL_LANES, child[count],
+                       landing[count], lines[count]);
+        count++;
+    }
+
+    if (count == 0)
+        return DEAD_SCORE;
+
+    eval_blocks(block, (count + EVAL_LANES - 1) / EVAL_LANES, s->bot->weights, score);
+
+    if (depth == 1)
+    {
+        for (i = 0; i < count; i++)
+        {
+            if (score[i] > best)
+                best = score[i];
+        }
+        return best;
+    }
+
+    // 按评估分数插入排序, 只展开最好的width个
+    for (i = 0; i < count; i++)
+    {
+        for (j = i; j > 0 && score[order[j - 1]] < score[i]; j--)
+            order[j] = order[j - 1];
+        order[j] = i;
+    }
+
+    if (count > s->width)
+        count = (uint8_t)s->width;
+
+    for (i = 0; i < count; i++)
+    {
+        j = order[i];
+        value = PLACE_SCORE(s->bot->weights, lines[j], landing[j])
+                + chance(s, child[j], child_hash[j], depth - 1, types);
+        if (value > best)
+            best = value;
+    }
+
+    return best;
+}
+
+
+/**
+ * \brief  未知方块处的估计值: 可能出现的各种方块的最好放置的平均值
+ *
+ * \param  s
+ * \param  map
+ * \param  hash
+ * \param  depth 还要放置的方块数, 至少为1
+ * \param  types 下一个方块可能的种类
+ *
+ * \return 不含map之前各次放置的得分
+ */
+static float chance(search_t *s, const int16_t *map, uint64_t hash, uint8_t depth, uint8_t types)
+{
+    uint64_t key = hash ^ zobrist_depth[depth] ^ zobrist_types[types] ^ s->salt;
+    bot_entry_t *e = &s->table[key & (TABLE_SIZE - 1)];
+    float sum = 0;
+    uint8_t type, n = 0;
+
+    if (e->key == key && e->stamp == STAMP_VALUE)
+        return e->value;
+
+    for (type = 0; type < TETRIS_BRICK_TYPES; type++)
+    {
+        if (!(types & (0x01 << type)))
+            continue;
+
+        sum += best_place(s, map, hash, type, depth, types_after(s->bot->bag, types, type));
+        n++;
+    }
+
+    // 表项可能在递归中被替换, 重新取
+    e = &s->table[key & (TABLE_SIZE - 1)];
+    e->key = key;
+    e->value = sum / n;
+    e->stamp = STAMP_VALUE;
+
+    return e->value;
+}
+
+
+/**
+ * \brief  对当前方块的放置求值, 直到所有放置都被领取
+ *
+ * \param  s
+ * \param  pool
+ */
+static void root_work(search_t *s, bot_pool_t *pool)
+{
+    const bot_t *bot = s->bot;
+    int16_t child[MAP_HEIGHT];
+    uint64_t hash;
+    uint32_t i;
+    uint8_t lines, landing;
+    const place_t *p;
+
+    while ((i = __atomic_fetch_add(&pool->next_root, 1, __ATOMIC_RELAXED)) < pool->count_root)
+    {
+        p = &pool->root[i];
+        if (p->y < 0)
+        {
+            pool->value[i] = DEAD_SCORE;
+            continue;
+        }
+
+        hash = pool->hash;
+        lines = place_drop(pool->map, child, &hash, pool->type, pool->rotation + p->rotation,
+                           p->x, p->y, &landing);
+
+        if (bot->depth <= 1)
+            pool->value[i] = eval_board(child, landing, lines, bot->weights);
+        else
+            pool->value[i] = PLACE_SCORE(bot->weights, lines, landing)
+                             + best_place(s, child, hash, pool->next_type, bot->depth - 1, bot->types);
+    }
+
+    return;
+}
+
+
+// 线程池中一个线程的工作
+static void root_job(void *arg, uint8_t index)
+{
+    bot_pool_t *pool = arg;
+
+    root_work(&pool->search[index], pool);
+
+    return;
+}
+
+
+/**
+ * \brief  结束线程池中的线程并释放
+ *
+ * \param  bot
+ */
+static void workers_stop(bot_t *bot)
+{
+    bot_pool_t *pool = bot->pool;
+    uint8_t i;
+
+    if (pool == NULL)
+        return;
+
+    pool_free(&pool->workers);
+
+    for (i = 0; i < pool->count; i++)
+        free(pool->search[i].table);
+
+    free(pool);
+    bot->pool = NULL;
+
+    return;
+}
+
+
+/**
+ * \brief  按bot->threads建立线程池
+ *
+ * \param  bot
+ *
+ * \return 失败时返回false
+ */
+static bool workers_start(bot_t *bot)
+{
+    bot_pool_t *pool;
+    uint8_t i, count;
+
+    count = bot->threads;
+    if (count < 1)
+        count = 1;
+    if (count > BOT_THREADS_MAX)
+        count = BOT_THREADS_MAX;
+
+    pool = calloc(1, sizeof(*pool));
+    if (pool == NULL)
+        return false;
+
+    for (i = 0; i < count; i++)
+    {
+        pool->search[i].bot = bot;
+        pool->search[i].table = calloc(TABLE_SIZE, sizeof(bot_entry_t));
+        if (pool->search[i].table == NULL)
+            break;
+        pool->count = i + 1;
+    }
+
+    if (pool->count != count || !pool_init(&pool->workers, count))
+    {
+        for (i = 0; i < pool->count; i++)
+            free(pool->search[i].table);
+        free(pool);
+        return false;
+    }
+
+    bot->pool = pool;
+
+    return true;
+}
+
+
+/**
+ * \brief  期望搜索: 第一层的放置分给线程池, 取值最大的
+ *
+ * \param  bot
+ * \param  map   去掉当前方块的地图
+ * \param  curr
+ * \param  next
+ * \param  root  当前方块的放置
+ * \param  n
+ *
+ * \return 选择的放置序号, 所有放置都结束游戏时为-1
+ */
+static int think_expectimax(bot_t *bot, const int16_t *map, const tetris_brick_t *curr,
+                            const tetris_brick_t *next, const place_t *root, uint8_t n)
+{
+    bot_pool_t *pool, solo;
+    float best = DEAD_SCORE;
+    int k = -1;
+    uint8_t i;
+
+    if (bot->pool != NULL && bot->pool->count != bot->threads)
+        workers_stop(bot);
+
+    if (bot->pool != NULL || workers_start(bot))
+    {
+        pool = bot->pool;
+    }
+    else
+    {
+        // 建不了线程池时在本线程中搜索, 估计值与束搜索一样存在bot->table中
+        memset(&solo, 0, sizeof(solo));
+        solo.search[0].bot = bot;
+        solo.search[0].table = bot->table;
+        solo.count = 1;
+        pool = &solo;
+    }
+
+    pool->map = map;
+    pool->hash = place_hash(map);
+    pool->root = root;
+    pool->count_root = n;
+    pool->type = curr->type;
+    pool->rotation = curr->rotation;
+    pool->next_type = next->type;
+    pool->next_root = 0;
+
+    for (i = 0; i < pool->count; i++)
+    {
+        pool->search[i].width = bot->beam;
+        pool->search[i].salt = value_salt(bot->beam, bot->bag);
+        pool->search[i].placements = 0;
+    }
+
+    if (pool == &solo)
+    {
+        root_work(&pool->search[0], pool);
+    }
+    else
+    {
+        pool_start(&pool->workers, root_job, pool);
+        root_work(&pool->search[0], pool);
+        pool_wait(&pool->workers);
+    }
+
+    bot->placements += n;
+    for (i = 0; i < pool->count; i++)
+        bot->placements += pool->search[i].placements;
+
+    // 值相同时取序号小的, 与线程数无关
+    for (i = 0; i < n; i++)
+    {
+        if (pool->value[i] > best)
+        {
+            best = pool->value[i];
+            k = i;
+        }
+    }
+
+    return k;
+}
+
+
+static int compare_node(const void *a, const void *b)
+{
+    float sa = ((const bot_node_t *)a)->score;
+    float sb = ((const bot_node_t *)b)->score;
+
+    return (sa < sb) - (sa > sb);
+}
+
+
+/**
+ * \brief  初始化
+ *
+ * \param  bot
+ * \param  depth 1 - BOT_DEPTH_MAX
+ * \param  beam  1 - BOT_BEAM_MAX
+ *
+ * \return 内存不足时返回false
+ */
+bool bot_init(bot_t *bot, uint8_t depth, uint16_t beam)
+{
+    const uint32_t nodes = (uint32_t)BOT_BEAM_MAX * PLACE_MAX;
+
+    make_tables();
+
+    memset(bot, 0, sizeof(*bot));
+    bot->mode = bot_beam;
+    bot->depth = depth;
+    bot->beam = beam;
+    bot->threads = 1;
+    bot->weights = &eval_default_weights;
+    bot->types = TYPES_ALL;
+
+    bot->node = malloc(nodes * sizeof(bot->node[0]));
+    bot->next = malloc(nodes * sizeof(bot->next[0]));
+    bot->block = calloc(nodes / EVAL_LANES, sizeof(bot->block[0]));
+    bot->score = malloc(nodes * sizeof(bot->score[0]));
+    bot->table = calloc(TABLE_SIZE, sizeof(bot->table[0]));
+
+    if (bot->node == NULL || bot->next == NULL || bot->block == NULL
+        || bot->score == NULL || bot->table == NULL)
+    {
+        bot_free(bot);
+        return false;
+    }
+
+    return true;
+}
+
+
+void bot_free(bot_t *bot)
+{
+    workers_stop(bot);
+
+    free(bot->node);
+    free(bot->next);
+    free(bot->block);
+    free(bot->score);
+    free(bot->table);
+
+    bot->node = bot->next = NULL;
+    bot->block = NULL;
+    bot->score = NULL;
+    bot->table = NULL;
+
+    return;
+}
+
+
+void bot_clear(bot_t *bot)
+{
+    uint8_t i;
+
+    memset(bot->table, 0, TABLE_SIZE * sizeof(bot->table[0]));
+
+    if (bot->pool != NULL)
+    {
+        for (i = 0; i < bot->pool->count; i++)
+            memset(bot->pool->search[i].table, 0, TABLE_SIZE * sizeof(bot->table[0]));
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  束搜索: 已知的两个方块各保留最好的beam个局面
+ *
+ * \param  bot
+ * \param  map   去掉当前方块的地图
+ * \param  curr
+ * \param  next
+ * \param  root  当前方块的放置
+ * \param  n
+ *
+ * \return 选择的放置序号, 所有放置都结束游戏时为-1
+ */
+static int think_beam(bot_t *bot, const int16_t *map, const tetris_brick_t *curr,
+                      const tetris_brick_t *next, const place_t *root, uint8_t n)
+{
+    search_t search = { bot, bot->table, PLACE_MAX, value_salt(PLACE_MAX, bot->bag), 0 };
+    place_t place[PLACE_MAX];
+    uint8_t brick[2], depth, type, i, r;
+    uint32_t count, size, j, k;
+    tetris_brick_t spawn;
+    bot_node_t *node, *child, *swap, *dup;
+    const bot_entry_t *e;
+
+    depth = bot->depth;
+    brick[0] = curr->type;
+    brick[1] = next->type;
+
+    node = &bot->node[0];
+    memcpy(node->map, map, sizeof(node->map));
+    node->hash = place_hash(node->map);
+    node->acc = 0;
+    node->score = 0;
+    node->root = 0;
+    size = 1;
+
+    bot->stamp++;
+    if (bot->stamp == STAMP_VALUE)
+        bot->stamp = 1;
+
+    for (i = 0; i < depth && i < 2; i++)
+    {
+        type = brick[i];
+        count = 0;
+
+        for (j = 0; j < size; j++)
+        {
+            node = &bot->node[j];
+
+            if (i == 0)
+            {
+                memcpy(place, root, n * sizeof(place[0]));
+                r = n;
+            }
+            else
+            {
+                tetris_brick_spawn(type, 0, &spawn);
+                r = place_list(node->map, type, 0, spawn.x, spawn.y, place);
+            }
+            bot->placements += r;
+
+            for (k = 0; k < r; k++)
+            {
+                if (place[k].y < 0)
+                    continue;
+
+                child = &bot->next[count];
+                child->hash = node->hash;
+                child->lines = place_drop(node->map, child->map, &child->hash, type,
+                                          place[k].rotation + (i == 0 ? curr->rotation : 0),
+                                          place[k].x, place[k].y, &child->landing);
+
+                child->acc = node->acc + PLACE_SCORE(bot->weights, child->lines, child->landing);
+                child->root = (i == 0) ? (uint8_t)k : node->root;
+
+                // 同一层中已经出现过的局面: 地图相同时分数只差在acc上, 留下acc大的
+                e = seen_before(bot, child->hash ^ zobrist_brick[i + 1 < 2 ? brick[i + 1] : UNKNOWN_BRICK]
+                                     ^ zobrist_ply[i], count);
+                if (e != NULL)
+                {
+                    bot->transpositions++;
+                    dup = &bot->next[e->node];
+                    if (child->acc > dup->acc)
+                    {
+                        dup->acc = child->acc;
+                        dup->root = child->root;
+                        dup->lines = child->lines;
+                        dup->landing = child->landing;
+                        eval_block_put(&bot->block[e->node / EVAL_LANES], e->node % EVAL_LANES,
+                                       dup->map, dup->landing, dup->lines);
+                    }
+                    continue;
+                }
+
+                eval_block_put(&bot->block[count / EVAL_LANES], count % EVAL_LANES,
+                               child->map, child->landing, child->lines);
+                count++;
+            }
+        }
+
+        // 所有放置都会结束游戏
+        if (count == 0)
+            break;
+
+        eval_blocks(bot->block, (count + EVAL_LANES - 1) / EVAL_LANES, bot->weights, bot->score);
+        for (j = 0; j < count; j++)
+        {
+            child = &bot->next[j];
+            child->score = bot->score[j] + child->acc - PLACE_SCORE(bot->weights, child->lines, child->landing);
+        }
+
+        qsort(bot->next, count, sizeof(bot->next[0]), compare_node);
+        size = (count < bot->beam) ? count : bot->beam;
+
+        swap = bot->node;
+        bot->node = bot->next;
+        bot->next = swap;
+    }
+
+    // 第一个方块没有不结束游戏的放置
+    if (i == 0)
+        return -1;
+
+    // 预览之后的方块未知, 用估计值代替评估分数
+    if (depth > 2 && i == 2)
+    {
+        for (j = 0; j < size; j++)
+        {
+            node = &bot->node[j];
+            node->score = node->acc + chance(&search, node->map, node->hash, depth - 2, bot->types);
+        }
+        qsort(bot->node, size, sizeof(bot->node[0]), compare_node);
+    }
+    bot->placements += search.placements;
+
+    return bot->node[0].root;
+}
+
+
+/**
+ * \brief  选择当前方块的放置
+ *
+ * \param  bot
+ * \param  map  tetris_get_map()的结果, 包括正在下落的方块
+ * \param  curr 当前方块
+ * \param  next 下一个方块
+ * \param  move 选择的放置
+ *
+ * \retval true  找到不结束游戏的放置
+ *         false 所有放置都会结束游戏, move为第一个放置(如果有)
+ */
+bool bot_think(bot_t *bot, const int16_t *map, const tetris_brick_t *curr,
+               const tetris_brick_t *next, bot_move_t *move)
+{
+    place_t root[PLACE_MAX];
+    int16_t base[MAP_HEIGHT];
+    uint64_t hash;
+    uint8_t n, r;
+    int k;
+
+    if (bot->depth < 1)
+        bot->depth = 1;
+    if (bot->depth > BOT_DEPTH_MAX)
+        bot->depth = BOT_DEPTH_MAX;
+    if (bot->beam < 1)
+        bot->beam = 1;
+    if (bot->beam > BOT_BEAM_MAX)
+        bot->beam = BOT_BEAM_MAX;
+    if (bot->threads < 1)
+        bot->threads = 1;
+    if (bot->threads > BOT_THREADS_MAX)
+        bot->threads = BOT_THREADS_MAX;
+    if ((bot->types & TYPES_ALL) == 0)
+        bot->types = TYPES_ALL;
+
+    // 去掉地图中正在下落的方块
+    memcpy(base, map, sizeof(base));
+    place_remove(base, curr);
+
+    n = place_list(base, curr->type, curr->rotation, curr->x, curr->y, root);
+    if (n == 0)
+        return false;
+
+    if (bot->mode == bot_expectimax)
+        k = think_expectimax(bot, base, curr, next, root, n);
+    else
+        k = think_beam(bot, base, curr, next, root, n);
+
+    hash = place_hash(base);
+    move->rotation = root[(k >= 0) ? k : 0].rotation;
+    move->x = root[(k >= 0) ? k : 0].x;
+    move->y = root[(k >= 0) ? k : 0].y;
+    move->lines = place_drop(base, move->map, &hash, curr->type, curr->rotation + move->rotation,
+                             move->x, move->y, &r);
+
+    return k >= 0;
+}
+
+
+/**
+ * \brief  执行放置: 旋转, 水平移动, 然后一直下移直到落下
+ *
+ * \param  t
+ * \param  move
+ */
+void bot_apply(tetris_t *t, const bot_move_t *move)
+{
+    tetris_brick_t curr;
+    uint8_t i;
+
+    for (i = 0; i < move->rotation; i++)
+        tetris_move_r(t, dire_rotate);
+
+    tetris_get_brick_r(t, &curr, NULL);
+    for (; curr.x > move->x; curr.x--)
+        tetris_move_r(t, dire_left);
+    for (; curr.x < move->x; curr.x++)
+        tetris_move_r(t, dire_right);
+
+    while (tetris_move_r(t, dire_down));
+
+    return;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,118 @@
+/**
+  ******************************************************************************
+  * @file    bot.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   放置方块的机器人
+  * @note    每一步列出当前方块所有能到达的位置, 用局面评估打分, 再用预览的
+  *          下一个方块做束搜索; 同一层中相同的局面由Zobrist散列去重.
+  *          预览之后的方块未知, 深度超过2时按可能出现的方块的平均值估计.
+  *
+  *          期望搜索模式不剪掉第一层: 当前方块的每个放置分给线程池中的线程,
+  *          各自对之后的方块做期望最大搜索, 未知方块处取可能的种类的平均值
+  *          (7-bag时只取袋中剩下的种类), 其余每层只展开评估最好的beam个放置.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _BOT_H_
+#define _BOT_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Tetris.h"
+#include "eval.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define     BOT_DEPTH_MAX       4       // 最大搜索深度(方块数)
+#define     BOT_BEAM_MAX        256     // 最大束宽
+#define     BOT_THREADS_MAX     16      // 期望搜索的最大线程数
+
+/* Exported types ------------------------------------------------------------*/
+// 一次放置: 在当前位置旋转rotation次, 水平移动到x, 然后落到底
+typedef struct
+{
+    uint8_t rotation;                   //!< 旋转次数
+    int8_t x;                           //!< 移动后方块的x坐标
+    int8_t y;                           //!< 落下后方块的y坐标
+    uint8_t lines;                      //!< 消除的行数
+    int16_t map[TETRIS_MAP_HEIGHT];     //!< 落下并消行后的地图
+} bot_move_t;
+
+// 搜索方式
+typedef enum
+{
+    bot_beam,           //!< 束搜索
+    bot_expectimax,     //!< 期望最大搜索, 第一层分给多个线程
+} bot_mode_t;
+
+typedef struct bot_node bot_node_t;
+typedef struct bot_entry bot_entry_t;
+typedef struct bot_pool bot_pool_t;
+
+// 机器人实例, 前面的设置可以在两次搜索之间修改, 其它成员只由bot.c访问
+typedef struct
+{
+    bot_mode_t mode;
+    uint8_t depth;                      //!< 搜索深度, 1只看当前方块, 2加上预览
+    uint16_t beam;                      //!< 束宽, 每层保留的局面数; 期望搜索时每层展开的放置数
+    uint8_t threads;                    //!< 期望搜索的线程数, 包括调用bot_think()的线程
+    const eval_weights_t *weights;      //!< 评估权重, 修改后要调用bot_clear()
+    bool bag;                           //!< 游戏使用7-bag, 由tetris_get_bag()取得
+    uint8_t types;                      //!< 预览之后的方块可能的种类, 由tetris_get_bag()取得
+
+    uint64_t placements;                //!< 统计: 搜索过的放置数
+    uint64_t transpositions;            //!< 统计: 因局面重复被跳过的放置数
+
+    bot_node_t *node;                   //!< 当前层的局面
+    bot_node_t *next;                   //!< 下一层的候选局面
+    eval_block_t *block;                //!< 候选局面的并行评估
+    float *score;
+    bot_entry_t *table;                 //!< 置换表
+    uint32_t stamp;                     //!< 本次搜索的编号, 用于去重
+    bot_pool_t *pool;                   //!< 期望搜索的线程池
+} bot_t;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+// 初始化, 分配搜索用的内存, 失败时返回false
+extern bool bot_init(bot_t *bot, uint8_t depth, uint16_t beam);
+extern void bot_free(bot_t *bot);
+// 清空置换表中缓存的估计值, 修改权重后调用
+extern void bot_clear(bot_t *bot);
+
+// 为当前方块选择放置位置, 参数来自tetris_get_map()和tetris_get_brick()
+// map中包括正在下落的方块; 所有放置都会结束游戏时返回false
+extern bool bot_think(bot_t *bot, const int16_t *map, const tetris_brick_t *curr,
+                      const tetris_brick_t *next, bot_move_t *move);
+// 通过tetris_move_r()执行放置, 方块落下后返回
+extern void bot_apply(tetris_t *t, const bot_move_t *move);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
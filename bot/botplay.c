@@ -0,0 +1,288 @@
+/**
+  ******************************************************************************
+  * @file    botplay.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   让机器人玩若干局, 报告搜索速度和每局消行数
+  * @note    机器人只通过引擎的接口玩: tetris_get_map_r(), tetris_get_brick_r()
+  *          取得局面, tetris_move_r()执行放置. 每次放置后检查引擎的地图与
+  *          机器人预计的相同.
+  *
+  *          引擎默认的随机方块很难让机器人输掉, 比较强弱时可以用-G每隔几个
+  *          方块加一行垃圾行, 以每局的方块数和消行数比较. -A时方块不再随机,
+  *          每次选对机器人最差的(见adversary.c), 参数为每次选择的时间上限.
+  *
+  *          用法: botplay [-g 局数] [-d 深度] [-w 束宽] [-p 每局最多方块数] [-s 种子]
+  *                        [-x 期望搜索] [-t 线程数] [-b 7-bag] [-G 垃圾行间隔]
+  *                        [-f 用最少的按键移动方块] [-A 微秒]
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Tetris.h"
+#include "bot.h"
+#include "finesse.h"
+#include "adversary.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static void count_lines(tetris_t *t, uint8_t line);
+static uint8_t worst_random(tetris_t *t);
+
+/* Private functions ---------------------------------------------------------*/
+
+static const tetris_ops_t game_ops = { NULL, NULL, NULL, count_lines };
+static const tetris_ops_t adversary_ops = { NULL, worst_random, NULL, count_lines };
+
+static adversary_t adversary;
+
+
+static void count_lines(tetris_t *t, uint8_t line)
+{
+    *(unsigned long *)t->user += line;
+
+    return;
+}
+
+
+static uint8_t worst_random(tetris_t *t)
+{
+    return adversary_pick(&adversary, t);
+}
+
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-g games] [-d depth 1-%d] [-w beam 1-%d] [-p pieces] [-s seed]\n"
+                    "       [-x] expectimax [-t threads 1-%d] [-b] 7-bag [-G pieces per garbage row]\n"
+                    "       [-f] move with the fewest keys\n"
+                    "       [-A us] worst pieces chosen within this budget, not with -b\n",
+            name, BOT_DEPTH_MAX, BOT_BEAM_MAX, BOT_THREADS_MAX);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    unsigned long games = 10, limit = 5000, seed = 1;
+    unsigned long g, pieces, lines, total_pieces = 0, total_lines = 0;
+    unsigned long depth = 2, beam = 32, threads = 1, garbage = 0, budget = 0;
+    uint16_t features[EVAL_FEATURES];
+    double height = 0, holes = 0;
+    bool expectimax = false, bag = false, finesse = false;
+    unsigned long keys = 0, moves = 0, naive = 0, cached = 0;
+    finesse_path_t path;
+    place_t target;
+    uint32_t hole = 1;
+    int16_t map[TETRIS_MAP_HEIGHT], base[TETRIS_MAP_HEIGHT];
+    tetris_brick_t curr, next;
+    bot_move_t move;
+    tetris_t game;
+    bot_t bot;
+    double start, think = 0, used, slowest = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "g:d:w:p:s:xt:bG:fA:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'g':
+            games = strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            depth = strtoul(optarg, NULL, 0);
+            break;
+        case 'w':
+            beam = strtoul(optarg, NULL, 0);
+            break;
+        case 'p':
+            limit = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = strtoul(optarg, NULL, 0);
+            break;
+        case 'x':
+            expectimax = true;
+            break;
+        case 't':
+            threads = strtoul(optarg, NULL, 0);
+            break;
+        case 'b':
+            bag = true;
+            break;
+        case 'G':
+            garbage = strtoul(optarg, NULL, 0);
+            break;
+        case 'f':
+            finesse = true;
+            break;
+        case 'A':
+            budget = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (optind != argc || games == 0 || depth < 1 || depth > BOT_DEPTH_MAX
+        || beam < 1 || beam > BOT_BEAM_MAX || threads < 1 || threads > BOT_THREADS_MAX
+        || (budget > 0 && (bag || threads > ADVERSARY_THREADS_MAX)))
+        return usage(argv[0]);
+
+    if (!bot_init(&bot, (uint8_t)depth, (uint16_t)beam))
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    bot.mode = expectimax ? bot_expectimax : bot_beam;
+    bot.threads = (uint8_t)threads;
+    finesse_init();
+
+    // 选方块的线程与机器人的线程轮流工作, 使用相同的线程数
+    if (budget > 0 && !adversary_init(&adversary, (uint8_t)threads, (uint32_t)budget, (uint32_t)seed))
+    {
+        fprintf(stderr, "cannot start the adversary threads\n");
+        return 1;
+    }
+
+    for (g = 0; g < games; g++)
+    {
+        lines = 0;
+        adversary_reset(&adversary);
+        tetris_init_r(&game, (budget > 0) ? &adversary_ops : &game_ops, &lines, (uint32_t)(seed + g));
+        if (bag)
+            tetris_use_bag_r(&game);
+
+        for (pieces = 0; pieces < limit && !tetris_is_game_over_r(&game); pieces++)
+        {
+            tetris_get_map_r(&game, map);
+            tetris_get_brick_r(&game, &curr, &next);
+            bot.bag = tetris_get_bag_r(&game, &bot.types);
+
+            start = clock_sec();
+            bot_think(&bot, map, &curr, &next, &move);
+            used = clock_sec() - start;
+            think += used;
+            if (used > slowest)
+                slowest = used;
+
+            if (finesse)
+            {
+                memcpy(base, map, sizeof(base));
+                place_remove(base, &curr);
+                target.rotation = move.rotation;
+                target.x = move.x;
+                target.y = move.y;
+                if (!finesse_plan(base, &curr, &target, &path))
+                {
+                    fprintf(stderr, "game %lu piece %lu: no path to the placement\n", g, pieces);
+                    return 1;
+                }
+                finesse_apply(&game, &path);
+
+                keys += path.count;
+                moves += path.moves;
+                naive += move.rotation + abs(move.x - curr.x);
+                cached += path.cached;
+            }
+            else
+            {
+                bot_apply(&game, &move);
+            }
+
+            // 新方块出现时完全在地图上方, 地图中只有落下的方块
+            tetris_get_map_r(&game, map);
+            if (!tetris_is_game_over_r(&game) && memcmp(map, move.map, sizeof(map)) != 0)
+            {
+                fprintf(stderr, "game %lu piece %lu: the engine disagrees with the bot\n", g, pieces);
+                return 1;
+            }
+
+            // 每次放置后的平均列高和空洞数, 不受游戏长短的影响, 用于比较每一步的好坏
+            eval_features(move.map, 0, 0, features);
+            height += features[EVAL_HEIGHT] / (double)TETRIS_MAP_WIDTH;
+            holes += features[EVAL_HOLES];
+
+            if (garbage > 0 && pieces % garbage == garbage - 1)
+            {
+                hole ^= hole << 13;
+                hole ^= hole >> 17;
+                hole ^= hole << 5;
+                tetris_add_garbage_r(&game, 1, (uint8_t)(hole % TETRIS_MAP_WIDTH));
+            }
+        }
+
+        printf("game %lu: %lu pieces, %lu lines%s\n", g, pieces, lines,
+               tetris_is_game_over_r(&game) ? "" : " (piece limit)");
+        total_pieces += pieces;
+        total_lines += lines;
+    }
+
+    printf("%s depth %lu, beam %lu, %lu thread(s)%s: %.1f lines/game, %.1f pieces/game\n",
+           expectimax ? "expectimax" : "beam", depth, beam, threads, bag ? ", 7-bag" : "",
+           (double)total_lines / games, (double)total_pieces / games);
+    printf("after each piece: %.2f average column height, %.2f holes\n",
+           height / total_pieces, holes / total_pieces);
+    printf("%llu placements searched, %.0f placements/s, %.3f ms/piece (max %.3f), %.1f%% transpositions\n",
+           (unsigned long long)bot.placements, bot.placements / think,
+           think * 1000 / total_pieces, slowest * 1000, 100.0 * bot.transpositions / bot.placements);
+
+    if (finesse)
+        printf("%.2f keys/piece, %.2f moves/piece (%.2f rotating before moving), %.1f%% from the table\n",
+               (double)keys / total_pieces, (double)moves / total_pieces,
+               (double)naive / total_pieces, 100.0 * cached / total_pieces);
+
+    if (budget > 0)
+    {
+        printf("adversary: %.1f us/piece (max %u), %.1f%% random after the %lu us budget\n",
+               (double)adversary.total_us / adversary.picks, adversary.max_us,
+               100.0 * adversary.fallbacks / adversary.picks, budget);
+        adversary_free(&adversary);
+    }
+    bot_free(&bot);
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
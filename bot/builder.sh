@@ -0,0 +1,36 @@
+#!/bin/sh
+# 在主机上编译机器人和测试程序, 用法见各程序开头的说明
+# -march=native让popcount成为一条指令, 去掉时eval.c退回到普通的实现
+
+CFLAGS="-std=gnu99 -O2 -march=native -Wall -I../src -I../tools/replay"
+
+gcc $CFLAGS -c evalbench.c || exit 1
+gcc $CFLAGS -c botplay.c || exit 1
+gcc $CFLAGS -c mctsplay.c || exit 1
+gcc $CFLAGS -c tune.c || exit 1
+gcc $CFLAGS -c pcbench.c || exit 1
+gcc $CFLAGS -c pclear.c || exit 1
+gcc $CFLAGS -c grade.c || exit 1
+gcc $CFLAGS -c optimal.c || exit 1
+gcc $CFLAGS -c ../tools/replay/replay.c || exit 1
+gcc $CFLAGS -c bot.c || exit 1
+gcc $CFLAGS -c pool.c || exit 1
+gcc $CFLAGS -c mcts.c || exit 1
+gcc $CFLAGS -c liveplay.c || exit 1
+gcc $CFLAGS -c anytime.c || exit 1
+gcc $CFLAGS -c adversary.c || exit 1
+gcc $CFLAGS -c place.c || exit 1
+gcc $CFLAGS -c finesse.c || exit 1
+gcc $CFLAGS -c eval.c || exit 1
+gcc $CFLAGS -c ../src/Tetris.c || exit 1
+gcc $CFLAGS -c ../src/util.c || exit 1
+gcc -o evalbench evalbench.o eval.o Tetris.o util.o -lm || exit 1
+gcc -o botplay botplay.o adversary.o bot.o pool.o finesse.o place.o eval.o Tetris.o util.o -lpthread || exit 1
+gcc -o mctsplay mctsplay.o mcts.o bot.o pool.o place.o eval.o Tetris.o util.o -lpthread -lm || exit 1
+gcc -o liveplay liveplay.o anytime.o bot.o pool.o place.o eval.o Tetris.o util.o -lpthread || exit 1
+gcc -o tune tune.o bot.o pool.o place.o eval.o Tetris.o util.o -lpthread -lm || exit 1
+gcc -o pcbench pcbench.o pclear.o bot.o pool.o place.o eval.o Tetris.o util.o -lpthread || exit 1
+
+gcc -o grade grade.o optimal.o finesse.o replay.o bot.o pool.o place.o eval.o Tetris.o util.o -lpthread || exit 1
+
+rm -f *.o
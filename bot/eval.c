@@ -0,0 +1,300 @@
+/**
+  ******************************************************************************
+  * @file    eval.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   机器人用的局面评估
+  * @note    所有特征都由每行10位的行数据按位计算, 不逐格访问地图.
+  *          从上到下扫描, acc为到当前行为止所有行的或(前缀或), acc中的
+  *          位表示这一列在当前行已经到达(或低于)列顶:
+  *            高度之和   = 每行 popcount(acc) 之和
+  *            空洞       = 每行 popcount(上方的acc & ~row) 之和
+  *            高度差之和 = 每行 popcount(acc ^ (acc >> 1)) 之和,
+  *                         相邻两列只有在高度差的那几行中一列到达一列未到
+  *            井         = 这一列未到达而左右两列(墙算到达)都已到达的格子
+  *          地图上方的空行对前五个特征都只贡献常数, 直接跳过.
+  *          块(EVAL_LANES个局面)的评估在有SSE2时以16位通道同时计算
+  *          8个局面, popcount用SWAR方法.
+  ******************************************************************************
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "eval.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define     ROW_MASK            0x03FF
+#define     LEFT_WALL           0x0001      // 行左移一位后, bit0为左墙
+#define     RIGHT_WALL          0x0200      // 行右移一位后, bit9为右墙
+
+/* Private macro -------------------------------------------------------------*/
+#define     POPCOUNT(x)         ((uint16_t)__builtin_popcount(x))
+
+// 行加上两边的墙后相邻两格不同的次数
+#define     ROW_TRANS(row)      POPCOUNT(((((row) << 1) | 0x0801) ^ ((((row) << 1) | 0x0801) >> 1)) & 0x07FF)
+
+/* Private variables ---------------------------------------------------------*/
+// Dellacherie的权重, 井为井的格数而不是累计深度, 没有使用高度和高度差
+const eval_weights_t eval_default_weights =
+{
+    {
+        0.0f,           // EVAL_HEIGHT
+        -7.899f,        // EVAL_HOLES
+        0.0f,           // EVAL_BUMPINESS
+        -3.386f,        // EVAL_WELLS
+        -3.218f,        // EVAL_ROW_TRANSITIONS
+        -9.349f,        // EVAL_COL_TRANSITIONS
+        -4.500f,        // EVAL_LANDING
+        3.418f,         // EVAL_LINES
+    }
+};
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  计算特征
+ *
+ * \param  map      TETRIS_MAP_HEIGHT行, map[0]为最上方
+ * \param  landing  最后放下的方块的高度
+ * \param  lines    最后放下的方块消除的行数
+ * \param  features EVAL_FEATURES个
+ */
+void eval_features(const int16_t *map, uint8_t landing, uint8_t lines, uint16_t *features)
+{
+    uint16_t acc = 0, prev = 0, row;
+    uint16_t height = 0, holes = 0, bump = 0, wells = 0, row_trans = 0, col_trans = 0;
+    uint8_t y;
+
+    // 上方的空行, 每行只有两边墙与空格之间的两次交替
+    for (y = 0; y < TETRIS_MAP_HEIGHT && map[y] == 0; y++)
+        row_trans += 2;
+
+    for (; y < TETRIS_MAP_HEIGHT; y++)
+    {
+        row = (uint16_t)map[y] & ROW_MASK;
+
+        holes += POPCOUNT(acc & ~row);
+        acc |= row;
+
+        height += POPCOUNT(acc);
+        bump += POPCOUNT((acc ^ (acc >> 1)) & (ROW_MASK >> 1));
+        wells += POPCOUNT(~acc & ((acc << 1) | LEFT_WALL) & ((acc >> 1) | RIGHT_WALL) & ROW_MASK);
+        row_trans += ROW_TRANS(row);
+        col_trans += POPCOUNT(row ^ prev);
+
+        prev = row;
+    }
+
+    // 底部算满
+    col_trans += POPCOUNT(~prev & ROW_MASK);
+
+    features[EVAL_HEIGHT] = height;
+    features[EVAL_HOLES] = holes;
+    features[EVAL_BUMPINESS] = bump;
+    features[EVAL_WELLS] = wells;
+    features[EVAL_ROW_TRANSITIONS] = row_trans;
+    features[EVAL_COL_TRANSITIONS] = col_trans;
+    features[EVAL_LANDING] = landing;
+    features[EVAL_LINES] = lines;
+
+    return;
+}
+
+
+/**
+ * \brief  一个局面的分数
+ */
+float eval_board(const int16_t *map, uint8_t landing, uint8_t lines, const eval_weights_t *w)
+{
+    uint16_t f[EVAL_FEATURES];
+    float score = 0;
+    uint8_t i;
+
+    eval_features(map, landing, lines, f);
+
+    for (i = 0; i < EVAL_FEATURES; i++)
+        score += w->w[i] * f[i];
+
+    return score;
+}
+
+
+/**
+ * \brief  把一个局面放入块中
+ */
+void eval_block_put(eval_block_t *block, uint8_t lane, const int16_t *map,
+                    uint8_t landing, uint8_t lines)
+{
+    uint8_t y;
+
+    for (y = 0; y < TETRIS_MAP_HEIGHT; y++)
+        block->row[y][lane] = (uint16_t)map[y] & ROW_MASK;
+
+    block->landing[lane] = landing;
+    block->lines[lane] = lines;
+
+    return;
+}
+
+
+#ifdef __SSE2__
+
+/**
+ * \brief  8个16位通道分别popcount
+ */
+static __m128i popcount16(__m128i x)
+{
+    x = _mm_sub_epi16(x, _mm_and_si128(_mm_srli_epi16(x, 1), _mm_set1_epi16(0x5555)));
+    x = _mm_add_epi16(_mm_and_si128(x, _mm_set1_epi16(0x3333)),
+                      _mm_and_si128(_mm_srli_epi16(x, 2), _mm_set1_epi16(0x3333)));
+    x = _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 4)), _mm_set1_epi16(0x0F0F));
+
+    return _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), _mm_set1_epi16(0x001F));
+}
+
+
+/**
+ * \brief  score += w * 8个16位特征
+ */
+static void accumulate(__m128 *lo, __m128 *hi, __m128i feature, float w)
+{
+    __m128 wv = _mm_set1_ps(w);
+    __m128i zero = _mm_setzero_si128();
+
+    *lo = _mm_add_ps(*lo, _mm_mul_ps(wv, _mm_cvtepi32_ps(_mm_unpacklo_epi16(feature, zero))));
+    *hi = _mm_add_ps(*hi, _mm_mul_ps(wv, _mm_cvtepi32_ps(_mm_unpackhi_epi16(feature, zero))));
+
+    return;
+}
+
+
+/**
+ * \brief  同时评估一个块中的8个局面
+ */
+static void eval_block(const eval_block_t *block, const eval_weights_t *w, float *score)
+{
+    const __m128i mask = _mm_set1_epi16(ROW_MASK);
+    const __m128i bump_mask = _mm_set1_epi16(ROW_MASK >> 1);
+    const __m128i walls = _mm_set1_epi16(0x0801);
+    const __m128i trans_mask = _mm_set1_epi16(0x07FF);
+    const __m128i left_wall = _mm_set1_epi16(LEFT_WALL);
+    const __m128i right_wall = _mm_set1_epi16(RIGHT_WALL);
+    __m128i acc = _mm_setzero_si128(), prev = _mm_setzero_si128();
+    __m128i height = acc, holes = acc, bump = acc, wells = acc, row_trans = acc, col_trans = acc;
+    __m128i row, t;
+    __m128 lo = _mm_setzero_ps(), hi = _mm_setzero_ps();
+    uint8_t y;
+
+    for (y = 0; y < TETRIS_MAP_HEIGHT; y++)
+    {
+        row = _mm_loadu_si128((const __m128i *)block->row[y]);
+
+        holes = _mm_add_epi16(holes, popcount16(_mm_andnot_si128(row, acc)));
+        acc = _mm_or_si128(acc, row);
+
+        height = _mm_add_epi16(height, popcount16(acc));
+        bump = _mm_add_epi16(bump, popcount16(_mm_and_si128(_mm_xor_si128(acc, _mm_srli_epi16(acc, 1)), bump_mask)));
+
+        t = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(acc, 1), left_wall),
+                          _mm_or_si128(_mm_srli_epi16(acc, 1), right_wall));
+        wells = _mm_add_epi16(wells, popcount16(_mm_and_si128(_mm_andnot_si128(acc, t), mask)));
+
+        t = _mm_or_si128(_mm_slli_epi16(row, 1), walls);
+        row_trans = _mm_add_epi16(row_trans, popcount16(_mm_and_si128(_mm_xor_si128(t, _mm_srli_epi16(t, 1)), trans_mask)));
+
+        col_trans = _mm_add_epi16(col_trans, popcount16(_mm_xor_si128(row, prev)));
+        prev = row;
+    }
+
+    col_trans = _mm_add_epi16(col_trans, popcount16(_mm_andnot_si128(prev, mask)));
+
+    accumulate(&lo, &hi, height, w->w[EVAL_HEIGHT]);
+    accumulate(&lo, &hi, holes, w->w[EVAL_HOLES]);
+    accumulate(&lo, &hi, bump, w->w[EVAL_BUMPINESS]);
+    accumulate(&lo, &hi, wells, w->w[EVAL_WELLS]);
+    accumulate(&lo, &hi, row_trans, w->w[EVAL_ROW_TRANSITIONS]);
+    accumulate(&lo, &hi, col_trans, w->w[EVAL_COL_TRANSITIONS]);
+    accumulate(&lo, &hi, _mm_loadu_si128((const __m128i *)block->landing), w->w[EVAL_LANDING]);
+    accumulate(&lo, &hi, _mm_loadu_si128((const __m128i *)block->lines), w->w[EVAL_LINES]);
+
+    _mm_storeu_ps(score, lo);
+    _mm_storeu_ps(score + 4, hi);
+
+    return;
+}
+
+#else
+
+/**
+ * \brief  没有SSE2时逐个评估
+ */
+static void eval_block(const eval_block_t *block, const eval_weights_t *w, float *score)
+{
+    int16_t map[TETRIS_MAP_HEIGHT];
+    uint8_t lane, y;
+
+    for (lane = 0; lane < EVAL_LANES; lane++)
+    {
+        for (y = 0; y < TETRIS_MAP_HEIGHT; y++)
+            map[y] = (int16_t)block->row[y][lane];
+
+        score[lane] = eval_board(map, (uint8_t)block->landing[lane],
+                                 (uint8_t)block->lines[lane], w);
+    }
+
+    return;
+}
+
+#endif
+
+
+/**
+ * \brief  评估多个块
+ *
+ * \param  block
+ * \param  count 块数
+ * \param  w
+ * \param  score count * EVAL_LANES个
+ */
+void eval_blocks(const eval_block_t *block, uint32_t count, const eval_weights_t *w, float *score)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++)
+        eval_block(&block[i], w, score + i * EVAL_LANES);
+
+    return;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,95 @@
+/**
+  ******************************************************************************
+  * @file    eval.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   机器人用的局面评估
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _EVAL_H_
+#define _EVAL_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "Tetris.h"
+
+/* Exported constants --------------------------------------------------------*/
+// 一次并行评估的局面数
+#define     EVAL_LANES          8
+
+/* Exported types ------------------------------------------------------------*/
+// 特征, 分数为各特征与权重的乘积之和, 越大越好
+typedef enum
+{
+    EVAL_HEIGHT,                //!< 各列高度之和
+    EVAL_HOLES,                 //!< 上方有box的空格数
+    EVAL_BUMPINESS,             //!< 相邻两列高度差之和
+    EVAL_WELLS,                 //!< 井的格数: 两边(或墙)都比它高的空格
+    EVAL_ROW_TRANSITIONS,       //!< 每行中空与满交替的次数, 墙算满
+    EVAL_COL_TRANSITIONS,       //!< 每列中空与满交替的次数, 底部算满
+    EVAL_LANDING,               //!< 最后放下的方块的高度, 由调用者给出
+    EVAL_LINES,                 //!< 最后放下的方块消除的行数, 由调用者给出
+    EVAL_FEATURES,
+} eval_feature_t;
+
+typedef struct
+{
+    float w[EVAL_FEATURES];
+} eval_weights_t;
+
+// EVAL_LANES个局面, 按行交错存放, 便于同时处理
+typedef struct
+{
+    uint16_t row[TETRIS_MAP_HEIGHT][EVAL_LANES];
+    uint16_t landing[EVAL_LANES];
+    uint16_t lines[EVAL_LANES];
+} eval_block_t;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+// 默认权重, 来自常用的Dellacherie特征权重
+extern const eval_weights_t eval_default_weights;
+
+/* Exported functions ------------------------------------------------------- */
+// 计算一个局面的全部特征, map的格式与tetris_get_map()相同
+extern void eval_features(const int16_t *map, uint8_t landing, uint8_t lines,
+                          uint16_t *features);
+// 一个局面的分数
+extern float eval_board(const int16_t *map, uint8_t landing, uint8_t lines,
+                        const eval_weights_t *w);
+
+// 把一个局面放入块中的第lane个位置
+extern void eval_block_put(eval_block_t *block, uint8_t lane, const int16_t *map,
+                           uint8_t landing, uint8_t lines);
+// 评估count个块, 即count * EVAL_LANES个局面, 分数依次写入score
+extern void eval_blocks(const eval_block_t *block, uint32_t count,
+                        const eval_weights_t *w, float *score);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
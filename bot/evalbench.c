@@ -0,0 +1,318 @@
+/**
+  ******************************************************************************
+  * @file    evalbench.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   局面评估的速度测试和正确性检查
+  * @note    用随机按键玩出一批局面, 用逐格计算的参照实现检查每个特征,
+  *          检查块评估与单个评估的分数一致, 然后报告每个局面的评估时间.
+  *
+  *          用法: evalbench [-n 局面数] [-s 种子]
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include "Tetris.h"
+#include "eval.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    int16_t map[TETRIS_MAP_HEIGHT];
+    uint8_t landing;
+    uint8_t lines;
+} board_t;
+
+/* Private define ------------------------------------------------------------*/
+#define     ROUNDS              50          // 计时时重复的次数
+
+/* Private macro -------------------------------------------------------------*/
+#define     CELL(map, x, y)     (((map)[y] >> (x)) & 0x0001)
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t seed = 1;
+static volatile float sink;                 // 防止计时的循环被优化掉
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  逐格计算特征, 作为参照
+ */
+static void reference_features(const int16_t *map, uint8_t landing, uint8_t lines, uint16_t *f)
+{
+    int h[TETRIS_MAP_WIDTH], x, y, left, right;
+
+    for (x = 0; x < EVAL_FEATURES; x++)
+        f[x] = 0;
+
+    for (x = 0; x < TETRIS_MAP_WIDTH; x++)
+    {
+        for (y = 0; y < TETRIS_MAP_HEIGHT && !CELL(map, x, y); y++);
+        h[x] = TETRIS_MAP_HEIGHT - y;
+        f[EVAL_HEIGHT] += h[x];
+
+        for (; y < TETRIS_MAP_HEIGHT; y++)
+            f[EVAL_HOLES] += !CELL(map, x, y);
+
+        if (x > 0)
+            f[EVAL_BUMPINESS] += abs(h[x] - h[x - 1]);
+    }
+
+    for (x = 0; x < TETRIS_MAP_WIDTH; x++)
+    {
+        left = (x == 0) ? TETRIS_MAP_HEIGHT : h[x - 1];
+        right = (x == TETRIS_MAP_WIDTH - 1) ? TETRIS_MAP_HEIGHT : h[x + 1];
+        if (left > h[x] && right > h[x])
+            f[EVAL_WELLS] += ((left < right) ? left : right) - h[x];
+    }
+
+    for (y = 0; y < TETRIS_MAP_HEIGHT; y++)
+    {
+        for (x = -1; x < TETRIS_MAP_WIDTH; x++)
+        {
+            left = (x < 0) ? 1 : CELL(map, x, y);
+            right = (x + 1 >= TETRIS_MAP_WIDTH) ? 1 : CELL(map, x + 1, y);
+            f[EVAL_ROW_TRANSITIONS] += (left != right);
+        }
+    }
+
+    for (x = 0; x < TETRIS_MAP_WIDTH; x++)
+    {
+        for (y = 0; y <= TETRIS_MAP_HEIGHT; y++)
+        {
+            left = (y == 0) ? 0 : CELL(map, x, y - 1);
+            right = (y == TETRIS_MAP_HEIGHT) ? 1 : CELL(map, x, y);
+            f[EVAL_COL_TRANSITIONS] += (left != right);
+        }
+    }
+
+    f[EVAL_LANDING] = landing;
+    f[EVAL_LINES] = lines;
+
+    return;
+}
+
+
+static float reference_board(const int16_t *map, uint8_t landing, uint8_t lines, const eval_weights_t *w)
+{
+    uint16_t f[EVAL_FEATURES];
+    float score = 0;
+    uint8_t i;
+
+    reference_features(map, landing, lines, f);
+
+    for (i = 0; i < EVAL_FEATURES; i++)
+        score += w->w[i] * f[i];
+
+    return score;
+}
+
+
+static uint8_t random_num(tetris_t *t)
+{
+    (void)t;
+
+    return (uint8_t)(xorshift(&seed) >> 24);
+}
+
+
+static const tetris_ops_t board_ops = { NULL, random_num, NULL, NULL };
+
+
+/**
+ * \brief  用随机按键玩出局面, 每放下一个方块取一个局面, 游戏结束后重开
+ */
+static void make_boards(board_t *board, uint32_t count)
+{
+    tetris_t game;
+    tetris_brick_t curr;
+    uint32_t i, r;
+    uint8_t k;
+
+    tetris_init_r(&game, &board_ops, NULL, 0);
+
+    for (i = 0; i < count; )
+    {
+        r = xorshift(&seed);
+        for (k = 0; k < (r & 0x07); k++)
+            tetris_move_r(&game, (r >> 8) & 0x01 ? dire_left : dire_right);
+        for (k = 0; k < ((r >> 4) & 0x03); k++)
+            tetris_move_r(&game, dire_rotate);
+
+        tetris_get_brick_r(&game, &curr, NULL);
+        while (tetris_move_r(&game, dire_down))
+            tetris_get_brick_r(&game, &curr, NULL);
+
+        if (tetris_is_game_over_r(&game))
+        {
+            tetris_init_r(&game, &board_ops, NULL, 0);
+            continue;
+        }
+
+        tetris_get_map_r(&game, board[i].map);
+        board[i].landing = (uint8_t)(TETRIS_MAP_HEIGHT - curr.y - 2);
+        board[i].lines = (uint8_t)(r >> 12) % 3;
+        i++;
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-n boards] [-s seed]\n", name);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    unsigned long count = 4096;
+    const eval_weights_t *w = &eval_default_weights;
+    uint16_t fa[EVAL_FEATURES], fb[EVAL_FEATURES];
+    eval_block_t *block;
+    board_t *board;
+    float *score, sum;
+    uint64_t start, naive_ns, board_ns, block_ns;
+    uint32_t i, round, blocks;
+    uint8_t k;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            count = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = (uint32_t)strtoul(optarg, NULL, 0) | 1;
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (optind != argc || count == 0)
+        return usage(argv[0]);
+
+    // 块评估按EVAL_LANES个一组
+    count = (count + EVAL_LANES - 1) / EVAL_LANES * EVAL_LANES;
+    blocks = (uint32_t)(count / EVAL_LANES);
+
+    board = malloc(count * sizeof(board[0]));
+    block = malloc(blocks * sizeof(block[0]));
+    score = malloc(count * sizeof(score[0]));
+    if (board == NULL || block == NULL || score == NULL)
+        return 1;
+
+    make_boards(board, (uint32_t)count);
+
+    for (i = 0; i < count; i++)
+        eval_block_put(&block[i / EVAL_LANES], i % EVAL_LANES, board[i].map, board[i].landing, board[i].lines);
+
+    // 正确性
+    eval_blocks(block, blocks, w, score);
+    for (i = 0; i < count; i++)
+    {
+        eval_features(board[i].map, board[i].landing, board[i].lines, fa);
+        reference_features(board[i].map, board[i].landing, board[i].lines, fb);
+        for (k = 0; k < EVAL_FEATURES; k++)
+        {
+            if (fa[k] != fb[k])
+            {
+                fprintf(stderr, "board %lu: feature %u is %u, expected %u\n",
+                        (unsigned long)i, k, fa[k], fb[k]);
+                return 1;
+            }
+        }
+
+        sum = eval_board(board[i].map, board[i].landing, board[i].lines, w);
+        if (fabsf(sum - score[i]) > 1e-3f * (1 + fabsf(sum)))
+        {
+            fprintf(stderr, "board %lu: block score %f, expected %f\n", (unsigned long)i, score[i], sum);
+            return 1;
+        }
+    }
+
+    // 速度
+    sum = 0;
+    start = clock_ns();
+    for (round = 0; round < ROUNDS; round++)
+    {
+        for (i = 0; i < count; i++)
+            sum += reference_board(board[i].map, board[i].landing, board[i].lines, w);
+    }
+    naive_ns = clock_ns() - start;
+
+    start = clock_ns();
+    for (round = 0; round < ROUNDS; round++)
+    {
+        for (i = 0; i < count; i++)
+            sum += eval_board(board[i].map, board[i].landing, board[i].lines, w);
+    }
+    board_ns = clock_ns() - start;
+
+    start = clock_ns();
+    for (round = 0; round < ROUNDS; round++)
+    {
+        eval_blocks(block, blocks, w, score);
+        sum += score[round % count];
+    }
+    block_ns = clock_ns() - start;
+    sink = sum;
+
+    printf("%lu boards, all features match the cell-by-cell reference\n", count);
+    printf("cell by cell: %6.1f ns/board\n", (double)naive_ns / ROUNDS / count);
+    printf("bit rows:     %6.1f ns/board\n", (double)board_ns / ROUNDS / count);
+    printf("blocks of %u:  %6.1f ns/board%s\n", EVAL_LANES, (double)block_ns / ROUNDS / count,
+#ifdef __SSE2__
+           " (SSE2)"
+#else
+           ""
+#endif
+           );
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
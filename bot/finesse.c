@@ -0,0 +1,441 @@
+/**
+  ******************************************************************************
+  * @file    finesse.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   把目标放置转换为最少的按键序列
+  * @note    状态为(x, y, 变形), 左移, 右移, 旋转的代价为1, 下移的代价为0,
+  *          用0-1 BFS求最少代价的路径, 冲突和旋转的检测与引擎相同.
+  *
+  *          刚出生的方块最常用, 它的结果预先在空地图上算好: 表以方块种类,
+  *          目标变形和目标列为键, 保存落下之前的按键. 实际地图上只要这些
+  *          按键都不冲突, 并且直接落下正好停在目标的y上(由各列的高度决定),
+  *          表中的结果就是最少的, 因为地图上的阻挡只会让可走的路更少.
+  *          否则退回到完整的搜索, 例如需要滑入或旋入的放置.
+  *
+  *          finesse_reach()用同样的状态做普通的BFS, 列出所有能停住的位置,
+  *          即下移会冲突的状态, 给optimal.c求人能达到的上限.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "finesse.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define     MAP_WIDTH           TETRIS_MAP_WIDTH
+#define     MAP_HEIGHT          TETRIS_MAP_HEIGHT
+
+// 状态编号: 变形, x, y; 4 * 4点阵的左上角可以在地图左边3列, 上边4行
+#define     X_MIN               (-3)
+#define     X_NUM               16
+#define     Y_MIN               (-4)
+#define     Y_NUM               (MAP_HEIGHT + 4)
+#define     STATES              (4 * X_NUM * Y_NUM)
+#define     QUEUE_SIZE          8192    // 2的整数次方, 大于所有入队的次数
+
+#define     TABLE_KEYS          12      // 表中落下之前的最多按键数
+
+#define     NONE                0xFFFF
+
+/* Private macro -------------------------------------------------------------*/
+#define     STATE(r, x, y)      (((r) * X_NUM + (x) - X_MIN) * Y_NUM + (y) - Y_MIN)
+#define     STATE_R(s)          ((s) / (X_NUM * Y_NUM))
+#define     STATE_X(s)          ((int8_t)((s) / Y_NUM % X_NUM + X_MIN))
+#define     STATE_Y(s)          ((int8_t)((s) % Y_NUM + Y_MIN))
+
+/* Private variables ---------------------------------------------------------*/
+// 出生位置出发, 空地图上的结果, moves为0xFF时没有结果
+static struct
+{
+    uint8_t moves;
+    uint8_t key[TABLE_KEYS];
+} table[TETRIS_BRICK_TYPES][4][X_NUM];
+
+static bool table_ready = false;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  0-1 BFS
+ *
+ * \param  map
+ * \param  curr
+ * \param  rotation 目标的变形(绝对)
+ * \param  x
+ * \param  y
+ * \param  fall     false时不下移, 只在curr的高度上移动到目标的x和变形,
+ *                  path中没有最后的dire_down, 用于建表
+ * \param  path
+ *
+ * \return 找到路径时返回true
+ */
+static bool search(const int16_t *map, const tetris_brick_t *curr,
+                   uint8_t rotation, int8_t x, int8_t y, bool fall, finesse_path_t *path)
+{
+    uint16_t dist[STATES], from[STATES], queue[QUEUE_SIZE];
+    uint8_t key[STATES];
+    uint16_t head = 0, tail = 0, s, t, goal = NONE, i, n;
+    uint8_t type = curr->type, r, k, cost;
+    int8_t sx, sy, tx, ty;
+
+    if (curr->x < X_MIN || curr->x >= X_MIN + X_NUM || curr->y < Y_MIN || curr->y >= MAP_HEIGHT
+        || x < X_MIN || x >= X_MIN + X_NUM || y < Y_MIN || y >= MAP_HEIGHT)
+        return false;
+
+    memset(dist, 0xFF, sizeof(dist));
+    s = STATE(curr->rotation & 0x03, curr->x, curr->y);
+    dist[s] = 0;
+    from[s] = NONE;
+    queue[tail++] = s;
+
+    while (head != tail)
+    {
+        s = queue[head++ & (QUEUE_SIZE - 1)];
+        r = STATE_R(s);
+        sx = STATE_X(s);
+        sy = STATE_Y(s);
+
+        // 出队的代价不减, 第一个出队的目标就是最少的
+        if (sx == x && place_same_shape(type, r, rotation)
+            && (!fall || (sy == y && place_conflict(map, type, r, sx, sy + 1))))
+        {
+            goal = s;
+            break;
+        }
+
+        for (k = dire_left; k <= dire_rotate; k++)
+        {
+            tx = sx;
+            ty = sy;
+            cost = 1;
+
+            switch (k)
+            {
+            case dire_left:
+                tx--;
+                break;
+            case dire_right:
+                tx++;
+                break;
+            case dire_down:
+                if (!fall)
+                    continue;
+                ty++;
+                cost = 0;
+                break;
+            default:
+                break;
+            }
+
+            if (k == dire_rotate)
+            {
+                if (place_rotate_conflict(map, type, r + 1, tx, ty))
+                    continue;
+                t = STATE((r + 1) & 0x03, tx, ty);
+            }
+            else
+            {
+                if (place_conflict(map, type, r, tx, ty))
+                    continue;
+                t = STATE(r, tx, ty);
+            }
+
+            if (dist[t] <= dist[s] + cost)
+                continue;
+
+            dist[t] = dist[s] + cost;
+            from[t] = s;
+            key[t] = k;
+
+            // 代价为0的放在队首, 为1的放在队尾
+            if (cost == 0)
+                queue[--head & (QUEUE_SIZE - 1)] = t;
+            else
+                queue[tail++ & (QUEUE_SIZE - 1)] = t;
+        }
+    }
+
+    if (goal == NONE)
+        return false;
+
+    // 从目标倒推, 再加上落定的dire_down
+    for (n = fall, s = goal; from[s] != NONE; s = from[s])
+        n++;
+    if (n > FINESSE_KEYS_MAX)
+        return false;
+
+    path->count = (uint8_t)n;
+    path->moves = (uint8_t)dist[goal];
+    path->cached = false;
+    if (fall)
+        path->key[n - 1] = dire_down;
+    for (i = n - fall, s = goal; from[s] != NONE; s = from[s])
+        path->key[--i] = key[s];
+
+    return true;
+}
+
+
+/**
+ * \brief  查表, 在map上检查表中的按键, 并且直接落下停在y上
+ */
+static bool lookup(const int16_t *map, const tetris_brick_t *curr,
+                   uint8_t rotation, int8_t x, int8_t y, finesse_path_t *path)
+{
+    tetris_brick_t spawn;
+    uint8_t r, i, n;
+    int8_t px, py;
+
+    tetris_brick_spawn(curr->type, 0, &spawn);
+    if (curr->rotation != spawn.rotation || curr->x != spawn.x || curr->y != spawn.y
+        || x < X_MIN || x >= X_MIN + X_NUM)
+        return false;
+
+    n = table[curr->type][rotation][x - X_MIN].moves;
+    if (n > TABLE_KEYS)
+        return false;
+
+    r = curr->rotation;
+    px = curr->x;
+    py = curr->y;
+
+    for (i = 0; i < n; i++)
+    {
+        path->key[i] = table[curr->type][rotation][x - X_MIN].key[i];
+
+        if (path->key[i] == dire_rotate)
+        {
+            r = (r + 1) & 0x03;
+            if (place_rotate_conflict(map, curr->type, r, px, py))
+                return false;
+        }
+        else
+        {
+            px += (path->key[i] == dire_left) ? -1 : 1;
+            if (place_conflict(map, curr->type, r, px, py))
+                return false;
+        }
+    }
+
+    for (; py < y && !place_conflict(map, curr->type, r, px, py + 1); py++)
+    {
+        if (n >= FINESSE_KEYS_MAX - 1)
+            return false;
+        path->key[n++] = dire_down;
+    }
+
+    if (py != y || !place_conflict(map, curr->type, r, px, py + 1))
+        return false;
+
+    path->key[n++] = dire_down;
+    path->count = n;
+    path->moves = table[curr->type][rotation][x - X_MIN].moves;
+    path->cached = true;
+
+    return true;
+}
+
+
+void finesse_init(void)
+{
+    const int16_t empty[MAP_HEIGHT] = { 0 };
+    finesse_path_t path;
+    tetris_brick_t spawn;
+    uint8_t type, r, i;
+    int8_t x;
+
+    if (table_ready)
+        return;
+
+    place_init();
+
+    for (type = 0; type < TETRIS_BRICK_TYPES; type++)
+    {
+        tetris_brick_spawn(type, 0, &spawn);
+
+        for (r = 0; r < 4; r++)
+        {
+            for (x = X_MIN; x < X_MIN + X_NUM; x++)
+            {
+                table[type][r][x - X_MIN].moves = 0xFF;
+
+                // 空地图上先移动再落下总是最少的, 只在出生的高度上搜索
+                if (!search(empty, &spawn, r, x, spawn.y, false, &path) || path.moves > TABLE_KEYS)
+                    continue;
+
+                for (i = 0; i < path.moves; i++)
+                    table[type][r][x - X_MIN].key[i] = path.key[i];
+                table[type][r][x - X_MIN].moves = path.moves;
+            }
+        }
+    }
+
+    table_ready = true;
+
+    return;
+}
+
+
+/**
+ * \brief  求最少按键
+ *
+ * \param  map    不包括curr的地图
+ * \param  curr   当前方块
+ * \param  target 目标放置, 如place_list()的结果
+ * \param  path
+ *
+ * \return 到不了目标时返回false
+ */
+bool finesse_plan(const int16_t *map, const tetris_brick_t *curr,
+                  const place_t *target, finesse_path_t *path)
+{
+    uint8_t rotation = (curr->rotation + target->rotation) & 0x03;
+
+    if (lookup(map, curr, rotation, target->x, target->y, path))
+        return true;
+
+    return search(map, curr, rotation, target->x, target->y, true, path);
+}
+
+
+/**
+ * \brief  列出能停住的所有位置
+ *
+ * \param  map   不包括curr的地图
+ * \param  curr  当前方块
+ * \param  place 至少FINESSE_REACH_MAX个, rotation为相对curr的旋转次数
+ *
+ * \return 放置数
+ */
+uint16_t finesse_reach(const int16_t *map, const tetris_brick_t *curr, place_t *place)
+{
+    uint16_t queue[STATES];
+    bool seen[STATES], listed[STATES];
+    uint16_t head = 0, tail = 0, n = 0, s, t;
+    uint8_t type = curr->type, r, r0, k;
+    int8_t sx, sy, tx, ty, top;
+
+    if (curr->x < X_MIN || curr->x >= X_MIN + X_NUM || curr->y < Y_MIN || curr->y >= MAP_HEIGHT)
+        return 0;
+
+    memset(seen, 0, sizeof(seen));
+    memset(listed, 0, sizeof(listed));
+
+    // 最高的有box的行之上都是空的, 4 * 4点阵整个在它上面时只有墙挡着,
+    // 能到达这一层所有不冲突的位置, 从这些位置开始, 不用逐行搜索空行
+    for (top = 0; top < MAP_HEIGHT && map[top] == 0; top++);
+
+    if (curr->y < top - 4)
+    {
+        for (r = 0; r < 4; r++)
+        {
+            for (tx = X_MIN; tx < X_MIN + X_NUM; tx++)
+            {
+                if (place_conflict(map, type, r, tx, top - 4))
+                    continue;
+                t = STATE(r, tx, top - 4);
+                seen[t] = true;
+                queue[tail++] = t;
+            }
+        }
+    }
+    else
+    {
+        s = STATE(curr->rotation & 0x03, curr->x, curr->y);
+        seen[s] = true;
+        queue[tail++] = s;
+    }
+
+    while (head != tail)
+    {
+        s = queue[head++];
+        r = STATE_R(s);
+        sx = STATE_X(s);
+        sy = STATE_Y(s);
+
+        // 下移冲突时可以停在这里; 点阵相同的变形记在编号最小的变形上
+        if (place_conflict(map, type, r, sx, sy + 1))
+        {
+            for (r0 = 0; !place_same_shape(type, r0, r); r0++);
+            t = STATE(r0, sx, sy);
+            if (!listed[t])
+            {
+                listed[t] = true;
+                place[n].rotation = (r - curr->rotation) & 0x03;
+                place[n].x = sx;
+                place[n].y = sy;
+                n++;
+            }
+        }
+
+        for (k = dire_left; k <= dire_rotate; k++)
+        {
+            tx = sx + (k == dire_left ? -1 : (k == dire_right ? 1 : 0));
+            ty = sy + (k == dire_down);
+
+            if (k == dire_rotate)
+            {
+                if (place_rotate_conflict(map, type, r + 1, tx, ty))
+                    continue;
+                t = STATE((r + 1) & 0x03, tx, ty);
+            }
+            else
+            {
+                if (place_conflict(map, type, r, tx, ty))
+                    continue;
+                t = STATE(r, tx, ty);
+            }
+
+            if (!seen[t])
+            {
+                seen[t] = true;
+                queue[tail++] = t;
+            }
+        }
+    }
+
+    return n;
+}
+
+
+void finesse_apply(tetris_t *t, const finesse_path_t *path)
+{
+    uint8_t i;
+
+    for (i = 0; i < path->count; i++)
+        tetris_move_r(t, (dire_t)path->key[i]);
+
+    return;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file    finesse.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   把目标放置转换为最少的按键序列
+  * @note    按键就是tetris_move()的四个方向. 方块每下移一格都要一次dire_down,
+  *          最后再一次dire_down落定, 所以下移的次数只由起点和目标的y决定;
+  *          "最少"指左移, 右移和旋转的次数最少.
+  *          不考虑执行过程中的自动下落.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _FINESSE_H_
+#define _FINESSE_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Tetris.h"
+#include "place.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define     FINESSE_KEYS_MAX    64
+#define     FINESSE_REACH_MAX   (4 * 16 * (TETRIS_MAP_HEIGHT + 4))  // finesse_reach()最多的放置数
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+    uint8_t count;                      //!< 按键数, 包括最后落定的dire_down
+    uint8_t moves;                      //!< 其中左移, 右移和旋转的次数
+    bool cached;                        //!< 来自预先计算的表, 没有搜索
+    uint8_t key[FINESSE_KEYS_MAX];      //!< dire_t
+} finesse_path_t;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+// 建立空地图上从出生位置出发的表, 使用其它函数之前调用, 可以重复调用
+extern void finesse_init(void);
+
+// 求从curr到target的最少按键, target的rotation是相对curr的旋转次数(与place_t相同)
+// map中不包括curr; 到不了target时返回false
+extern bool finesse_plan(const int16_t *map, const tetris_brick_t *curr,
+                         const place_t *target, finesse_path_t *path);
+// 列出curr用任意按键能停住的所有位置, 包括place_list()没有的滑入和旋入;
+// rotation是相对curr的旋转次数, 点阵相同的变形只列一次. place至少FINESSE_REACH_MAX个
+extern uint16_t finesse_reach(const int16_t *map, const tetris_brick_t *curr, place_t *place);
+// 通过tetris_move_r()执行按键序列
+extern void finesse_apply(tetris_t *t, const finesse_path_t *path);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
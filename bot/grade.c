@@ -0,0 +1,263 @@
+/**
+  ******************************************************************************
+  * @file    grade.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   用已知方块序列下的最好结果给记录或机器人打分
+  * @note    grade [-m MB] [-S] -p pieces file.txt    回放记录文件, 取前pieces个
+  *                                                  落下的方块
+  *          grade [-m MB] [-S] -p pieces -s seed     让机器人用引擎的种子玩
+  *
+  *          两种方式都得到前pieces个方块的序列和这些方块落下后的行数(-S时为
+  *          分数), 再由optimal_solve()求出同一序列能得到的最多行数或分数.
+  *          它包括滑入和旋入, 是任何按键记录的上限, 回放的结果不会超过它.
+  *          状态数随方块数增长很快, 通常取十个以内的方块, 一层放不下时
+  *          按-m的内存写入临时文件.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "Tetris.h"
+#include "bot.h"
+#include "place.h"
+#include "optimal.h"
+#include "replay.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define     PIECES_MAX          64
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+
+static unsigned long bot_lines = 0, bot_score = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static void count_lines(tetris_t *t, uint8_t line);
+
+/* Private functions ---------------------------------------------------------*/
+
+static const tetris_ops_t game_ops = { NULL, NULL, NULL, count_lines };
+
+
+static void count_lines(tetris_t *t, uint8_t line)
+{
+    (void)t;
+    bot_lines += line;
+    bot_score += line_score[line <= 4 ? line : 0];
+
+    return;
+}
+
+
+/**
+ * \brief  回放记录, 每1ms检查一次去掉下落方块后的地图, 改变时就是落下了一个方块
+ *
+ * \return 得到的方块数, 出错时为0
+ */
+static uint32_t from_replay(const char *path, bool score, uint32_t count,
+                            uint8_t *queue, uint32_t *value)
+{
+    int16_t map[TETRIS_MAP_HEIGHT], last[TETRIS_MAP_HEIGHT];
+    tetris_brick_t curr, next;
+    uint32_t now, end, n = 0;
+    uint8_t expect;
+
+    if (!replay_load(path))
+        return 0;
+
+    replay_start();
+    end = replay_end();
+
+    tetris_get_map(last);
+    tetris_get_brick(&curr, &next);
+    place_remove(last, &curr);
+    queue[0] = curr.type;
+    expect = next.type;
+
+    for (now = 0; now <= end && n < count && !tetris_is_game_over(); now++)
+    {
+        replay_advance(now);
+        if (tetris_is_game_over())
+            break;
+
+        tetris_get_map(map);
+        tetris_get_brick(&curr, &next);
+        place_remove(map, &curr);
+        if (memcmp(map, last, sizeof(map)) == 0)
+            continue;
+
+        // 同一毫秒中落下了两个方块时无法知道中间的那个
+        if (curr.type != expect)
+        {
+            fprintf(stderr, "%s: two pieces locked within 1 ms at %u ms\n", path, now);
+            return 0;
+        }
+
+        memcpy(last, map, sizeof(last));
+        n++;
+        *value = score ? replay_score() : replay_lines();
+        if (n < count)
+            queue[n] = curr.type;
+        expect = next.type;
+    }
+
+    return n;
+}
+
+
+/**
+ * \brief  机器人按引擎的种子玩
+ *
+ * \return 落下的方块数
+ */
+static uint32_t from_bot(unsigned long seed, bool score, uint32_t count,
+                         uint8_t *queue, uint32_t *value)
+{
+    int16_t map[TETRIS_MAP_HEIGHT];
+    tetris_brick_t curr, next;
+    bot_move_t move;
+    tetris_t game;
+    bot_t bot;
+    uint32_t n;
+
+    if (!bot_init(&bot, 2, 32))
+        return 0;
+
+    tetris_init_r(&game, &game_ops, NULL, (uint32_t)seed);
+
+    for (n = 0; n < count && !tetris_is_game_over_r(&game); n++)
+    {
+        tetris_get_map_r(&game, map);
+        tetris_get_brick_r(&game, &curr, &next);
+        if (!bot_think(&bot, map, &curr, &next, &move))
+            break;
+        queue[n] = curr.type;
+        bot_apply(&game, &move);
+    }
+
+    bot_free(&bot);
+    *value = score ? bot_score : bot_lines;
+
+    return n;
+}
+
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-p pieces 1-%d] [-m memory MB] [-S] score instead of lines\n"
+                    "       file.txt | -s seed\n", name, PIECES_MAX);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    unsigned long count = 10, memory = 1024, seed = 0;
+    const int16_t empty[TETRIS_MAP_HEIGHT] = { 0 };
+    uint8_t queue[PIECES_MAX];
+    uint32_t n, value = 0, best;
+    struct rusage rusage;
+    optimal_t o;
+    bool score = false, use_seed = false;
+    double start, sec;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:m:s:S")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            count = strtoul(optarg, NULL, 0);
+            break;
+        case 'm':
+            memory = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = strtoul(optarg, NULL, 0);
+            use_seed = true;
+            break;
+        case 'S':
+            score = true;
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (optind != argc - (use_seed ? 0 : 1) || count < 1 || count > PIECES_MAX || memory < 1)
+        return usage(argv[0]);
+
+    place_init();
+    n = use_seed ? from_bot(seed, score, (uint32_t)count, queue, &value)
+                 : from_replay(argv[optind], score, (uint32_t)count, queue, &value);
+    if (n == 0)
+        return 1;
+    if (n < count)
+        printf("only %u pieces were locked\n", n);
+
+    optimal_init(&o);
+    o.score = score;
+    o.memory_mb = (uint32_t)memory;
+
+    start = clock_sec();
+    if (!optimal_solve(&o, empty, queue, n, &best))
+    {
+        fprintf(stderr, "out of memory or temporary files\n");
+        return 1;
+    }
+    sec = clock_sec() - start;
+    getrusage(RUSAGE_SELF, &rusage);
+
+    printf("%u pieces, %s %u, greedy %u, optimal %u (%.1f%%)\n", n,
+           use_seed ? "bot" : "replay", value, o.greedy, best, best ? 100.0 * value / best : 100.0);
+    printf("%llu states in %.3f s, %.0f states/s, largest layer %llu\n",
+           (unsigned long long)o.states, sec, o.states / sec, (unsigned long long)o.peak_layer);
+    printf("%llu duplicates, %llu pruned, %llu spilled to disk\n", (unsigned long long)o.duplicates,
+           (unsigned long long)o.pruned, (unsigned long long)o.spilled);
+    printf("state tables %.1f MB allocated, peak RSS %.1f MB\n", o.peak_memory / 1048576.0,
+           rusage.ru_maxrss / 1024.0);
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,220 @@
+/**
+  ******************************************************************************
+  * @file    liveplay.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   让随时可中断的机器人按实时的帧率玩一局
+  * @note    用法: liveplay [-f 每帧毫秒] [-g 每隔几帧下落一格] [-a 每秒动作数]
+  *                   [-T 最长思考毫秒] [-d 最大深度] [-w 束宽] [-x] 期望搜索
+  *                   [-p 方块数] [-s 种子]
+  *
+  *          与Windows前端一样使用引擎的默认实例, 游戏循环每帧调用一次
+  *          anytime_step(). 结束时报告每帧的耗时和错过的帧数, 以及开始执行
+  *          时搜索完成的平均深度.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "Tetris.h"
+#include "anytime.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static unsigned long lines = 0;
+static unsigned long pieces = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static void draw_box(uint8_t x, uint8_t y, uint8_t color)
+{
+    (void)x;
+    (void)y;
+    (void)color;
+
+    return;
+}
+
+
+static uint8_t random_num(void)
+{
+    return (uint8_t)rand();
+}
+
+
+static void next_brick(const void *info)
+{
+    (void)info;
+    pieces++;
+
+    return;
+}
+
+
+static void remove_line(uint8_t line)
+{
+    lines += line;
+
+    return;
+}
+
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-f ms/frame] [-g frames/row] [-a actions/s] [-T think ms]\n"
+                    "       [-d depth 1-%d] [-w beam 1-%d] [-x] expectimax [-p pieces] [-s seed]\n",
+            name, BOT_DEPTH_MAX, BOT_BEAM_MAX);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    unsigned long frame_ms = 50, gravity = 11, rate = 10, think = 100;
+    unsigned long depth = 3, beam = 32, limit = 500, seed = 1;
+    unsigned long frame, missed = 0, actions = 0;
+    bool expectimax = false;
+    int16_t map[TETRIS_MAP_HEIGHT];
+    tetris_brick_t curr, next;
+    uint64_t start, t, cost, cost_max = 0, cost_total = 0;
+    struct timespec ts;
+    anytime_t bot;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "f:g:a:T:d:w:xp:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'f':
+            frame_ms = strtoul(optarg, NULL, 0);
+            break;
+        case 'g':
+            gravity = strtoul(optarg, NULL, 0);
+            break;
+        case 'a':
+            rate = strtoul(optarg, NULL, 0);
+            break;
+        case 'T':
+            think = strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            depth = strtoul(optarg, NULL, 0);
+            break;
+        case 'w':
+            beam = strtoul(optarg, NULL, 0);
+            break;
+        case 'x':
+            expectimax = true;
+            break;
+        case 'p':
+            limit = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (optind != argc || frame_ms == 0 || gravity == 0 || rate == 0 || rate > 1000
+        || think > 10000 || depth < 1 || depth > BOT_DEPTH_MAX || beam < 1 || beam > BOT_BEAM_MAX)
+        return usage(argv[0]);
+
+    if (!anytime_init(&bot, expectimax ? bot_expectimax : bot_beam, (uint8_t)depth, (uint16_t)beam))
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    bot.rate = (uint16_t)rate;
+    bot.think_ms = (uint16_t)think;
+
+    srand((unsigned)seed);
+    tetris_init(&draw_box, &random_num, &next_brick, &remove_line);
+
+    start = clock_ns();
+
+    for (frame = 0; !tetris_is_game_over() && pieces <= limit; frame++)
+    {
+        // 等到这一帧的时间, 已经过了说明上一帧错过了
+        t = start + (uint64_t)frame * frame_ms * 1000000u;
+        if (clock_ns() > t + (uint64_t)frame_ms * 1000000u)
+            missed++;
+        ts.tv_sec = (time_t)(t / 1000000000u);
+        ts.tv_nsec = (long)(t % 1000000000u);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+
+        t = clock_ns();
+
+        if (frame % gravity == gravity - 1)
+            tetris_move(dire_down);
+
+        if (!tetris_is_game_over())
+        {
+            tetris_get_map(map);
+            tetris_get_brick(&curr, &next);
+            bot.bag = tetris_get_bag(&bot.types);
+            actions += anytime_step(&bot, map, &curr, &next, (uint32_t)(frame * frame_ms), tetris_move);
+        }
+
+        cost = clock_ns() - t;
+        cost_total += cost;
+        if (cost > cost_max)
+            cost_max = cost;
+    }
+
+    printf("%lu pieces, %lu lines%s, %lu frames, %lu actions\n", pieces - 1, lines,
+           tetris_is_game_over() ? "" : " (piece limit)", frame, actions);
+    printf("frame work %.1f us average, %.1f us max, %lu frames missed\n",
+           cost_total / 1000.0 / frame, cost_max / 1000.0, missed);
+    printf("%.2f average depth when moving, %u replans, %u blocked\n",
+           bot.decisions ? (double)bot.depth_sum / bot.decisions : 0.0, bot.replans, bot.failures);
+
+    anytime_free(&bot);
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
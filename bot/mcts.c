@@ -0,0 +1,526 @@
+/**
+  ******************************************************************************
+  * @file    mcts.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   蒙特卡洛树搜索的机器人
+  * @note    回报: 模拟中游戏结束为0, 否则为 评估分数 + 消行得分 与根局面的
+  *          评估分数之差经过logistic函数压到(0, 1).
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mcts.h"
+#include "place.h"
+#include "pool.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+struct mcts_node
+{
+    uint32_t visits;                    // 访问次数, 包括进行中的虚拟损失
+    uint64_t sum;                       // 回报之和, 定点数, 1为REWARD_ONE
+    uint32_t child[TETRIS_BRICK_TYPES]; // 各种方块的第一个子节点, 子节点连续存放
+    uint8_t count[TETRIS_BRICK_TYPES];  // 各种方块的子节点数
+    place_t place;                      // 从父节点到这里的放置
+};
+
+// 一个线程的模拟状态
+typedef struct
+{
+    mcts_t *m;
+    tetris_t game;                      // 快照的副本
+    uint32_t rng;
+    uint16_t lines;                     // 本次模拟消除的行数
+    uint32_t path[64];                  // 本次模拟在树中经过的节点
+} worker_t;
+
+// 线程池在两次决定之间保留, 线程数改变时重建
+struct mcts_pool
+{
+    pool_t workers;
+    uint8_t count;                      // 线程数, 包括调用者; 0为还没建立
+    worker_t worker[MCTS_THREADS_MAX];  // worker[0]由调用mcts_think()的线程使用
+};
+
+/* Private define ------------------------------------------------------------*/
+#define     REWARD_ONE          65536.0f
+#define     REWARD_SCALE        30.0f       // 分数差为此值时回报为0.73
+
+#define     CHILD_NONE          0           // 还没展开(节点0是根, 不会是子节点)
+#define     CHILD_BUSY          0xFFFFFFFFu // 另一个线程正在展开
+#define     CHILD_FULL          0xFFFFFFFEu // 节点池已满, 不再展开
+
+#define     PATH_MAX            (sizeof(((worker_t *)0)->path) / sizeof(uint32_t))
+
+/* Private macro -------------------------------------------------------------*/
+#define     LOAD(p)             __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define     ADD(p, v)           __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t worker_random(tetris_t *t);
+static void worker_lines(tetris_t *t, uint8_t line);
+
+/* Private functions ---------------------------------------------------------*/
+
+// 副本的回调函数: 随机数来自线程自己的状态, 统计消行
+static const tetris_ops_t worker_ops = { NULL, worker_random, NULL, worker_lines };
+
+
+static uint8_t worker_random(tetris_t *t)
+{
+    return (uint8_t)(xorshift(&((worker_t *)t->user)->rng) >> 24);
+}
+
+
+static void worker_lines(tetris_t *t, uint8_t line)
+{
+    ((worker_t *)t->user)->lines += line;
+
+    return;
+}
+
+
+/**
+ * \brief  在副本上执行放置
+ */
+static void play(tetris_t *game, const place_t *p)
+{
+    bot_move_t move;
+
+    move.rotation = p->rotation;
+    move.x = p->x;
+    bot_apply(game, &move);
+
+    return;
+}
+
+
+/**
+ * \brief  副本的当前局面: 去掉当前方块的地图和当前方块
+ */
+static void look(const tetris_t *game, int16_t *map, tetris_brick_t *curr)
+{
+    tetris_get_map_r(game, map);
+    tetris_get_brick_r(game, curr, NULL);
+    place_remove(map, curr);
+
+    return;
+}
+
+
+/**
+ * \brief  展开节点中type种方块的子节点
+ *
+ * \return 子节点中的第一个, 不能展开时为CHILD_FULL
+ */
+static uint32_t expand(mcts_t *m, mcts_node_t *node, const tetris_t *game)
+{
+    place_t place[PLACE_MAX];
+    int16_t map[TETRIS_MAP_HEIGHT];
+    tetris_brick_t curr;
+    uint32_t first;
+    uint8_t n, i, k;
+
+    look(game, map, &curr);
+    n = place_list(map, curr.type, curr.rotation, curr.x, curr.y, place);
+
+    // 结束游戏的放置不作为子节点, 都结束游戏时由模拟得到回报0
+    for (i = 0, k = 0; i < n; i++)
+    {
+        if (place[i].y >= 0)
+            place[k++] = place[i];
+    }
+
+    first = ADD(&m->used, k);
+    if (k == 0 || first + k > m->capacity)
+    {
+        __atomic_store_n(&node->child[curr.type], CHILD_FULL, __ATOMIC_RELEASE);
+        return CHILD_FULL;
+    }
+
+    for (i = 0; i < k; i++)
+    {
+        memset(&m->node[first + i], 0, sizeof(m->node[0]));
+        m->node[first + i].place = place[i];
+    }
+
+    node->count[curr.type] = k;
+    __atomic_store_n(&node->child[curr.type], first, __ATOMIC_RELEASE);
+
+    return first;
+}
+
+
+/**
+ * \brief  按UCT选择子节点, 没有访问过的子节点优先
+ */
+static uint32_t select_child(const mcts_t *m, const mcts_node_t *node, uint32_t first, uint8_t count)
+{
+    float best = -1, ucb, log_n;
+    uint32_t visits, pick = first, i;
+
+    log_n = logf((float)LOAD(&node->visits) + 1);
+
+    for (i = first; i < first + count; i++)
+    {
+        visits = LOAD(&m->node[i].visits);
+        if (visits == 0)
+            return i;
+
+        ucb = LOAD(&m->node[i].sum) / REWARD_ONE / visits + m->explore * sqrtf(log_n / visits);
+        if (ucb > best)
+        {
+            best = ucb;
+            pick = i;
+        }
+    }
+
+    return pick;
+}
+
+
+/**
+ * \brief  离开树后的模拟
+ */
+static void rollout(worker_t *w)
+{
+    const eval_weights_t *weights = w->m->weights;
+    place_t place[PLACE_MAX];
+    int16_t map[TETRIS_MAP_HEIGHT], child[TETRIS_MAP_HEIGHT];
+    tetris_brick_t curr;
+    float score, best;
+    uint8_t k, n, i, pick, lines, landing;
+    uint64_t hash = 0;
+
+    for (k = 0; k < w->m->rollout && !tetris_is_game_over_r(&w->game); k++)
+    {
+        look(&w->game, map, &curr);
+        n = place_list(map, curr.type, curr.rotation, curr.x, curr.y, place);
+        if (n == 0)
+            break;
+
+        pick = 0;
+        if (w->m->heuristic)
+        {
+            best = -1e30f;
+            for (i = 0; i < n; i++)
+            {
+                if (place[i].y < 0)
+                    continue;
+                lines = place_drop(map, child, &hash, curr.type, curr.rotation + place[i].rotation,
+                                   place[i].x, place[i].y, &landing);
+                score = eval_board(child, landing, lines, weights);
+                if (score > best)
+                {
+                    best = score;
+                    pick = i;
+                }
+            }
+        }
+        else
+        {
+            // 随机选择, 先避开结束游戏的放置
+            for (i = 0; i < 4; i++)
+            {
+                pick = (uint8_t)(xorshift(&w->rng) % n);
+                if (place[pick].y >= 0)
+                    break;
+            }
+        }
+
+        play(&w->game, &place[pick]);
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  一次模拟: 恢复快照, 沿树选择, 展开, 模拟, 回传回报
+ */
+static void playout(worker_t *w)
+{
+    mcts_t *m = w->m;
+    int16_t map[TETRIS_MAP_HEIGHT];
+    tetris_brick_t curr;
+    mcts_node_t *node = &m->node[0];
+    uint32_t first, pick, depth = 0, i;
+    uint32_t vloss = m->virtual_loss;
+    float score, reward = 0;
+
+    tetris_copy_r(&w->game, m->root, &worker_ops, w);
+    w->lines = 0;
+
+    w->path[depth++] = 0;
+    ADD(&node->visits, vloss);
+
+    while (depth < PATH_MAX && !tetris_is_game_over_r(&w->game))
+    {
+        tetris_get_brick_r(&w->game, &curr, NULL);
+
+        first = LOAD(&node->child[curr.type]);
+        if (first == CHILD_NONE)
+        {
+            if (__atomic_compare_exchange_n(&node->child[curr.type], &first, CHILD_BUSY, false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+                first = expand(m, node, &w->game);
+        }
+
+        // 别的线程正在展开, 或者不能展开, 从这里开始模拟
+        if (first == CHILD_BUSY || first == CHILD_FULL)
+            break;
+
+        pick = select_child(m, node, first, node->count[curr.type]);
+        node = &m->node[pick];
+        w->path[depth++] = pick;
+
+        // 没有访问过的节点, 加入树后开始模拟
+        if (ADD(&node->visits, vloss) == 0)
+        {
+            play(&w->game, &node->place);
+            break;
+        }
+
+        play(&w->game, &node->place);
+    }
+
+    rollout(w);
+
+    if (!tetris_is_game_over_r(&w->game))
+    {
+        tetris_get_map_r(&w->game, map);
+        score = eval_board(map, 0, 0, m->weights) + m->weights->w[EVAL_LINES] * w->lines;
+        reward = 1.0f / (1.0f + expf(-(score - m->base) / REWARD_SCALE));
+    }
+
+    // 回传: 加上回报, 去掉多计的虚拟损失
+    for (i = 0; i < depth; i++)
+    {
+        node = &m->node[w->path[i]];
+        ADD(&node->sum, (uint64_t)(reward * REWARD_ONE));
+        if (vloss != 1)
+            ADD(&node->visits, 1 - vloss);
+    }
+
+    return;
+}
+
+
+static void worker_loop(worker_t *w)
+{
+    while (ADD(&w->m->issued, 1) < w->m->playouts)
+        playout(w);
+
+    return;
+}
+
+
+// 线程池中一个线程的工作
+static void playout_job(void *arg, uint8_t index)
+{
+    mcts_t *m = arg;
+
+    worker_loop(&m->pool->worker[index]);
+
+    return;
+}
+
+
+/**
+ * \brief  按线程数重建线程池, 建不了线程时只用调用者
+ *
+ * \param  m
+ * \param  threads 1 - MCTS_THREADS_MAX
+ */
+static void workers_resize(mcts_t *m, uint8_t threads)
+{
+    mcts_pool_t *pool = m->pool;
+
+    if (pool->count == threads)
+        return;
+
+    if (pool->count > 1)
+        pool_free(&pool->workers);
+
+    pool->count = 1;
+    if (threads > 1 && pool_init(&pool->workers, threads))
+        pool->count = threads;
+
+    return;
+}
+
+
+/**
+ * \brief  初始化
+ *
+ * \param  m
+ * \param  nodes 节点池的大小
+ *
+ * \return
+ */
+bool mcts_init(mcts_t *m, uint32_t nodes)
+{
+    place_init();
+
+    memset(m, 0, sizeof(*m));
+    m->threads = 1;
+    m->playouts = 2000;
+    m->rollout = 8;
+    m->heuristic = true;
+    m->explore = 0.5f;
+    m->virtual_loss = 1;
+    m->weights = &eval_default_weights;
+    m->seed = 1;
+
+    m->capacity = nodes;
+    m->node = malloc((size_t)nodes * sizeof(m->node[0]));
+    m->pool = calloc(1, sizeof(*m->pool));
+
+    if (m->node == NULL || m->pool == NULL)
+    {
+        mcts_free(m);
+        return false;
+    }
+
+    return true;
+}
+
+
+void mcts_free(mcts_t *m)
+{
+    if (m->pool != NULL && m->pool->count > 1)
+        pool_free(&m->pool->workers);
+
+    free(m->pool);
+    free(m->node);
+    m->pool = NULL;
+    m->node = NULL;
+
+    return;
+}
+
+
+/**
+ * \brief  选择放置
+ *
+ * \param  m
+ * \param  t    当前的引擎实例, 作为每次模拟的快照
+ * \param  move 选择的放置, 访问次数最多的子节点
+ *
+ * \retval true  找到不结束游戏的放置
+ *         false 所有放置都会结束游戏, move为第一个放置(如果有)
+ */
+bool mcts_think(mcts_t *m, const tetris_t *t, bot_move_t *move)
+{
+    worker_t *worker = m->pool->worker;
+    int16_t map[TETRIS_MAP_HEIGHT];
+    place_t place[PLACE_MAX];
+    tetris_brick_t curr;
+    mcts_node_t *root;
+    uint32_t first, best = 0, i;
+    uint8_t threads, count, landing;
+    uint64_t hash = 0;
+
+    threads = m->threads;
+    if (threads < 1)
+        threads = 1;
+    if (threads > MCTS_THREADS_MAX)
+        threads = MCTS_THREADS_MAX;
+    if (m->virtual_loss < 1)
+        m->virtual_loss = 1;
+
+    workers_resize(m, threads);
+    threads = m->pool->count;
+
+    look(t, map, &curr);
+
+    root = &m->node[0];
+    memset(root, 0, sizeof(*root));
+    m->used = 1;
+    m->issued = 0;
+    m->root = t;
+    m->base = eval_board(map, 0, 0, m->weights);
+
+    for (i = 0; i < threads; i++)
+    {
+        worker[i].m = m;
+        worker[i].rng = m->seed * 2654435761u + i * 0x9E3779B9u + 1;
+        if (worker[i].rng == 0)
+            worker[i].rng = 1;
+    }
+    m->seed++;
+
+    if (threads > 1)
+        pool_start(&m->pool->workers, playout_job, m);
+    worker_loop(&worker[0]);
+    if (threads > 1)
+        pool_wait(&m->pool->workers);
+
+    m->total_playouts += m->playouts;
+    if (m->used > m->peak_nodes)
+        m->peak_nodes = (m->used < m->capacity) ? m->used : m->capacity;
+
+    first = root->child[curr.type];
+    count = root->count[curr.type];
+
+    if (first == CHILD_NONE || first == CHILD_BUSY || first == CHILD_FULL || count == 0)
+    {
+        // 没有不结束游戏的放置
+        if (place_list(map, curr.type, curr.rotation, curr.x, curr.y, place) == 0)
+            return false;
+        move->rotation = place[0].rotation;
+        move->x = place[0].x;
+        move->y = place[0].y;
+        move->lines = place_drop(map, move->map, &hash, curr.type, curr.rotation + place[0].rotation,
+                                 place[0].x, place[0].y, &landing);
+        return false;
+    }
+
+    for (i = first; i < first + count; i++)
+    {
+        if (m->node[i].visits > m->node[best].visits || best == 0)
+            best = i;
+    }
+
+    move->rotation = m->node[best].place.rotation;
+    move->x = m->node[best].place.x;
+    move->y = m->node[best].place.y;
+    move->lines = place_drop(map, move->map, &hash, curr.type, curr.rotation + move->rotation,
+                             move->x, move->y, &landing);
+
+    return true;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
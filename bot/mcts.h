@@ -0,0 +1,95 @@
+/**
+  ******************************************************************************
+  * @file    mcts.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   蒙特卡洛树搜索的机器人
+  * @note    树的节点是放置, 每个节点按当时出现的方块种类分开子节点,
+  *          所以未知的方块不需要单独的机会节点, 由模拟时引擎产生的方块决定.
+  *          每次模拟从引擎实例的快照开始, 沿树中选择的放置和模拟的放置都由
+  *          tetris_move_r()在快照的副本上执行.
+  *
+  *          多个线程共用一棵树: 下行时访问次数先加上虚拟损失, 使其它线程
+  *          避开这条路径; 访问次数和回报之和用原子操作更新, 不加锁.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _MCTS_H_
+#define _MCTS_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Tetris.h"
+#include "eval.h"
+#include "bot.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define     MCTS_THREADS_MAX    16
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct mcts_node mcts_node_t;
+typedef struct mcts_pool mcts_pool_t;
+
+// 前面的设置可以在两次搜索之间修改, 其它成员只由mcts.c访问
+typedef struct
+{
+    uint8_t threads;                    //!< 线程数, 包括调用mcts_think()的线程
+    uint32_t playouts;                  //!< 每次决定的模拟次数
+    uint8_t rollout;                    //!< 每次模拟离开树后再放置的方块数
+    bool heuristic;                     //!< 模拟时按局面评估选择放置, 否则随机选择
+    float explore;                      //!< UCT的探索系数
+    uint8_t virtual_loss;               //!< 下行时暂时计入的失败次数
+    const eval_weights_t *weights;
+    uint32_t seed;                      //!< 模拟用的随机数种子
+
+    uint64_t total_playouts;            //!< 统计: 模拟次数
+    uint32_t peak_nodes;                //!< 统计: 一次搜索最多用到的节点数
+
+    mcts_node_t *node;                  //!< 节点池, node[0]为根
+    mcts_pool_t *pool;                  //!< 线程池和各线程的模拟状态
+    uint32_t capacity;
+    uint32_t used;
+    uint32_t issued;                    //!< 本次搜索已经领取的模拟次数
+    const tetris_t *root;               //!< 本次搜索的快照
+    float base;                         //!< 根局面的评估分数, 回报以它为中心
+} mcts_t;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+// 初始化, nodes为节点池的大小, 内存不足时返回false
+extern bool mcts_init(mcts_t *m, uint32_t nodes);
+extern void mcts_free(mcts_t *m);
+
+// 为t的当前方块选择放置, t不会被修改, 用bot_apply()执行
+// 所有放置都会结束游戏时返回false
+extern bool mcts_think(mcts_t *m, const tetris_t *t, bot_move_t *move);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,270 @@
+/**
+  ******************************************************************************
+  * @file    mctsplay.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   让蒙特卡洛树搜索的机器人玩若干局, 或者测量多线程的扩展效率
+  * @note    用法: mctsplay [-g 局数] [-n 每步的模拟次数] [-r 模拟的方块数]
+  *                   [-R] 随机模拟 [-c 探索系数] [-v 虚拟损失] [-t 线程数]
+  *                   [-G 每隔几个方块加一行垃圾] [-S 局面数]
+  *
+  *          -S时先用一个线程玩一局, 记下前面若干个局面的快照, 然后用1到-t个
+  *          线程分别搜索这些局面, 报告每秒模拟次数和扩展效率:
+  *          N个线程的速度 / (N * 一个线程的速度).
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Tetris.h"
+#include "mcts.h"
+#include "place.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define     SNAPSHOTS_MAX       1000
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static tetris_t snapshot[SNAPSHOTS_MAX];
+
+/* Private function prototypes -----------------------------------------------*/
+static void count_lines(tetris_t *t, uint8_t line);
+
+/* Private functions ---------------------------------------------------------*/
+
+static const tetris_ops_t game_ops = { NULL, NULL, NULL, count_lines };
+
+
+static void count_lines(tetris_t *t, uint8_t line)
+{
+    *(unsigned long *)t->user += line;
+
+    return;
+}
+
+
+/**
+ * \brief  玩一局
+ *
+ * \param  m
+ * \param  seed
+ * \param  garbage 每隔几个方块加一行垃圾, 0不加
+ * \param  limit   最多放置的方块数
+ * \param  keep    记下前面这么多个局面的快照
+ * \param  lines   消除的行数
+ *
+ * \return 放置的方块数
+ */
+static unsigned long play_game(mcts_t *m, uint32_t seed, unsigned long garbage,
+                               unsigned long limit, unsigned long keep, unsigned long *lines)
+{
+    tetris_t game;
+    bot_move_t move;
+    unsigned long pieces;
+    uint32_t hole = 1;
+
+    *lines = 0;
+    tetris_init_r(&game, &game_ops, lines, seed);
+
+    for (pieces = 0; pieces < limit && !tetris_is_game_over_r(&game); pieces++)
+    {
+        if (pieces < keep)
+            tetris_copy_r(&snapshot[pieces], &game, NULL, NULL);
+
+        mcts_think(m, &game, &move);
+        bot_apply(&game, &move);
+
+        if (garbage > 0 && pieces % garbage == garbage - 1)
+        {
+            hole ^= hole << 13;
+            hole ^= hole >> 17;
+            hole ^= hole << 5;
+            tetris_add_garbage_r(&game, 1, (uint8_t)(hole % TETRIS_MAP_WIDTH));
+        }
+    }
+
+    return pieces;
+}
+
+
+/**
+ * \brief  用1到threads个线程搜索记下的快照
+ */
+static void scaling(mcts_t *m, unsigned long threads, unsigned long count)
+{
+    bot_move_t move;
+    unsigned long n, i;
+    double start, rate, base = 0;
+
+    printf("threads  playouts/s  speedup  efficiency\n");
+
+    for (n = 1; n <= threads; n++)
+    {
+        m->threads = (uint8_t)n;
+        m->seed = 1;
+        start = clock_sec();
+        for (i = 0; i < count; i++)
+            mcts_think(m, &snapshot[i], &move);
+        rate = (double)m->playouts * count / (clock_sec() - start);
+
+        if (n == 1)
+            base = rate;
+        printf("%7lu  %10.0f  %7.2f  %9.1f%%\n", n, rate, rate / base, 100.0 * rate / (n * base));
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-g games] [-p pieces] [-s seed] [-n playouts] [-r rollout pieces]\n"
+                    "       [-R] random rollouts [-c explore] [-v virtual loss] [-t threads 1-%d]\n"
+                    "       [-G pieces per garbage row] [-S snapshots 1-%d]\n",
+            name, MCTS_THREADS_MAX, SNAPSHOTS_MAX);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    unsigned long games = 10, limit = 5000, seed = 1, threads = 1, garbage = 0, snapshots = 0;
+    unsigned long playouts = 2000, length = 8, vloss = 1;
+    unsigned long g, pieces, lines, total_pieces = 0, total_lines = 0;
+    double explore = 0.5, start, think;
+    bool heuristic = true;
+    mcts_t mcts;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "g:p:s:n:r:Rc:v:t:G:S:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'g':
+            games = strtoul(optarg, NULL, 0);
+            break;
+        case 'p':
+            limit = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = strtoul(optarg, NULL, 0);
+            break;
+        case 'n':
+            playouts = strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            length = strtoul(optarg, NULL, 0);
+            break;
+        case 'R':
+            heuristic = false;
+            break;
+        case 'c':
+            explore = strtod(optarg, NULL);
+            break;
+        case 'v':
+            vloss = strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            threads = strtoul(optarg, NULL, 0);
+            break;
+        case 'G':
+            garbage = strtoul(optarg, NULL, 0);
+            break;
+        case 'S':
+            snapshots = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (optind != argc || games == 0 || playouts == 0 || length > 255 || vloss < 1 || vloss > 255
+        || threads < 1 || threads > MCTS_THREADS_MAX || snapshots > SNAPSHOTS_MAX)
+        return usage(argv[0]);
+
+    // 每次模拟最多展开一层, 节点数不超过 模拟次数 * 每层的放置数
+    if (!mcts_init(&mcts, (uint32_t)playouts * PLACE_MAX + 1))
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    mcts.playouts = (uint32_t)playouts;
+    mcts.rollout = (uint8_t)length;
+    mcts.heuristic = heuristic;
+    mcts.explore = (float)explore;
+    mcts.virtual_loss = (uint8_t)vloss;
+
+    if (snapshots > 0)
+    {
+        pieces = play_game(&mcts, (uint32_t)seed, garbage, snapshots, snapshots, &lines);
+        printf("%lu positions, %lu playouts each, %s rollouts of %lu pieces, virtual loss %lu\n",
+               pieces, playouts, heuristic ? "heuristic" : "random", length, vloss);
+        scaling(&mcts, threads, pieces);
+        mcts_free(&mcts);
+        return 0;
+    }
+
+    mcts.threads = (uint8_t)threads;
+    start = clock_sec();
+
+    for (g = 0; g < games; g++)
+    {
+        pieces = play_game(&mcts, (uint32_t)(seed + g), garbage, limit, 0, &lines);
+        printf("game %lu: %lu pieces, %lu lines%s\n", g, pieces, lines,
+               pieces < limit ? "" : " (piece limit)");
+        total_pieces += pieces;
+        total_lines += lines;
+    }
+
+    think = clock_sec() - start;
+    printf("mcts %lu playouts, %s rollouts of %lu pieces, %lu thread(s): %.1f lines/game, %.1f pieces/game\n",
+           playouts, heuristic ? "heuristic" : "random", length, threads,
+           (double)total_lines / games, (double)total_pieces / games);
+    printf("%.0f playouts/s, %.3f ms/piece, %u nodes at most\n",
+           mcts.total_playouts / think, think * 1000 / total_pieces, mcts.peak_nodes);
+
+    mcts_free(&mcts);
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,565 @@
+/**
+  ******************************************************************************
+  * @file    optimal.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   已知全部方块序列时可以得到的最多行数或分数
+  * @note    按序列中的位置一层一层地展开: 第d层为放完d个方块后所有可能的
+  *          (地图, 已得行数或分数). 每层用地图的散列值去重, 地图相同时只
+  *          保留得分高的(它不比另一个差). 一个状态之后最多还能消
+  *          (box数 + 4 * 剩下的方块数) / 10行, 加上已得的仍不超过已知的
+  *          最好结果时剪掉. 已知的最好结果开始时来自贪心放置, 展开中游戏
+  *          结束的状态也会更新它. 每个方块的放置由finesse_reach()列出,
+  *          包括滑入和旋入, 所以结果不低于任何按键记录.
+  *
+  *          状态表从TABLE_SLOTS_MIN个位置开始, 满了就加倍, 两个表最多各用
+  *          -m的一半. 一层的状态表放不下时, 把表中的状态和之后的子状态按散列值分到
+  *          SPILL_BUCKETS个临时文件中, 地图相同的状态总在同一个文件里.
+  *          下一层逐个文件读入表中去重, 然后展开. 一个文件仍然放不下时
+  *          分几次处理, 只是少去一些重.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "optimal.h"
+#include "place.h"
+#include "finesse.h"
+#include "eval.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    int16_t map[TETRIS_MAP_HEIGHT];
+    uint32_t value;                     // 已得行数或分数
+} state_t;
+
+// 以地图去重的状态表, hash为0的位置是空的
+typedef struct
+{
+    state_t *state;
+    uint64_t *hash;
+    uint32_t *used;                     // 用过的位置, 遍历和清空时不用扫描整个表
+    uint32_t mask;
+    uint32_t count;
+    uint32_t limit;                     // 超过时加倍, 已到slots_max时算放不下
+    uint32_t slots_max;                 // -m的一半内存能放下的位置数
+} table_t;
+
+// 一层状态: 在表中, 或者分在临时文件中
+typedef struct
+{
+    table_t table;
+    FILE *bucket[64];
+    bool spilled;
+} layer_t;
+
+/* Private define ------------------------------------------------------------*/
+#define     MAP_HEIGHT          TETRIS_MAP_HEIGHT
+#define     MAP_WIDTH           TETRIS_MAP_WIDTH
+#define     ROW_FULL            ((1 << MAP_WIDTH) - 1)
+
+#define     SPILL_BUCKETS       64
+#define     TABLE_SLOTS_MIN     1024    // 表从这么大开始, 放不下时加倍
+
+/* Private macro -------------------------------------------------------------*/
+#define     BUCKET(h)           ((uint32_t)((h) >> 58) % SPILL_BUCKETS)
+
+/* Private variables ---------------------------------------------------------*/
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static bool table_alloc(table_t *t, uint32_t slots)
+{
+    t->state = malloc((size_t)slots * sizeof(t->state[0]));
+    t->hash = calloc(slots, sizeof(t->hash[0]));
+    t->mask = slots - 1;
+    t->count = 0;
+    t->limit = slots / 4 * 3;
+    t->used = malloc((size_t)t->limit * sizeof(t->used[0]));
+
+    return t->state != NULL && t->hash != NULL && t->used != NULL;
+}
+
+
+static void table_free(table_t *t)
+{
+    free(t->state);
+    free(t->hash);
+    free(t->used);
+
+    return;
+}
+
+
+/**
+ * \brief  建立最小的表, 记下bytes能放下的最大位置数
+ */
+static bool table_init(table_t *t, size_t bytes)
+{
+    uint32_t slots = TABLE_SLOTS_MIN;
+
+    while ((size_t)slots * 2 * (sizeof(state_t) + sizeof(uint64_t)) <= bytes && slots < 0x80000000u)
+        slots *= 2;
+
+    t->slots_max = slots;
+
+    return table_alloc(t, TABLE_SLOTS_MIN);
+}
+
+
+static size_t table_bytes(const table_t *t)
+{
+    return ((size_t)t->mask + 1) * (sizeof(state_t) + sizeof(uint64_t))
+           + (size_t)t->limit * sizeof(uint32_t);
+}
+
+
+/**
+ * \brief  表的大小加倍
+ *
+ * \return 已到slots_max或内存不足时返回false, 原来的表不变
+ */
+static bool table_grow(table_t *t)
+{
+    table_t g;
+    uint32_t i, j, k;
+
+    if (t->mask + 1 >= t->slots_max)
+        return false;
+
+    if (!table_alloc(&g, (t->mask + 1) * 2))
+    {
+        table_free(&g);
+        return false;
+    }
+    g.slots_max = t->slots_max;
+
+    for (i = 0; i < t->count; i++)
+    {
+        k = t->used[i];
+        for (j = (uint32_t)(t->hash[k] >> 1) & g.mask; g.hash[j] != 0; j = (j + 1) & g.mask);
+        g.hash[j] = t->hash[k];
+        g.state[j] = t->state[k];
+        g.used[g.count++] = j;
+    }
+
+    table_free(t);
+    *t = g;
+
+    return true;
+}
+
+
+static void table_clear(table_t *t)
+{
+    uint32_t i;
+
+    for (i = 0; i < t->count; i++)
+        t->hash[t->used[i]] = 0;
+    t->count = 0;
+
+    return;
+}
+
+
+/**
+ * \brief  加入一个状态, 地图相同时保留得分高的
+ *
+ * \retval true  加入或合并
+ *         false 表已满
+ */
+static bool table_put(optimal_t *o, table_t *t, uint64_t hash, const state_t *s)
+{
+    // 位置不用最低位, 临时文件中的hash已经置了最低位
+    uint32_t i = (uint32_t)(hash >> 1) & t->mask;
+
+    hash |= 1;
+
+    for (; t->hash[i] != 0; i = (i + 1) & t->mask)
+    {
+        if (t->hash[i] == hash && memcmp(t->state[i].map, s->map, sizeof(s->map)) == 0)
+        {
+            o->duplicates++;
+            if (s->value > t->state[i].value)
+                t->state[i].value = s->value;
+            return true;
+        }
+    }
+
+    if (t->count >= t->limit)
+    {
+        if (!table_grow(t))
+            return false;
+        for (i = (uint32_t)(hash >> 1) & t->mask; t->hash[i] != 0; i = (i + 1) & t->mask);
+    }
+
+    t->hash[i] = hash;
+    t->state[i] = *s;
+    t->used[t->count++] = i;
+
+    return true;
+}
+
+
+static bool spill(optimal_t *o, layer_t *l, uint64_t hash, const state_t *s)
+{
+    o->spilled++;
+
+    return fwrite(&hash, sizeof(hash), 1, l->bucket[BUCKET(hash)]) == 1
+           && fwrite(s, sizeof(*s), 1, l->bucket[BUCKET(hash)]) == 1;
+}
+
+
+/**
+ * \brief  把表中的状态都写入临时文件, 之后这一层都写入临时文件
+ */
+static bool spill_table(optimal_t *o, layer_t *l)
+{
+    uint32_t i, b;
+
+    for (b = 0; b < SPILL_BUCKETS; b++)
+    {
+        if (l->bucket[b] == NULL && (l->bucket[b] = tmpfile()) == NULL)
+            return false;
+    }
+
+    for (i = 0; i < l->table.count; i++)
+    {
+        uint32_t k = l->table.used[i];
+
+        if (!spill(o, l, l->table.hash[k], &l->table.state[k]))
+            return false;
+    }
+
+    table_clear(&l->table);
+    l->spilled = true;
+
+    return true;
+}
+
+
+/**
+ * \brief  加入下一层
+ */
+static bool add(optimal_t *o, layer_t *next, const state_t *s)
+{
+    uint64_t hash = place_hash(s->map);
+
+    if (!next->spilled)
+    {
+        if (table_put(o, &next->table, hash, s))
+            return true;
+        if (!spill_table(o, next))
+            return false;
+    }
+
+    return spill(o, next, hash, s);
+}
+
+
+static uint32_t gain(const optimal_t *o, uint8_t lines)
+{
+    return o->score ? line_score[lines] : lines;
+}
+
+
+/**
+ * \brief  之后最多还能得到的行数或分数
+ * \note   remain个方块共有4 * remain个box, 消掉的每一行都要先填满它的空格,
+ *         空行要10个. 从空格最少的行开始填, 能填满的行数就是上限.
+ *         分数按尽量消4行计算, 每次消行越多每行的分数越高.
+ */
+static uint32_t upper(const optimal_t *o, const int16_t *map, uint32_t remain)
+{
+    uint8_t empty[MAP_WIDTH + 1] = { 0 };
+    uint32_t cells = 4 * remain, lines = 0, n;
+    uint8_t y, k;
+
+    for (y = 0; y < MAP_HEIGHT; y++)
+        empty[MAP_WIDTH - __builtin_popcount(map[y] & ROW_FULL)]++;
+
+    for (k = 1; k <= MAP_WIDTH; k++)
+    {
+        n = (k == MAP_WIDTH) ? cells / k : empty[k];
+        if (n * k > cells)
+            n = cells / k;
+        lines += n;
+        cells -= n * k;
+    }
+
+    if (!o->score)
+        return lines;
+
+    return lines / 4 * line_score[4] + line_score[lines % 4];
+}
+
+
+/**
+ * \brief  展开一个状态, 放置第d个方块
+ */
+static bool expand(optimal_t *o, const state_t *s, const uint8_t *queue, uint32_t d,
+                   uint32_t count, layer_t *next, uint32_t *best)
+{
+    place_t place[FINESSE_REACH_MAX];
+    tetris_brick_t spawn;
+    state_t child;
+    uint64_t hash = 0;
+    uint16_t n, i;
+    uint8_t lines, landing;
+
+    // 在这里结束游戏也得到了已有的结果
+    if (s->value > *best)
+        *best = s->value;
+
+    // 加入这一层之后最好结果可能已经提高了
+    if (s->value + upper(o, s->map, count - d) <= *best)
+    {
+        o->pruned++;
+        return true;
+    }
+
+    o->states++;
+
+    // 包括滑入和旋入, 结果是人用任意按键能达到的上限
+    tetris_brick_spawn(queue[d], 0, &spawn);
+    n = finesse_reach(s->map, &spawn, place);
+
+    for (i = 0; i < n; i++)
+    {
+        if (place[i].y < 0)
+            continue;
+
+        lines = place_drop(s->map, child.map, &hash, queue[d], spawn.rotation + place[i].rotation,
+                           place[i].x, place[i].y, &landing);
+        child.value = s->value + gain(o, lines);
+
+        if (child.value > *best)
+            *best = child.value;
+
+        if (d + 1 == count)
+            continue;
+
+        if (child.value + upper(o, child.map, count - d - 1) <= *best)
+        {
+            o->pruned++;
+            continue;
+        }
+
+        if (!add(o, next, &child))
+            return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * \brief  展开表中的所有状态, 然后清空表
+ */
+static bool expand_table(optimal_t *o, table_t *t, const uint8_t *queue, uint32_t d,
+                         uint32_t count, layer_t *next, uint32_t *best)
+{
+    uint32_t i;
+    bool ok = true;
+
+    for (i = 0; i < t->count && ok; i++)
+        ok = expand(o, &t->state[t->used[i]], queue, d, count, next, best);
+
+    table_clear(t);
+
+    return ok;
+}
+
+
+/**
+ * \brief  贪心放置, 结果作为开始时的下限
+ */
+static uint32_t greedy(const optimal_t *o, const int16_t *map, const uint8_t *queue, uint32_t count)
+{
+    int16_t board[MAP_HEIGHT], child[MAP_HEIGHT], pick[MAP_HEIGHT];
+    place_t place[PLACE_MAX];
+    tetris_brick_t spawn;
+    uint64_t hash = 0;
+    uint32_t d, value = 0;
+    uint8_t n, i, lines, landing, pick_lines;
+    float score, top;
+
+    memcpy(board, map, sizeof(board));
+
+    for (d = 0; d < count; d++)
+    {
+        tetris_brick_spawn(queue[d], 0, &spawn);
+        n = place_list(board, queue[d], 0, spawn.x, spawn.y, place);
+        top = -1e30f;
+        pick_lines = 0;
+
+        for (i = 0; i < n; i++)
+        {
+            if (place[i].y < 0)
+                continue;
+            lines = place_drop(board, child, &hash, queue[d], place[i].rotation,
+                               place[i].x, place[i].y, &landing);
+            score = eval_board(child, landing, lines, &eval_default_weights);
+            if (score > top)
+            {
+                top = score;
+                pick_lines = lines;
+                memcpy(pick, child, sizeof(pick));
+            }
+        }
+
+        if (top == -1e30f)
+            break;
+
+        memcpy(board, pick, sizeof(board));
+        value += gain(o, pick_lines);
+    }
+
+    return value;
+}
+
+
+void optimal_init(optimal_t *o)
+{
+    memset(o, 0, sizeof(*o));
+    o->memory_mb = 1024;
+
+    return;
+}
+
+
+/**
+ * \brief  求解
+ *
+ * \param  o
+ * \param  map   开始时的地图
+ * \param  queue 方块序列
+ * \param  count 方块数
+ * \param  best  最多的行数或分数
+ *
+ * \return 内存或临时文件出错时返回false
+ */
+bool optimal_solve(optimal_t *o, const int16_t *map, const uint8_t *queue,
+                   uint32_t count, uint32_t *best)
+{
+    layer_t layer[2];
+    layer_t *cur = &layer[0], *next = &layer[1], *swap;
+    size_t bytes = (size_t)o->memory_mb << 20;
+    uint64_t hash;
+    state_t s;
+    uint32_t d, b, layer_size;
+    bool ok = true;
+
+    place_init();
+    memset(layer, 0, sizeof(layer));
+
+    if (!table_init(&layer[0].table, bytes / 2) || !table_init(&layer[1].table, bytes / 2))
+    {
+        table_free(&layer[0].table);
+        table_free(&layer[1].table);
+        return false;
+    }
+
+    o->greedy = greedy(o, map, queue, count);
+    *best = o->greedy;
+
+    memcpy(s.map, map, sizeof(s.map));
+    s.value = 0;
+    table_put(o, &cur->table, place_hash(s.map), &s);
+
+    for (d = 0; d < count && ok; d++)
+    {
+        layer_size = 0;
+
+        if (!cur->spilled)
+        {
+            layer_size = cur->table.count;
+            ok = expand_table(o, &cur->table, queue, d, count, next, best);
+        }
+        else
+        {
+            // 逐个文件读入表中去重后展开, 表满时先展开已读入的
+            for (b = 0; b < SPILL_BUCKETS && ok; b++)
+            {
+                rewind(cur->bucket[b]);
+
+                for (;;)
+                {
+                    bool more = fread(&hash, sizeof(hash), 1, cur->bucket[b]) == 1
+                                && fread(&s, sizeof(s), 1, cur->bucket[b]) == 1;
+
+                    if (more && table_put(o, &cur->table, hash, &s))
+                        continue;
+
+                    layer_size += cur->table.count;
+                    ok = expand_table(o, &cur->table, queue, d, count, next, best);
+
+                    if (!more || !ok)
+                        break;
+                    table_put(o, &cur->table, hash, &s);
+                }
+
+                // 清空文件, 留给再下一层使用
+                ok = ok && ftruncate(fileno(cur->bucket[b]), 0) == 0;
+                rewind(cur->bucket[b]);
+            }
+            cur->spilled = false;
+        }
+
+        if (layer_size > o->peak_layer)
+            o->peak_layer = layer_size;
+        if (table_bytes(&layer[0].table) + table_bytes(&layer[1].table) > o->peak_memory)
+            o->peak_memory = table_bytes(&layer[0].table) + table_bytes(&layer[1].table);
+
+        swap = cur;
+        cur = next;
+        next = swap;
+    }
+
+    for (d = 0; d < 2; d++)
+    {
+        table_free(&layer[d].table);
+        for (b = 0; b < SPILL_BUCKETS; b++)
+        {
+            if (layer[d].bucket[b] != NULL)
+                fclose(layer[d].bucket[b]);
+        }
+    }
+
+    return ok;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,74 @@
+/**
+  ******************************************************************************
+  * @file    optimal.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   已知全部方块序列时可以得到的最多行数或分数
+  * @note    放置包括滑入和旋入等用任意按键能停住的位置, 不只是机器人用的
+  *          place_list()的放置, 所以结果是人和机器人的记录共同的上限.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _OPTIMAL_H_
+#define _OPTIMAL_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "Tetris.h"
+
+/* Exported types ------------------------------------------------------------*/
+// 前面的设置在optimal_solve()之前修改, 后面为统计
+typedef struct
+{
+    bool score;                         //!< 以分数(消1至4行为10, 25, 45, 80)为目标, 否则以行数
+    uint32_t memory_mb;                 //!< 两层状态表最多共用的内存, 放不下时下一层写入临时文件
+
+    uint64_t states;                    //!< 展开的状态数
+    uint64_t duplicates;                //!< 地图相同被合并的状态数
+    uint64_t pruned;                    //!< 上限不超过已知最好结果而剪掉的状态数
+    uint64_t spilled;                   //!< 写入临时文件的状态数
+    uint64_t peak_layer;                //!< 最多的一层状态数(合并后)
+    size_t peak_memory;                 //!< 两个状态表最多分配的内存(字节)
+    uint32_t greedy;                    //!< 贪心放置得到的结果, 作为开始时的下限
+} optimal_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+extern void optimal_init(optimal_t *o);
+
+// map为开始时的地图(不包括正在下落的方块), queue为全部方块序列
+// 返回可以得到的最多行数或分数; 内存或临时文件出错时返回false
+extern bool optimal_solve(optimal_t *o, const int16_t *map, const uint8_t *queue,
+                          uint32_t count, uint32_t *best);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,251 @@
+/**
+  ******************************************************************************
+  * @file    pcbench.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   全消求解的测试集: 报告求解率和每次求解的时间
+  * @note    测试集为空地图和用7-bag(或-u均匀随机)产生的方块序列, 种子固定.
+  *          默认求4行全消, 需要10个方块; -H 2时为2行全消, 需要5个方块,
+  *          -H 0时从低到高自动尝试. 找到的解交给引擎执行: 引擎的随机数回调
+  *          按序列返回方块, 用bot_apply()放置, 最后检查地图为空.
+  *
+  *          用法: pcbench [-n 求解次数] [-q 序列长度] [-H 行数] [-t 线程数]
+  *                        [-s 种子] [-u]
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Tetris.h"
+#include "bot.h"
+#include "pclear.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+// 引擎按序列产生方块
+typedef struct
+{
+    const uint8_t *queue;
+    uint8_t count;
+    uint8_t next;
+} feed_t;
+
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t feed_random(tetris_t *t);
+
+/* Private functions ---------------------------------------------------------*/
+
+static const tetris_ops_t feed_ops = { NULL, feed_random, NULL, NULL };
+
+
+static uint8_t feed_random(tetris_t *t)
+{
+    feed_t *f = t->user;
+
+    return (f->next < f->count) ? f->queue[f->next++] : 0;
+}
+
+
+/**
+ * \brief  产生方块序列
+ */
+static void make_queue(uint32_t *rng, bool bag, uint8_t *queue, uint8_t count)
+{
+    uint8_t pool = 0, i, n, type;
+
+    for (i = 0; i < count; i++)
+    {
+        if (!bag)
+        {
+            queue[i] = (uint8_t)(xorshift(rng) % TETRIS_BRICK_TYPES);
+            continue;
+        }
+
+        if (pool == 0)
+            pool = 0x7F;
+        n = (uint8_t)(xorshift(rng) % __builtin_popcount(pool));
+        for (type = 0; !((pool >> type) & 0x01) || n-- > 0; type++);
+        pool &= ~(0x01 << type);
+        queue[i] = type;
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  让引擎执行解, 检查地图变空
+ */
+static bool verify(const uint8_t *queue, uint8_t count, const pc_step_t *step, uint8_t used)
+{
+    int16_t map[TETRIS_MAP_HEIGHT];
+    tetris_brick_t curr;
+    bot_move_t move;
+    tetris_t game;
+    feed_t feed = { queue, count, 0 };
+    uint8_t i, y;
+
+    tetris_init_r(&game, &feed_ops, &feed, 1);
+
+    for (i = 0; i < used; i++)
+    {
+        tetris_get_brick_r(&game, &curr, NULL);
+        if (curr.type != step[i].type)
+            return false;
+
+        move.rotation = step[i].place.rotation;
+        move.x = step[i].place.x;
+        bot_apply(&game, &move);
+    }
+
+    tetris_get_map_r(&game, map);
+    for (y = 0; y < TETRIS_MAP_HEIGHT; y++)
+    {
+        if (map[y] != 0)
+            return false;
+    }
+
+    return !tetris_is_game_over_r(&game);
+}
+
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-n queries] [-q queue 1-%d] [-H height 0-%d] [-t threads 1-%d]\n"
+                    "       [-s seed] [-u] uniform pieces instead of 7-bag\n",
+            name, PC_QUEUE_MAX, PC_HEIGHT_MAX, PC_THREADS_MAX);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    unsigned long queries = 100, length = 10, height = 4, threads = 1, seed = 1;
+    unsigned long q, solved = 0;
+    const int16_t empty[TETRIS_MAP_HEIGHT] = { 0 };
+    uint8_t queue[PC_QUEUE_MAX], used;
+    pc_step_t step[PC_QUEUE_MAX];
+    pc_solver_t solver;
+    bool bag = true;
+    double start, used_sec, total = 0, slowest = 0;
+    uint32_t rng;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:q:H:t:s:u")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            queries = strtoul(optarg, NULL, 0);
+            break;
+        case 'q':
+            length = strtoul(optarg, NULL, 0);
+            break;
+        case 'H':
+            height = strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            threads = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = strtoul(optarg, NULL, 0);
+            break;
+        case 'u':
+            bag = false;
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (optind != argc || queries == 0 || length < 1 || length > PC_QUEUE_MAX
+        || height > PC_HEIGHT_MAX || threads < 1 || threads > PC_THREADS_MAX)
+        return usage(argv[0]);
+
+    if (!pc_init(&solver, 22))
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    solver.threads = (uint8_t)threads;
+    solver.height = (uint8_t)height;
+
+    rng = (uint32_t)seed * 2654435761u | 1;
+
+    for (q = 0; q < queries; q++)
+    {
+        make_queue(&rng, bag, queue, (uint8_t)length);
+
+        start = clock_sec();
+        used = pc_solve(&solver, empty, queue, (uint8_t)length, step);
+        used_sec = clock_sec() - start;
+
+        total += used_sec;
+        if (used_sec > slowest)
+            slowest = used_sec;
+
+        if (used > 0)
+        {
+            if (!verify(queue, (uint8_t)length, step, used))
+            {
+                fprintf(stderr, "query %lu: the engine does not clear the board\n", q);
+                return 1;
+            }
+            solved++;
+        }
+    }
+
+    printf("%lu queries, %s queue of %lu, height %lu, %lu thread(s)\n", queries,
+           bag ? "7-bag" : "uniform", length, height, threads);
+    printf("%lu solved (%.1f%%), %.3f ms/query (max %.3f)\n", solved, 100.0 * solved / queries,
+           total * 1000 / queries, slowest * 1000);
+    printf("%llu boards searched, %.0f boards/s, %llu skipped by the memo\n",
+           (unsigned long long)solver.nodes, solver.nodes / total,
+           (unsigned long long)solver.memo_hits);
+
+    pc_free(&solver);
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,507 @@
+/**
+  ******************************************************************************
+  * @file    pclear.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   全消(perfect clear)求解
+  * @note    全消时占用的行数为height, 其中的空格数必须是4的倍数, 而且
+  *          需要的方块数 = 空格数 / 4 不能多于序列中的方块数. 之后每放一个
+  *          方块空格数减4(消掉的行没有空格, 消行不改变空格数), 所以需要的
+  *          方块数在开始时就确定了. 放置不能超出height行, 消行后height减去
+  *          消除的行数.
+  *
+  *          填满的列把地图分成几部分, 各部分的空格数也必须是4的倍数.
+  *
+  *          已知无解的局面记在散列表中: 键为底部PC_HEIGHT_MAX行的位图(60位)
+  *          加上序列中的位置(4位), 正好是一个64位数, 同一次求解中不会误判.
+  *          每次求解的键与一个随机数异或, 上一次的项自然失效, 不用清空整个
+  *          表; 但旧的项并没有清除, 它与本次的某个键恰好相同的可能很小,
+  *          不是没有.
+  *
+  *          多线程: 第一个方块的各个放置由线程领取, 共用散列表(无锁, 每项
+  *          一次64位写入). 采用编号最小的放置找到的解, 有了解之后编号更大的
+  *          放置不再搜索, 所以结果与线程数无关.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include "pclear.h"
+#include "pool.h"
+
+/* Private typedef -----------------------------------------------------------*/
+// 一次求解, 由各线程共用
+typedef struct
+{
+    pc_solver_t *s;
+    int16_t map[TETRIS_MAP_HEIGHT];
+    const uint8_t *queue;
+    uint8_t count;                      // 需要的方块数
+    uint8_t height;
+    place_t root[PLACE_MAX];
+    uint32_t roots;
+    uint32_t next_root;
+    uint32_t best;                      // 找到解的最小放置编号
+    pc_step_t step[PC_QUEUE_MAX];       // 这个放置的解
+    pthread_mutex_t lock;
+} job_t;
+
+typedef struct
+{
+    job_t *job;
+    uint32_t root;                      // 正在搜索的放置编号
+    uint64_t nodes;
+    uint64_t memo_hits;
+    pc_step_t path[PC_QUEUE_MAX];
+} worker_t;
+
+// 线程池在两次求解之间保留, 线程数改变时重建
+struct pc_pool
+{
+    pool_t workers;
+    uint8_t count;                      // 线程数, 包括调用者; 0为还没建立
+    job_t job;
+    worker_t worker[PC_THREADS_MAX];    // worker[0]由调用pc_solve()的线程使用
+};
+
+/* Private define ------------------------------------------------------------*/
+#define     MAP_WIDTH           TETRIS_MAP_WIDTH
+#define     MAP_HEIGHT          TETRIS_MAP_HEIGHT
+#define     ROW_FULL            ((1 << MAP_WIDTH) - 1)
+
+#define     MEMO_PROBES         4       // 查找时检查的项数, 加入时随机替换其中一项
+#define     NO_ROOT             0xFFFFFFFFu
+
+/* Private macro -------------------------------------------------------------*/
+#define     BEST(job)           __atomic_load_n(&(job)->best, __ATOMIC_RELAXED)
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static uint64_t mix64(uint64_t z)
+{
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return z ^ (z >> 31);
+}
+
+
+/**
+ * \brief  散列表的键: 底部PC_HEIGHT_MAX行和序列中的位置
+ */
+static uint64_t memo_key(const pc_solver_t *s, const int16_t *map, uint8_t depth)
+{
+    uint64_t key = depth;
+    uint8_t y;
+
+    for (y = MAP_HEIGHT - PC_HEIGHT_MAX; y < MAP_HEIGHT; y++)
+        key = (key << MAP_WIDTH) | (map[y] & ROW_FULL);
+
+    return key ^ s->stamp;
+}
+
+
+static bool memo_find(const pc_solver_t *s, uint64_t key)
+{
+    uint32_t i = (uint32_t)mix64(key), n;
+
+    for (n = 0; n < MEMO_PROBES; n++)
+    {
+        if (__atomic_load_n(&s->memo[(i + n) & s->memo_mask], __ATOMIC_RELAXED) == key)
+            return true;
+    }
+
+    return false;
+}
+
+
+static void memo_add(pc_solver_t *s, uint64_t key)
+{
+    uint64_t h = mix64(key);
+
+    __atomic_store_n(&s->memo[((uint32_t)h + (h >> 32) % MEMO_PROBES) & s->memo_mask], key,
+                     __ATOMIC_RELAXED);
+
+    return;
+}
+
+
+/**
+ * \brief  上面的行全满, 方块与它们冲突就是超出了底部height行
+ */
+static void make_ceiling(int16_t *wall, uint8_t height)
+{
+    uint8_t y;
+
+    for (y = 0; y < MAP_HEIGHT; y++)
+        wall[y] = (y < MAP_HEIGHT - height) ? ROW_FULL : 0;
+
+    return;
+}
+
+
+/**
+ * \brief  被填满的列分开的各部分空格数是否都是4的倍数
+ * \note   方块不能越过填满的列, 消行后这一列仍然是满的, 所以两边各自
+ *         要用整数个方块填满
+ */
+static bool split_ok(const int16_t *map, uint8_t height)
+{
+    uint16_t full = ROW_FULL;
+    uint8_t y, x, cells = 0;
+
+    for (y = MAP_HEIGHT - height; y < MAP_HEIGHT; y++)
+        full &= map[y];
+
+    if (full == 0)
+        return true;
+
+    for (x = 0; x <= MAP_WIDTH; x++)
+    {
+        if (x == MAP_WIDTH || (full >> x) & 0x01)
+        {
+            if (cells % 4 != 0)
+                return false;
+            cells = 0;
+            continue;
+        }
+
+        for (y = MAP_HEIGHT - height; y < MAP_HEIGHT; y++)
+            cells += !((map[y] >> x) & 0x01);
+    }
+
+    return true;
+}
+
+
+/**
+ * \brief  放置序列中第depth个方块
+ *
+ * \return 找到解时返回true
+ */
+static bool dfs(worker_t *w, const int16_t *map, uint8_t depth, uint8_t height)
+{
+    job_t *job = w->job;
+    int16_t child[MAP_HEIGHT], wall[MAP_HEIGHT];
+    place_t place[PLACE_MAX];
+    tetris_brick_t spawn;
+    uint64_t key, hash = 0;
+    uint8_t type = job->queue[depth], n, i, lines, landing;
+
+    key = memo_key(job->s, map, depth);
+    if (memo_find(job->s, key))
+    {
+        w->memo_hits++;
+        return false;
+    }
+    w->nodes++;
+
+    tetris_brick_spawn(type, 0, &spawn);
+    n = place_list(map, type, 0, spawn.x, spawn.y, place);
+    make_ceiling(wall, height);
+
+    for (i = 0; i < n; i++)
+    {
+        // 编号更小的放置已经有解, 这里的结果没有用了, 也不能记为无解
+        if (BEST(job) < w->root)
+            return false;
+
+        if (place_conflict(wall, type, place[i].rotation, place[i].x, place[i].y))
+            continue;
+
+        lines = place_drop(map, child, &hash, type, place[i].rotation, place[i].x, place[i].y, &landing);
+
+        w->path[depth].type = type;
+        w->path[depth].place = place[i];
+
+        // 空格数每次减4, 最后一个方块放下时正好消掉所有的行
+        if (depth + 1 == job->count)
+        {
+            if (lines == height)
+                return true;
+            continue;
+        }
+
+        if (split_ok(child, height - lines) && dfs(w, child, depth + 1, height - lines))
+            return true;
+    }
+
+    if (BEST(job) >= w->root)
+        memo_add(job->s, key);
+
+    return false;
+}
+
+
+static void worker_loop(worker_t *w)
+{
+    job_t *job = w->job;
+    int16_t child[MAP_HEIGHT], wall[MAP_HEIGHT];
+    const place_t *p;
+    uint8_t type = job->queue[0], lines, landing;
+    uint64_t hash = 0;
+    bool found;
+
+    make_ceiling(wall, job->height);
+
+    while ((w->root = __atomic_fetch_add(&job->next_root, 1, __ATOMIC_RELAXED)) < job->roots)
+    {
+        if (BEST(job) < w->root)
+            break;
+
+        p = &job->root[w->root];
+        if (place_conflict(wall, type, p->rotation, p->x, p->y))
+            continue;
+
+        lines = place_drop(job->map, child, &hash, type, p->rotation, p->x, p->y, &landing);
+        w->path[0].type = type;
+        w->path[0].place = *p;
+
+        if (job->count == 1)
+            found = (lines == job->height);
+        else
+            found = split_ok(child, job->height - lines) && dfs(w, child, 1, job->height - lines);
+
+        if (!found)
+            continue;
+
+        pthread_mutex_lock(&job->lock);
+        if (w->root < job->best)
+        {
+            job->best = w->root;
+            memcpy(job->step, w->path, sizeof(job->step));
+        }
+        pthread_mutex_unlock(&job->lock);
+    }
+
+    return;
+}
+
+
+// 线程池中一个线程的工作
+static void solve_job(void *arg, uint8_t index)
+{
+    pc_pool_t *pool = arg;
+
+    worker_loop(&pool->worker[index]);
+
+    return;
+}
+
+
+/**
+ * \brief  按线程数重建线程池, 建不了线程时只用调用者
+ *
+ * \param  pool
+ * \param  threads 1 - PC_THREADS_MAX
+ */
+static void workers_resize(pc_pool_t *pool, uint8_t threads)
+{
+    if (pool->count == threads)
+        return;
+
+    if (pool->count > 1)
+        pool_free(&pool->workers);
+
+    pool->count = 1;
+    if (threads > 1 && pool_init(&pool->workers, threads))
+        pool->count = threads;
+
+    return;
+}
+
+
+/**
+ * \brief  在底部height行内求解
+ *
+ * \return 用掉的方块数, 无解时为0
+ */
+static uint8_t solve_height(pc_solver_t *s, uint8_t height)
+{
+    pc_pool_t *pool = s->pool;
+    job_t *job = &pool->job;
+    worker_t *worker = pool->worker;
+    tetris_brick_t spawn;
+    uint16_t cells = 0;
+    uint8_t threads = s->threads, i, y;
+
+    for (y = 0; y < MAP_HEIGHT; y++)
+    {
+        if (y < MAP_HEIGHT - height && (job->map[y] & ROW_FULL) != 0)
+            return 0;
+        cells += (uint16_t)__builtin_popcount(job->map[y] & ROW_FULL);
+    }
+
+    // 空格数是4的倍数, 并且序列中有足够的方块
+    if ((height * MAP_WIDTH - cells) % 4 != 0 || (height * MAP_WIDTH - cells) / 4 > job->count)
+        return 0;
+
+    job->count = (uint8_t)((height * MAP_WIDTH - cells) / 4);
+    job->height = height;
+    if (job->count == 0)
+        return 0;
+
+    tetris_brick_spawn(job->queue[0], 0, &spawn);
+    job->roots = place_list(job->map, job->queue[0], 0, spawn.x, spawn.y, job->root);
+    job->next_root = 0;
+    job->best = NO_ROOT;
+    s->stamp = mix64(s->stamp);
+
+    if (threads < 1)
+        threads = 1;
+    if (threads > PC_THREADS_MAX)
+        threads = PC_THREADS_MAX;
+
+    workers_resize(pool, threads);
+    threads = pool->count;
+
+    for (i = 0; i < threads; i++)
+    {
+        memset(&worker[i], 0, sizeof(worker[i]));
+        worker[i].job = job;
+    }
+
+    if (threads > 1)
+        pool_start(&pool->workers, solve_job, pool);
+    worker_loop(&worker[0]);
+    if (threads > 1)
+        pool_wait(&pool->workers);
+
+    for (i = 0; i < threads; i++)
+    {
+        s->nodes += worker[i].nodes;
+        s->memo_hits += worker[i].memo_hits;
+    }
+
+    return (job->best == NO_ROOT) ? 0 : job->count;
+}
+
+
+/**
+ * \brief  初始化
+ *
+ * \param  s
+ * \param  memo_bits 散列表有2^memo_bits项
+ *
+ * \return
+ */
+bool pc_init(pc_solver_t *s, uint8_t memo_bits)
+{
+    place_init();
+
+    memset(s, 0, sizeof(*s));
+    s->threads = 1;
+    s->memo_mask = (1u << memo_bits) - 1;
+    s->stamp = 0x9C;
+    s->memo = calloc((size_t)s->memo_mask + 1, sizeof(s->memo[0]));
+    s->pool = calloc(1, sizeof(*s->pool));
+
+    if (s->memo == NULL || s->pool == NULL)
+    {
+        free(s->memo);
+        free(s->pool);
+        s->memo = NULL;
+        s->pool = NULL;
+        return false;
+    }
+
+    pthread_mutex_init(&s->pool->job.lock, NULL);
+
+    return true;
+}
+
+
+void pc_free(pc_solver_t *s)
+{
+    if (s->pool != NULL)
+    {
+        if (s->pool->count > 1)
+            pool_free(&s->pool->workers);
+        pthread_mutex_destroy(&s->pool->job.lock);
+    }
+
+    free(s->pool);
+    free(s->memo);
+    s->pool = NULL;
+    s->memo = NULL;
+
+    return;
+}
+
+
+/**
+ * \brief  求解
+ *
+ * \param  s
+ * \param  map   地图, 不包括正在下落的方块
+ * \param  queue 方块序列, queue[0]为当前方块
+ * \param  count 序列的长度
+ * \param  step  至少count个
+ *
+ * \return 用掉的方块数, 无解时为0
+ */
+uint8_t pc_solve(pc_solver_t *s, const int16_t *map, const uint8_t *queue,
+                 uint8_t count, pc_step_t *step)
+{
+    job_t *job = &s->pool->job;
+    uint8_t height, first, last, used = 0;
+
+    if (count == 0 || count > PC_QUEUE_MAX)
+        return 0;
+
+    memcpy(job->map, map, sizeof(job->map));
+    job->s = s;
+    job->queue = queue;
+
+    first = last = s->height;
+    if (s->height == 0)
+    {
+        first = 1;
+        last = PC_HEIGHT_MAX;
+    }
+
+    // 占用的行越少需要的方块越少, 从低到高尝试
+    for (height = first; height <= last && used == 0; height++)
+    {
+        job->count = count;
+        used = solve_height(s, height);
+    }
+
+    if (used > 0)
+        memcpy(step, job->step, used * sizeof(step[0]));
+
+    return used;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
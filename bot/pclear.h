@@ -0,0 +1,90 @@
+/**
+  ******************************************************************************
+  * @file    pclear.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   全消(perfect clear)求解
+  * @note    已知方块序列(不能暂存), 求一组放置使地图变空. 放置只包括
+  *          place_list()能到达的(出生位置旋转, 平移, 直接落下), 与机器人相同.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _PCLEAR_H_
+#define _PCLEAR_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Tetris.h"
+#include "place.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define     PC_QUEUE_MAX        15      // 最长的方块序列
+#define     PC_HEIGHT_MAX       6       // 全消时最多占用的行数
+#define     PC_THREADS_MAX      16
+
+/* Exported types ------------------------------------------------------------*/
+// 一步: 出生的方块旋转place.rotation次, 移到place.x, 落到place.y
+typedef struct
+{
+    uint8_t type;
+    place_t place;
+} pc_step_t;
+
+typedef struct pc_memo pc_memo_t;
+typedef struct pc_pool pc_pool_t;
+
+// 前面的设置可以在两次求解之间修改, 其它成员只由pclear.c访问
+typedef struct
+{
+    uint8_t threads;                    //!< 线程数, 包括调用pc_solve()的线程
+    uint8_t height;                     //!< 全消时占用的行数, 0时从低到高自动尝试
+
+    uint64_t nodes;                     //!< 统计: 搜索过的局面数
+    uint64_t memo_hits;                 //!< 统计: 因记录过无解而跳过的局面数
+
+    uint64_t *memo;                     //!< 无解局面的散列表
+    uint32_t memo_mask;
+    uint64_t stamp;                     //!< 本次求解的编号, 与键混合, 不用清空表
+    pc_pool_t *pool;                    //!< 线程池, 本次求解和各线程的状态
+} pc_solver_t;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+// 初始化, 散列表有2^memo_bits项, 内存不足时返回false
+extern bool pc_init(pc_solver_t *s, uint8_t memo_bits);
+extern void pc_free(pc_solver_t *s);
+
+// map中只能有底部的PC_HEIGHT_MAX行有box, 不包括正在下落的方块;
+// queue[0]为当前方块. 找到时返回用掉的方块数, 放置写入step, 否则返回0
+extern uint8_t pc_solve(pc_solver_t *s, const int16_t *map, const uint8_t *queue,
+                        uint8_t count, pc_step_t *step);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,342 @@
+/**
+  ******************************************************************************
+  * @file    place.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   在地图的位数组上模拟方块的移动和放置, 供机器人使用
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "place.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+// 一种变形的点阵, 每行bit c对应第c列, 与地图相同
+typedef struct
+{
+    uint16_t row[4];
+    int8_t left, right;                 // 有box的最左, 最右列
+    int8_t top, bottom;                 // 有box的最上, 最下行
+} shape_t;
+
+/* Private define ------------------------------------------------------------*/
+#define     MAP_WIDTH           TETRIS_MAP_WIDTH
+#define     MAP_HEIGHT          TETRIS_MAP_HEIGHT
+#define     ROW_FULL            ((1 << MAP_WIDTH) - 1)
+
+
+/* Private macro -------------------------------------------------------------*/
+// 点阵的一行移到x列, 调用前已检查过左右边界
+#define     SHIFT(row, x)       ((x) >= 0 ? (row) << (x) : (row) >> -(x))
+
+/* Private variables ---------------------------------------------------------*/
+static shape_t brick_shape[TETRIS_BRICK_TYPES][4];
+static shape_t sweep_shape[TETRIS_BRICK_TYPES][4];
+
+// Zobrist散列, 每一行的每一种内容
+static uint64_t zobrist_row[MAP_HEIGHT][ROW_FULL + 1];
+
+static bool tables_ready = false;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  引擎的点阵(bit15为左上角)转为按行的位掩码
+ *
+ * \param  dest
+ * \param  data
+ */
+static void make_shape(shape_t *dest, uint16_t data)
+{
+    uint8_t r, c;
+
+    dest->left = 4;
+    dest->right = -1;
+    dest->top = 4;
+    dest->bottom = -1;
+
+    for (r = 0; r < 4; r++)
+    {
+        dest->row[r] = 0;
+        for (c = 0; c < 4; c++)
+        {
+            if (data & (0x8000 >> (r * 4 + c)))
+            {
+                dest->row[r] |= 0x0001 << c;
+                if (c < dest->left)
+                    dest->left = c;
+                if (c > dest->right)
+                    dest->right = c;
+                if (r < dest->top)
+                    dest->top = r;
+                dest->bottom = r;
+            }
+        }
+    }
+
+    return;
+}
+
+
+void place_init(void)
+{
+    tetris_brick_t brick;
+    uint64_t s = 0x5EED;
+    uint16_t i, y;
+    uint8_t type, r;
+
+    if (tables_ready)
+        return;
+
+    for (type = 0; type < TETRIS_BRICK_TYPES; type++)
+    {
+        for (r = 0; r < 4; r++)
+        {
+            tetris_brick_spawn(type, r, &brick);
+            make_shape(&brick_shape[type][r], brick.shape);
+            make_shape(&sweep_shape[type][r], tetris_rotate_mask(type, r));
+        }
+    }
+
+    for (y = 0; y < MAP_HEIGHT; y++)
+    {
+        for (i = 0; i <= ROW_FULL; i++)
+            zobrist_row[y][i] = splitmix64(&s);
+    }
+
+    tables_ready = true;
+
+    return;
+}
+
+
+uint64_t place_hash(const int16_t *map)
+{
+    uint64_t h = 0;
+    uint8_t y;
+
+    for (y = 0; y < MAP_HEIGHT; y++)
+        h ^= zobrist_row[y][map[y] & ROW_FULL];
+
+    return h;
+}
+
+
+/**
+ * \brief  去掉地图中正在下落的方块
+ *
+ * \param  map
+ * \param  brick tetris_get_brick()取得的当前方块
+ */
+void place_remove(int16_t *map, const tetris_brick_t *brick)
+{
+    const shape_t *s = &brick_shape[brick->type][brick->rotation];
+    int8_t r;
+
+    for (r = s->top; r <= s->bottom; r++)
+    {
+        if (brick->y + r >= 0)
+            map[brick->y + r] &= ~SHIFT(s->row[r], brick->x);
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  冲突检测, 与引擎相同: 地图上方只检查左右边界
+ */
+static bool is_conflict(const int16_t *map, const shape_t *s, int8_t x, int8_t y)
+{
+    int8_t r, row;
+
+    if (x + s->left < 0 || x + s->right >= MAP_WIDTH)
+        return true;
+
+    for (r = s->top; r <= s->bottom; r++)
+    {
+        row = y + r;
+        if (row < 0)
+            continue;
+        if (row >= MAP_HEIGHT || (map[row] & SHIFT(s->row[r], x)))
+            return true;
+    }
+
+    return false;
+}
+
+
+/**
+ * \brief  方块在(x, y)处是否与地图或边界冲突
+ */
+bool place_conflict(const int16_t *map, uint8_t type, uint8_t rotation, int8_t x, int8_t y)
+{
+    return is_conflict(map, &brick_shape[type][rotation & 0x03], x, y);
+}
+
+
+/**
+ * \brief  旋转到rotation时是否有阻挡, 与引擎相同, 检查旋转掩码
+ */
+bool place_rotate_conflict(const int16_t *map, uint8_t type, uint8_t rotation, int8_t x, int8_t y)
+{
+    return is_conflict(map, &sweep_shape[type][rotation & 0x03], x, y);
+}
+
+
+/**
+ * \brief  两种变形的点阵是否相同, 如O的四种变形
+ */
+bool place_same_shape(uint8_t type, uint8_t r1, uint8_t r2)
+{
+    return memcmp(brick_shape[type][r1 & 0x03].row, brick_shape[type][r2 & 0x03].row,
+                  sizeof(brick_shape[0][0].row)) == 0;
+}
+
+
+/**
+ * \brief  列出方块从(x, y, rotation)出发能到达的所有放置
+ *
+ * \param  map
+ * \param  type
+ * \param  rotation 方块当前的变形
+ * \param  x
+ * \param  y
+ * \param  place    至少PLACE_MAX个
+ *
+ * \return 放置数
+ */
+uint8_t place_list(const int16_t *map, uint8_t type, uint8_t rotation,
+                   int8_t x, int8_t y, place_t *place)
+{
+    const shape_t *s;
+    uint16_t seen[4];
+    uint8_t k, i, n = 0;
+    int8_t left, right, px, py, top;
+
+    // 最高的有box的行, 方块在它上面时不会冲突, 落下时直接从那里开始
+    for (top = 0; top < MAP_HEIGHT && map[top] == 0; top++);
+
+    for (k = 0; k < 4; k++)
+    {
+        rotation &= 0x03;
+        s = &brick_shape[type][rotation];
+
+        // 旋转经过的位置有阻挡, 之后的变形都到不了
+        if (k > 0 && is_conflict(map, &sweep_shape[type][rotation], x, y))
+            break;
+
+        // 点阵相同的变形(如O)放置也相同
+        seen[k] = brick_shape[type][rotation].row[0] ^ (brick_shape[type][rotation].row[1] << 4)
+                ^ (brick_shape[type][rotation].row[2] << 8) ^ (brick_shape[type][rotation].row[3] << 12);
+        for (i = 0; i < k && seen[i] != seen[k]; i++);
+
+        if (i == k)
+        {
+            for (left = x; !is_conflict(map, s, left - 1, y); left--);
+            for (right = x; !is_conflict(map, s, right + 1, y); right++);
+
+            for (px = left; px <= right; px++)
+            {
+                py = y;
+                if (py + s->bottom < top - 1)
+                    py = top - 1 - s->bottom;
+                for (; !is_conflict(map, s, px, py + 1); py++);
+                place[n].rotation = k;
+                place[n].x = px;
+                place[n].y = py;
+                n++;
+            }
+        }
+
+        rotation++;
+    }
+
+    return n;
+}
+
+
+/**
+ * \brief  把方块放入地图并消行, 同时更新散列值
+ *
+ * \param  src
+ * \param  dest
+ * \param  hash    src的散列值, 返回dest的散列值
+ * \param  type
+ * \param  rotation 方块的变形
+ * \param  x
+ * \param  y
+ * \param  landing 返回方块的高度
+ *
+ * \return 消除的行数
+ */
+uint8_t place_drop(const int16_t *src, int16_t *dest, uint64_t *hash,
+                   uint8_t type, uint8_t rotation, int8_t x, int8_t y, uint8_t *landing)
+{
+    const shape_t *s = &brick_shape[type][rotation & 0x03];
+    uint8_t lines = 0;
+    int8_t r, row, to;
+
+    memcpy(dest, src, MAP_HEIGHT * sizeof(dest[0]));
+
+    for (r = s->top; r <= s->bottom; r++)
+    {
+        row = y + r;
+        if (row < 0)
+            continue;
+        dest[row] |= SHIFT(s->row[r], x);
+        lines += (dest[row] == ROW_FULL);
+        // 只有方块所在的行改变, 散列值逐行更新
+        *hash ^= zobrist_row[row][src[row] & ROW_FULL] ^ zobrist_row[row][dest[row] & ROW_FULL];
+    }
+
+    *landing = (uint8_t)(MAP_HEIGHT - 1 - y - (s->top + s->bottom) / 2);
+
+    if (lines == 0)
+        return 0;
+
+    // 消行后整个地图下移, 重新计算散列值
+    for (row = to = MAP_HEIGHT - 1; row >= 0; row--)
+    {
+        if (dest[row] != ROW_FULL)
+            dest[to--] = dest[row];
+    }
+    while (to >= 0)
+        dest[to--] = 0;
+
+    *hash = place_hash(dest);
+
+    return lines;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    place.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   在地图的位数组上模拟方块的移动和放置, 供机器人使用
+  * @note    规则与引擎相同: 先在原地旋转, 再水平移动, 最后落下;
+  *          方块落下时还有部分在地图外即为游戏结束.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _PLACE_H_
+#define _PLACE_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Tetris.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define     PLACE_MAX           (4 * TETRIS_MAP_WIDTH)  // 一个方块最多的放置数
+
+/* Exported types ------------------------------------------------------------*/
+// 一个放置: 在当前位置旋转rotation次, 水平移动到x, 落到y
+typedef struct
+{
+    uint8_t rotation;
+    int8_t x;
+    int8_t y;                           //!< 小于0时放下后游戏结束
+} place_t;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+// 建立方块和散列的表, 使用其它函数之前调用, 可以重复调用
+extern void place_init(void);
+
+// 地图的Zobrist散列值
+extern uint64_t place_hash(const int16_t *map);
+// 从tetris_get_map()的结果中去掉正在下落的方块
+extern void place_remove(int16_t *map, const tetris_brick_t *brick);
+
+// 方块在(x, y)处与地图或边界冲突
+extern bool place_conflict(const int16_t *map, uint8_t type, uint8_t rotation, int8_t x, int8_t y);
+// 旋转到rotation时经过的位置有阻挡, 与引擎的旋转检测相同
+extern bool place_rotate_conflict(const int16_t *map, uint8_t type, uint8_t rotation, int8_t x, int8_t y);
+// 两种变形的点阵相同
+extern bool place_same_shape(uint8_t type, uint8_t r1, uint8_t r2);
+
+// 列出type类型的方块从(x, y, rotation)出发能到达的所有放置, 返回放置数
+extern uint8_t place_list(const int16_t *map, uint8_t type, uint8_t rotation,
+                          int8_t x, int8_t y, place_t *place);
+// 把方块放入地图并消行, 返回消除的行数; hash为src的散列值, 返回dest的散列值
+extern uint8_t place_drop(const int16_t *src, int16_t *dest, uint64_t *hash,
+                          uint8_t type, uint8_t rotation, int8_t x, int8_t y, uint8_t *landing);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,221 @@
+/**
+  ******************************************************************************
+  * @file    pool.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   机器人共用的线程池
+  * @note    线程在初始化时启动, 之后每次搜索只唤醒, 不再创建和回收线程.
+  *          调用者也是一个工作线程(序号0), 所以threads为1时没有额外的线程.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <time.h>
+#include "pool.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static void *pool_thread(void *arg)
+{
+    pool_worker_t *w = arg;
+    pool_t *pool = w->pool;
+    uint32_t job = 0;
+
+    while (1)
+    {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->job == job && !pool->quit)
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        if (pool->quit)
+        {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        job = pool->job;
+        pthread_mutex_unlock(&pool->lock);
+
+        pool->work(pool->arg, w->index);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0)
+            pthread_cond_broadcast(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    return NULL;
+}
+
+
+/**
+ * \brief  初始化, 启动线程
+ *
+ * \param  pool
+ * \param  threads 线程数, 包括调用者, 超出范围时取最近的值
+ *
+ * \return 失败时返回false
+ */
+bool pool_init(pool_t *pool, uint8_t threads)
+{
+    pthread_condattr_t attr;
+    uint8_t i;
+
+    if (threads < 1)
+        threads = 1;
+    if (threads > POOL_THREADS_MAX)
+        threads = POOL_THREADS_MAX;
+
+    pool->count = 1;
+    pool->job = 0;
+    pool->busy = 0;
+    pool->quit = false;
+    pool->work = NULL;
+    pool->arg = NULL;
+
+    // 调用者按单调时钟等到时间上限
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, &attr);
+    pthread_condattr_destroy(&attr);
+
+    for (i = 1; i < threads; i++)
+    {
+        pool->worker[i].pool = pool;
+        pool->worker[i].index = i;
+        if (pthread_create(&pool->thread[i], NULL, pool_thread, &pool->worker[i]) != 0)
+        {
+            pool_free(pool);
+            return false;
+        }
+        pool->count = i + 1;
+    }
+
+    return true;
+}
+
+
+/**
+ * \brief  结束线程并释放, 正在进行的任务先完成
+ *
+ * \param  pool
+ */
+void pool_free(pool_t *pool)
+{
+    uint8_t i;
+
+    pool_wait(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (i = 1; i < pool->count; i++)
+        pthread_join(pool->thread[i], NULL);
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    pthread_cond_destroy(&pool->done);
+    pool->count = 0;
+
+    return;
+}
+
+
+/**
+ * \brief  开始一个任务
+ *
+ * \param  pool
+ * \param  work
+ * \param  arg
+ */
+void pool_start(pool_t *pool, pool_work_t work, void *arg)
+{
+    // 上一个任务到时后还在算的线程很快就会停下, 等它们停下才能改任务
+    pool_wait(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->work = work;
+    pool->arg = arg;
+    pool->busy = pool->count - 1;
+    pool->job++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    return;
+}
+
+
+void pool_wait(pool_t *pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0)
+        pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+
+    return;
+}
+
+
+/**
+ * \brief  等待当前任务, 最多到deadline
+ *
+ * \param  pool
+ * \param  deadline 与clock_ns()相同的单调时钟, ns
+ *
+ * \return 所有线程都完成时返回true
+ */
+bool pool_wait_until(pool_t *pool, uint64_t deadline)
+{
+    struct timespec until;
+    bool done;
+
+    until.tv_sec = (time_t)(deadline / 1000000000u);
+    until.tv_nsec = (long)(deadline % 1000000000u);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0)
+    {
+        if (pthread_cond_timedwait(&pool->done, &pool->lock, &until) != 0)
+            break;
+    }
+    done = (pool->busy == 0);
+    pthread_mutex_unlock(&pool->lock);
+
+    return done;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
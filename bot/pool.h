@@ -0,0 +1,93 @@
+/**
+  ******************************************************************************
+  * @file    pool.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   机器人共用的线程池
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _POOL_H_
+#define _POOL_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define     POOL_THREADS_MAX    16      // 线程数, 包括调用者
+
+/* Exported types ------------------------------------------------------------*/
+// 一个任务在一个线程中的工作, index为线程的序号, 0为调用者
+typedef void (*pool_work_t)(void *arg, uint8_t index);
+
+typedef struct pool pool_t;
+
+// 一个线程的参数
+typedef struct
+{
+    pool_t *pool;
+    uint8_t index;
+} pool_worker_t;
+
+// 成员只由pool.c访问; 线程启动后实例不能移动
+struct pool
+{
+    pthread_t thread[POOL_THREADS_MAX];
+    pool_worker_t worker[POOL_THREADS_MAX];
+    uint8_t count;                      //!< 线程数, 包括调用者
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;                //!< 按CLOCK_MONOTONIC计时
+    uint32_t job;                       //!< 任务编号, 改变时线程开始工作
+    uint8_t busy;                       //!< 还没完成当前任务的线程数
+    bool quit;
+
+    pool_work_t work;                   //!< 当前任务
+    void *arg;
+};
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+// 启动threads - 1个线程, 失败时返回false, 这时不需要pool_free()
+extern bool pool_init(pool_t *pool, uint8_t threads);
+extern void pool_free(pool_t *pool);
+
+// 线程序号1 - count-1各调用一次work(arg, index), 不等待; 调用者自己完成序号0的部分
+// 上一个任务还有线程没完成时先等待它们
+extern void pool_start(pool_t *pool, pool_work_t work, void *arg);
+// 等所有线程完成当前任务
+extern void pool_wait(pool_t *pool);
+// 最多等到deadline(clock_ns()), 所有线程都完成时返回true
+extern bool pool_wait_until(pool_t *pool, uint64_t deadline);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,541 @@
+/**
+  ******************************************************************************
+  * @file    tune.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   用遗传算法调整局面评估的权重
+  * @note    每一代的每个候选权重都在同一组种子的局面上玩若干局(每个种子
+  *          决定方块序列和垃圾行), 以平均每局的方块数为适应度. (候选, 局)
+  *          作为一个任务由各线程领取, 每个线程有自己的引擎实例和机器人;
+  *          结果按任务编号存放, 汇总的顺序固定, 所以结果与线程数无关,
+  *          同一个种子的两次运行完全相同.
+  *
+  *          每一代结束后把种群写入检查点文件(先写临时文件再改名), -r从
+  *          检查点继续, 浮点数以%a格式保存, 继续运行与不中断的结果相同.
+  *          检查点中记下-g -P -G -d -w, 继续时这些参数必须与之相同.
+  *
+  *          用法: tune [-n 代数] [-p 种群大小] [-g 每个候选的局数] [-P 每局最多方块数]
+  *                     [-G 垃圾行间隔] [-d 深度] [-w 束宽] [-t 线程数] [-s 种子]
+  *                     [-c 检查点文件] [-r] 从检查点继续
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "Tetris.h"
+#include "bot.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    eval_weights_t weights;
+    double fitness;                     // 平均每局的方块数
+    unsigned long order;                // 排序前的序号, 适应度相同时按它排
+} candidate_t;
+
+/* Private define ------------------------------------------------------------*/
+#define     POPULATION_MAX      256
+#define     GAMES_MAX           256
+#define     THREADS_MAX         64
+
+#define     MUTATION_RATE       0.2     // 每个权重变异的概率
+#define     MUTATION_SIZE       0.15    // 变异的标准差, 权重向量的长度为1
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static candidate_t population[POPULATION_MAX];
+static unsigned long population_size = 32;
+static unsigned long games = 8;
+static unsigned long limit = 500;
+static unsigned long garbage = 5;
+static unsigned long depth = 1, beam = 1;
+
+// 一代的任务, 任务i为第i / games个候选的第i % games局
+static unsigned long pieces_of[POPULATION_MAX * GAMES_MAX];
+static unsigned long task_count;
+static unsigned long task_next;
+static uint32_t game_seed;
+
+/* Private function prototypes -----------------------------------------------*/
+static void count_lines(tetris_t *t, uint8_t line);
+
+/* Private functions ---------------------------------------------------------*/
+
+static const tetris_ops_t game_ops = { NULL, NULL, NULL, count_lines };
+
+
+static void count_lines(tetris_t *t, uint8_t line)
+{
+    *(unsigned long *)t->user += line;
+
+    return;
+}
+
+
+// [0, 1)
+static double uniform(uint64_t *s)
+{
+    return (splitmix64(s) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+static double gaussian(uint64_t *s)
+{
+    double u = uniform(s), v = uniform(s);
+
+    return sqrt(-2.0 * log(1.0 - u)) * cos(2.0 * M_PI * v);
+}
+
+
+/**
+ * \brief  把权重向量缩放到长度为1, 机器人只比较分数, 长度不影响选择
+ */
+static void normalize(eval_weights_t *w)
+{
+    double len = 0;
+    uint8_t i;
+
+    for (i = 0; i < EVAL_FEATURES; i++)
+        len += (double)w->w[i] * w->w[i];
+
+    len = sqrt(len);
+    if (len == 0)
+        return;
+
+    for (i = 0; i < EVAL_FEATURES; i++)
+        w->w[i] = (float)(w->w[i] / len);
+
+    return;
+}
+
+
+/**
+ * \brief  用weights玩一局
+ *
+ * \return 放置的方块数
+ */
+static unsigned long play(bot_t *bot, uint32_t seed)
+{
+    int16_t map[TETRIS_MAP_HEIGHT];
+    tetris_brick_t curr, next;
+    bot_move_t move;
+    tetris_t game;
+    unsigned long pieces, lines = 0;
+    uint32_t hole = seed * 2654435761u | 1;
+
+    tetris_init_r(&game, &game_ops, &lines, seed);
+
+    for (pieces = 0; pieces < limit && !tetris_is_game_over_r(&game); pieces++)
+    {
+        tetris_get_map_r(&game, map);
+        tetris_get_brick_r(&game, &curr, &next);
+        bot_think(bot, map, &curr, &next, &move);
+        bot_apply(&game, &move);
+
+        if (garbage > 0 && pieces % garbage == garbage - 1)
+        {
+            hole ^= hole << 13;
+            hole ^= hole >> 17;
+            hole ^= hole << 5;
+            tetris_add_garbage_r(&game, 1, (uint8_t)(hole % TETRIS_MAP_WIDTH));
+        }
+    }
+
+    return pieces;
+}
+
+
+static void *worker(void *arg)
+{
+    bot_t *bot = arg;
+    const eval_weights_t *weights = NULL;
+    unsigned long i;
+
+    while ((i = __atomic_fetch_add(&task_next, 1, __ATOMIC_RELAXED)) < task_count)
+    {
+        // 换了候选, 置换表中缓存的分数不再有效
+        if (weights != &population[i / games].weights)
+        {
+            weights = &population[i / games].weights;
+            bot->weights = weights;
+            bot_clear(bot);
+        }
+
+        pieces_of[i] = play(bot, game_seed + (uint32_t)(i % games));
+    }
+
+    return NULL;
+}
+
+
+/**
+ * \brief  评估整个种群
+ */
+static void evaluate(bot_t *bot, unsigned long threads)
+{
+    pthread_t thread[THREADS_MAX];
+    unsigned long i, k, n, sum;
+
+    task_count = population_size * games;
+    task_next = 0;
+
+    for (n = 1; n < threads; n++)
+    {
+        if (pthread_create(&thread[n], NULL, worker, &bot[n]) != 0)
+            break;
+    }
+
+    worker(&bot[0]);
+
+    for (i = 1; i < n; i++)
+        pthread_join(thread[i], NULL);
+
+    // 按固定的顺序汇总, 与线程数和完成的先后无关
+    for (i = 0; i < population_size; i++)
+    {
+        for (k = 0, sum = 0; k < games; k++)
+            sum += pieces_of[i * games + k];
+        population[i].fitness = (double)sum / games;
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  适应度从高到低排序, 相同时保持原来的顺序
+ */
+static int compare(const void *a, const void *b)
+{
+    const candidate_t *x = a, *y = b;
+
+    if (x->fitness != y->fitness)
+        return (x->fitness < y->fitness) ? 1 : -1;
+
+    return (x->order < y->order) ? -1 : (x->order > y->order);
+}
+
+
+/**
+ * \brief  二元锦标赛选择, 种群已排序, 编号小的更好
+ */
+static const candidate_t *select_parent(uint64_t *rng)
+{
+    unsigned long a = splitmix64(rng) % population_size;
+    unsigned long b = splitmix64(rng) % population_size;
+
+    return &population[a < b ? a : b];
+}
+
+
+/**
+ * \brief  由排序后的种群产生下一代: 保留最好的1/8, 其余由交叉和变异产生
+ */
+static void breed(uint64_t *rng)
+{
+    static candidate_t child[POPULATION_MAX];
+    unsigned long elite = (population_size + 7) / 8, i;
+    const candidate_t *a, *b;
+    double u;
+    uint8_t k;
+
+    for (i = 0; i < population_size; i++)
+    {
+        if (i < elite)
+        {
+            child[i] = population[i];
+            continue;
+        }
+
+        a = select_parent(rng);
+        b = select_parent(rng);
+
+        for (k = 0; k < EVAL_FEATURES; k++)
+        {
+            u = uniform(rng);
+            child[i].weights.w[k] = (float)(u * a->weights.w[k] + (1 - u) * b->weights.w[k]);
+            if (uniform(rng) < MUTATION_RATE)
+                child[i].weights.w[k] += (float)(gaussian(rng) * MUTATION_SIZE);
+        }
+        normalize(&child[i].weights);
+        child[i].fitness = 0;
+    }
+
+    memcpy(population, child, population_size * sizeof(population[0]));
+
+    return;
+}
+
+
+/**
+ * \brief  写检查点, 先写临时文件再改名, 中断时旧的检查点仍然完整
+ */
+static bool save(const char *path, unsigned long generation, uint64_t rng)
+{
+    char tmp[1024];
+    FILE *fp;
+    unsigned long i;
+    uint8_t k;
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    fp = fopen(tmp, "w");
+    if (fp == NULL)
+        return false;
+
+    fprintf(fp, "generation %lu\nrng %llu\nseed %lu\npopulation %lu\n",
+            generation, (unsigned long long)rng, (unsigned long)game_seed, population_size);
+    fprintf(fp, "games %lu\npieces %lu\ngarbage %lu\ndepth %lu\nbeam %lu\n",
+            games, limit, garbage, depth, beam);
+    for (i = 0; i < population_size; i++)
+    {
+        for (k = 0; k < EVAL_FEATURES; k++)
+            fprintf(fp, "%a ", population[i].weights.w[k]);
+        fprintf(fp, "%a\n", population[i].fitness);
+    }
+
+    if (fclose(fp) != 0 || rename(tmp, path) != 0)
+        return false;
+
+    return true;
+}
+
+
+/**
+ * \brief  读检查点
+ *
+ * \param  path
+ * \param  generation
+ * \param  rng
+ *
+ * \return 读不了或-g -P -G -d -w与检查点不同时返回false
+ */
+static bool load(const char *path, unsigned long *generation, uint64_t *rng)
+{
+    unsigned long long r;
+    unsigned long seed, g, p, gb, d, w;
+    FILE *fp;
+    unsigned long i;
+    uint8_t k;
+    bool ok;
+
+    fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        perror(path);
+        return false;
+    }
+
+    ok = fscanf(fp, "generation %lu rng %llu seed %lu population %lu", generation, &r,
+                &seed, &population_size) == 4
+         && population_size >= 2 && population_size <= POPULATION_MAX
+         && fscanf(fp, " games %lu pieces %lu garbage %lu depth %lu beam %lu",
+                   &g, &p, &gb, &d, &w) == 5;
+
+    // 参数不同时适应度不可比, 继续运行也不再与不中断的结果相同
+    if (ok && (g != games || p != limit || gb != garbage || d != depth || w != beam))
+    {
+        fprintf(stderr, "%s was written with -g %lu -P %lu -G %lu -d %lu -w %lu\n",
+                path, g, p, gb, d, w);
+        fclose(fp);
+        return false;
+    }
+
+    for (i = 0; ok && i < population_size; i++)
+    {
+        for (k = 0; ok && k < EVAL_FEATURES; k++)
+            ok = fscanf(fp, "%a", &population[i].weights.w[k]) == 1;
+        ok = ok && fscanf(fp, "%la", &population[i].fitness) == 1;
+    }
+
+    fclose(fp);
+    if (!ok)
+        fprintf(stderr, "%s: bad checkpoint\n", path);
+    *rng = r;
+    game_seed = (uint32_t)seed;
+
+    return ok;
+}
+
+
+static void print_weights(const eval_weights_t *w)
+{
+    uint8_t k;
+
+    for (k = 0; k < EVAL_FEATURES; k++)
+        printf(" %7.4f", w->w[k]);
+    printf("\n");
+
+    return;
+}
+
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-n generations] [-p population 2-%d] [-g games 1-%d] [-P pieces]\n"
+                    "       [-G pieces per garbage row] [-d depth 1-%d] [-w beam 1-%d]\n"
+                    "       [-t threads 1-%d] [-s seed] [-c checkpoint] [-r] resume\n",
+            name, POPULATION_MAX, GAMES_MAX, BOT_DEPTH_MAX, BOT_BEAM_MAX, THREADS_MAX);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    unsigned long generations = 20, threads = 1, seed = 1, generation = 0, i;
+    const char *checkpoint = "tune.txt";
+    static bot_t bot[THREADS_MAX];
+    bool resume = false;
+    uint64_t rng;
+    uint8_t k;
+    double start, used;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:p:g:P:G:d:w:t:s:c:r")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            generations = strtoul(optarg, NULL, 0);
+            break;
+        case 'p':
+            population_size = strtoul(optarg, NULL, 0);
+            break;
+        case 'g':
+            games = strtoul(optarg, NULL, 0);
+            break;
+        case 'P':
+            limit = strtoul(optarg, NULL, 0);
+            break;
+        case 'G':
+            garbage = strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            depth = strtoul(optarg, NULL, 0);
+            break;
+        case 'w':
+            beam = strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            threads = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = strtoul(optarg, NULL, 0);
+            break;
+        case 'c':
+            checkpoint = optarg;
+            break;
+        case 'r':
+            resume = true;
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (optind != argc || population_size < 2 || population_size > POPULATION_MAX
+        || games < 1 || games > GAMES_MAX || depth < 1 || depth > BOT_DEPTH_MAX
+        || beam < 1 || beam > BOT_BEAM_MAX || threads < 1 || threads > THREADS_MAX)
+        return usage(argv[0]);
+
+    if (resume)
+    {
+        if (!load(checkpoint, &generation, &rng))
+            return 1;
+        printf("resuming %s at generation %lu\n", checkpoint, generation);
+    }
+    else
+    {
+        // 第一个候选是默认权重, 其余为随机方向
+        rng = seed;
+        game_seed = (uint32_t)splitmix64(&rng);
+        population[0].weights = eval_default_weights;
+        normalize(&population[0].weights);
+        for (i = 1; i < population_size; i++)
+        {
+            for (k = 0; k < EVAL_FEATURES; k++)
+                population[i].weights.w[k] = (float)gaussian(&rng);
+            normalize(&population[i].weights);
+        }
+    }
+
+    for (i = 0; i < threads; i++)
+    {
+        if (!bot_init(&bot[i], (uint8_t)depth, (uint16_t)beam))
+        {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+    }
+
+    for (; generation < generations; generation++)
+    {
+        start = clock_sec();
+        evaluate(bot, threads);
+        used = clock_sec() - start;
+
+        for (i = 0; i < population_size; i++)
+            population[i].order = i;
+        qsort(population, population_size, sizeof(population[0]), compare);
+
+        printf("generation %lu: best %.1f, median %.1f pieces/game, %.0f games/s\n",
+               generation, population[0].fitness, population[population_size / 2].fitness,
+               population_size * games / used);
+        print_weights(&population[0].weights);
+        fflush(stdout);
+
+        // 检查点保存还没评估的下一代(前面是保留下来的最好的候选)和随机数状态
+        breed(&rng);
+        if (!save(checkpoint, generation + 1, rng))
+        {
+            fprintf(stderr, "cannot write %s\n", checkpoint);
+            return 1;
+        }
+    }
+
+    for (i = 0; i < threads; i++)
+        bot_free(&bot[i]);
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -34,6 +34,9 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include <string.h>         // memcpy()
+#if defined(__ICC430__)
+#include <intrinsics.h>     // __memory_barrier()
+#endif
 #include "fifo.h"
 
 /* Private typedef -----------------------------------------------------------*/
@@ -42,6 +45,17 @@
 #define     MIN(a, b)   ((a) < (b) ? (a) : (b))
 #define     MAX(a, b)   ((a) < (b) ? (b) : (a))
 
+// 数据必须先写入缓冲区再更新in, 先读出再更新out; 访问数据也必须在读到
+// 对方的偏移之后. 防止编译器调换顺序
+// C允许把普通访问移过volatile访问, 所以各编译器都要明确的屏障
+#if defined(__ICC430__)
+    #define FIFO_BARRIER()  __memory_barrier()
+#elif defined(__GNUC__)
+    #define FIFO_BARRIER()  __asm__ __volatile__("" ::: "memory")
+#else
+    #error "FIFO_BARRIER() is not defined for this compiler"
+#endif
+
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
@@ -54,7 +68,7 @@
  * \retval true
  * \retval false
  */
-static bool is_pow_of_2(uint32_t x)
+static bool is_pow_of_2(fifo_index_t x)
 {
     return !(x & (x-1));
 }
@@ -84,17 +98,20 @@ void fifo_init(fifo_t *fifo)
  *
  * \return 实际写入的长度
  */
-uint32_t fifo_put(fifo_t *fifo, uint8_t *buffer, uint32_t len)
+fifo_index_t fifo_put(fifo_t *fifo, const uint8_t *buffer, fifo_index_t len)
 {
-    uint32_t l;
+    fifo_index_t l;
+    fifo_index_t in = fifo->in;
 
-    len = MIN(len, fifo->size - (fifo->in - fifo->out));
-    l = MIN(len, fifo->size - (fifo->in & (fifo->size - 1)));
+    len = MIN(len, (fifo_index_t)(fifo->size - (fifo_index_t)(in - fifo->out)));
+    l = MIN(len, fifo->size - (in & (fifo->size - 1)));
 
-    memcpy(fifo->buffer + (fifo->in & (fifo->size - 1)), buffer, l);
+    FIFO_BARRIER();
+    memcpy(fifo->buffer + (in & (fifo->size - 1)), buffer, l);
     memcpy(fifo->buffer, buffer + l, len - l);
 
-    fifo->in += len;
+    FIFO_BARRIER();
+    fifo->in = in + len;
 
     return len;
 }
@@ -110,17 +127,57 @@ uint32_t fifo_put(fifo_t *fifo, uint8_t *buffer, uint32_t len)
  */
 bool fifo_putc(fifo_t *fifo, uint8_t byte)
 {
+    fifo_index_t in = fifo->in;
+
     // fifo已满
-    if (fifo->size - (fifo->in - fifo->out) == 0)
+    if ((fifo_index_t)(in - fifo->out) == fifo->size)
         return false;
 
-    *(fifo->buffer + (fifo->in & (fifo->size - 1))) = byte;
-    fifo->in++;
+    FIFO_BARRIER();
+    *(fifo->buffer + (in & (fifo->size - 1))) = byte;
+
+    FIFO_BARRIER();
+    fifo->in = in + 1;
 
     return true;
 }
 
 
+/**
+ * \brief  取得一段连续的可写空间, 调用者直接写入后再提交,
+ *         省去先写到临时缓存再复制的过程
+ *
+ * \param  fifo
+ * \param  len  返回可写空间的长度, 到缓冲区末尾为止, 可能小于fifo_free()
+ *
+ * \return 可写空间的起始地址
+ */
+uint8_t *fifo_reserve(fifo_t *fifo, fifo_index_t *len)
+{
+    fifo_index_t in = fifo->in;
+
+    *len = MIN((fifo_index_t)(fifo->size - (fifo_index_t)(in - fifo->out)),
+               fifo->size - (in & (fifo->size - 1)));
+
+    return fifo->buffer + (in & (fifo->size - 1));
+}
+
+
+/**
+ * \brief  提交fifo_reserve()取得的空间中已写入的数据
+ *
+ * \param  fifo
+ * \param  len  已写入的字节数, 不能超过fifo_reserve()返回的长度
+ */
+void fifo_commit(fifo_t *fifo, fifo_index_t len)
+{
+    FIFO_BARRIER();
+    fifo->in += len;
+
+    return;
+}
+
+
 /**
  * \brief  从fifo中取出数据
  *
@@ -130,17 +187,20 @@ bool fifo_putc(fifo_t *fifo, uint8_t byte)
  *
  * \return 实际取出的数据
  */
-uint32_t fifo_get(fifo_t *fifo, uint8_t *buffer, uint32_t len)
+fifo_index_t fifo_get(fifo_t *fifo, uint8_t *buffer, fifo_index_t len)
 {
-    uint32_t l;
+    fifo_index_t l;
+    fifo_index_t out = fifo->out;
 
-    len = MIN(len, fifo->in - fifo->out);
-    l = MIN(len, fifo->size - (fifo->out & (fifo->size - 1)));
+    len = MIN(len, (fifo_index_t)(fifo->in - out));
+    l = MIN(len, fifo->size - (out & (fifo->size - 1)));
 
-    memcpy(buffer, fifo->buffer + (fifo->out & (fifo->size - 1)), l);
+    FIFO_BARRIER();
+    memcpy(buffer, fifo->buffer + (out & (fifo->size - 1)), l);
     memcpy(buffer + l, fifo->buffer, len - l);
 
-    fifo->out += len;
+    FIFO_BARRIER();
+    fifo->out = out + len;
 
     return len;
 }
@@ -158,18 +218,36 @@ uint32_t fifo_get(fifo_t *fifo, uint8_t *buffer, uint32_t len)
  */
 bool fifo_getc(fifo_t *fifo, uint8_t *byte)
 {
+    fifo_index_t out = fifo->out;
+
     // fifo为空
-    if (fifo->in == fifo->out)
+    if (fifo->in == out)
         return false;
 
-    *byte = *(fifo->buffer + (fifo->out & (fifo->size - 1)));
-    fifo->out++;
+    FIFO_BARRIER();
+    *byte = *(fifo->buffer + (out & (fifo->size - 1)));
+
+    FIFO_BARRIER();
+    fifo->out = out + 1;
 
     return true;
 }
 
 
 
+/**
+ * \brief  fifo中空闲的空间
+ *
+ * \param  fifo
+ *
+ * \return 还可以写入的字节数
+ */
+fifo_index_t fifo_free(fifo_t *fifo)
+{
+    return fifo->size - (fifo_index_t)(fifo->in - fifo->out);
+}
+
+
 /**
  * \brief  fifo is empty?
  *
@@ -188,7 +266,7 @@ bool fifo_is_empty(fifo_t *fifo)
  */
 bool fifo_is_full(fifo_t *fifo)
 {
-    return (fifo->out + fifo->size == fifo->in);
+    return ((fifo_index_t)(fifo->in - fifo->out) == fifo->size);
 }
 
 
@@ -40,18 +40,28 @@
 #include <stdbool.h>
 
 /* Exported types ------------------------------------------------------------*/
+// 读写偏移只增不减, 自然回绕, 取用时与(size - 1)相与
+// MSP430为16位内核, 16位的偏移可以一条指令读写完, 中断与主循环之间
+// 不会读到写了一半的值; 写入方只改in, 读出方只改out
+// TETRIS_FOOTPRINT时用8位偏移省RAM, 缓冲区最大128字节
+#ifdef TETRIS_FOOTPRINT
+typedef uint8_t fifo_index_t;
+#else
+typedef uint16_t fifo_index_t;
+#endif
+
 typedef struct
 {
-    uint8_t *buffer;        //!< 缓冲区指针
-    uint32_t size;          //!< 缓冲区大小
-    uint32_t in;            //!< 写偏移
-    uint32_t out;           //!< 读偏移
+    uint8_t *buffer;                //!< 缓冲区指针
+    fifo_index_t size;              //!< 缓冲区大小
+    volatile fifo_index_t in;       //!< 写偏移
+    volatile fifo_index_t out;      //!< 读偏移
 } fifo_t;
 
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 //! 创建一个名字为 FIFO_NAME 队列并初始化
-//! 注意FIFO_BUF_SIZE 必须为2的整数次幂
+//! 注意FIFO_BUF_SIZE 必须为2的整数次幂, 且不大于fifo_index_t范围的一半
  #define     CREATE_FIFO(FIFO_NAME, FIFO_BUF_SIZE)       \
      static uint8_t FIFO_NAME##_buf[FIFO_BUF_SIZE];      \
      static fifo_t FIFO_NAME = {                         \
@@ -61,14 +71,21 @@ typedef struct
 // fifo 初始化
 extern void fifo_init(fifo_t *fifo);
 // 向fifo 写入指定长度的数据
-extern uint32_t fifo_put(fifo_t *fifo, uint8_t *buffer, uint32_t len);
+extern fifo_index_t fifo_put(fifo_t *fifo, const uint8_t *buffer, fifo_index_t len);
 // 从fifo 读出指定长度的数据
-extern uint32_t fifo_get(fifo_t *fifo, uint8_t *buffer, uint32_t len);
+extern fifo_index_t fifo_get(fifo_t *fifo, uint8_t *buffer, fifo_index_t len);
 // 向fifo 写入一字节数据
 extern bool fifo_putc(fifo_t *fifo, uint8_t byte);
 // 从fifo 读出一字节数据
 extern bool fifo_getc(fifo_t *fifo, uint8_t *byte);
 
+// fifo中空闲的空间
+extern fifo_index_t fifo_free(fifo_t *fifo);
+// 取得一段连续的可写空间, 直接在其中写入数据后用fifo_commit()提交
+extern uint8_t *fifo_reserve(fifo_t *fifo, fifo_index_t *len);
+// 提交fifo_reserve()取得的空间中已写入的len字节
+extern void fifo_commit(fifo_t *fifo, fifo_index_t len);
+
 extern bool fifo_is_empty(fifo_t *fifo);
 extern bool fifo_is_full(fifo_t *fifo);
 
@@ -37,17 +37,13 @@
 #include "uart.h"
 
 /* Private typedef -----------------------------------------------------------*/
-/* Private define ------------------------------------------------------------*/
-/* Private macro -------------------------------------------------------------*/
-/* Private variables ---------------------------------------------------------*/
-/* Private function prototypes -----------------------------------------------*/
-/* Private functions ---------------------------------------------------------*/
-
-void key_init(void)
+typedef struct
 {
-    return;
-}
+    const char *seq;                // <ESC>之后的部分
+    key_t key;
+} key_seq_t;
 
+/* Private define ------------------------------------------------------------*/
 // up       : 0x1B, 0x5B, 0x41                  // <ESC>[A
 // down     : 0x1B, 0x5B, 0x42                  // <ESC>[B
 // right    : 0x1B, 0x5B, 0x43                  // <ESC>[C
@@ -72,85 +68,135 @@ void key_init(void)
 // F12      : 0x1B, 0x5B, 0x32, 0x34, 0x7E      // <ESC>[24~
 
 #define KEY_LEAD1           0x1B
-#define KEY_LEAD2           0x5B
-#define KEY_UP              0x41
-#define KEY_DOWN            0x42
-#define KEY_RIGHT           0x43
-#define KEY_LEFT            0x44
+#define KEY_SEQ_MAX         4       // <ESC>之后最长的序列, [11~
 
-#define KEY_WAIT_LEAD1      0x00
-#define KEY_WAIT_LEAD2      0x01
-#define KEY_STATE_VERIFY    0x02
+/* Private macro -------------------------------------------------------------*/
+#define KEY_SEQ_NUM         (sizeof(key_seq_table) / sizeof(key_seq_table[0]))
 
-key_t key_get(void)
+/* Private variables ---------------------------------------------------------*/
+// 上面列出的全部序列
+static const key_seq_t key_seq_table[] =
+{
+    { "[A",     key_up       },
+    { "[B",     key_down     },
+    { "[C",     key_right    },
+    { "[D",     key_left     },
+    { "[1~",    key_home     },
+    { "[2~",    key_insert   },
+    { "[3~",    key_delete   },
+    { "[4~",    key_end      },
+    { "[5~",    key_pageup   },
+    { "[6~",    key_pagedown },
+    { "[11~",   key_f1       },
+    { "[12~",   key_f2       },
+    { "[13~",   key_f3       },
+    { "[14~",   key_f4       },
+    { "[15~",   key_f5       },
+    { "[17~",   key_f6       },
+    { "[18~",   key_f7       },
+    { "[19~",   key_f8       },
+    { "[20~",   key_f9       },
+    { "[21~",   key_f10      },
+    { "[23~",   key_f11      },
+    { "[24~",   key_f12      },
+};
+
+static char seq[KEY_SEQ_MAX];       // 已收到的<ESC>之后的部分
+static uint8_t seq_len;
+static bool in_seq = false;         // 收到了<ESC>
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+void key_init(void)
 {
-    static uint8_t state;
-    uint8_t data = 0;
-    key_t key = key_null;
+    return;
+}
+
 
-    switch (state)
+/**
+ * \brief  将一个字节送入解码器
+ *
+ * \param  data
+ *
+ * \return 解出的按键, 序列还没结束或序列无效时返回key_null
+ */
+static key_t key_decode(uint8_t data)
+{
+    uint8_t i, j;
+    bool prefix = false;
+
+    if (!in_seq)
     {
-    case KEY_WAIT_LEAD1:
-        // 有键按下
-        if (uart_getc(&data))
-        {
-            // 非引导键, 直接返回键值
-            if (data != KEY_LEAD1)
-            {
-                key = (key_t)data;
-                break;
-            }
-            else
-            {
-                state = KEY_WAIT_LEAD2;
-            }
-        }
-        else
-        {
-            break;
-        }
-    case KEY_WAIT_LEAD2:
-        if (uart_getc(&data))
-        {
-            // 得到第二个引导码, 转下一状态
-            if (data == KEY_LEAD2)
-            {
-                state = KEY_STATE_VERIFY;
-            }
-            else
-            {
-                // 错误, 转第一状态
-                state = KEY_WAIT_LEAD1;
-                break;
-            }
-        }
-        else
-        {
-            // 无输入, 在本状态等候
-            break;
-        }
-    case KEY_STATE_VERIFY:
-        if (uart_getc(&data))
+        // 非引导键, 直接返回键值
+        if (data != KEY_LEAD1)
+            return (key_t)data;
+
+        in_seq = true;
+        seq_len = 0;
+        return key_null;
+    }
+
+    seq[seq_len++] = (char)data;
+
+    // 在表中查找以已收到部分开头的序列
+    for (i = 0; i < KEY_SEQ_NUM; i++)
+    {
+        for (j = 0; j < seq_len && key_seq_table[i].seq[j] == seq[j]; j++)
+            ;
+
+        if (j < seq_len)
+            continue;
+
+        // 完全匹配
+        if (key_seq_table[i].seq[j] == '\0')
         {
-            if (data == KEY_UP)
-                key = key_up;
-            else if (data == KEY_DOWN)
-                key = key_down;
-            else if (data == KEY_LEFT)
-                key = key_left;
-            else if (data == KEY_RIGHT)
-                key = key_right;
-            else
-                key = key_null;
-            state = KEY_WAIT_LEAD1;
+            in_seq = false;
+            return key_seq_table[i].key;
         }
-        break;
-    default:
-        break;
+
+        prefix = true;
     }
 
-    return key;
+    // 没有以此开头的序列, 丢弃
+    if (!prefix || seq_len >= KEY_SEQ_MAX)
+        in_seq = false;
+
+    return key_null;
 }
-/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
 
 
+/**
+ * \brief  取出一个按键
+ *         接收缓冲区中的字节会一直被解码, 直到得到一个完整的按键或缓冲区为空,
+ *         每次调用都循环到返回key_null就能取完本周期内收到的所有按键
+ *
+ * \return
+ */
+key_t key_get(void)
+{
+    uint8_t data;
+    key_t key;
+
+    while (uart_getc(&data))
+    {
+        key = key_decode(data);
+        if (key != key_null)
+            return key;
+    }
+
+    return key_null;
+}
+
+
+/**
+ * \brief  接收缓冲区满时丢掉的字节数, 按键来得太快时会增加
+ *
+ * \return
+ */
+uint16_t key_lost(void)
+{
+    return uart_rx_overflow();
+}
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -49,13 +49,34 @@ typedef enum
     key_down,
     key_left,
     key_right,
+    key_home,
+    key_insert,
+    key_delete,
+    key_end,
+    key_pageup,
+    key_pagedown,
+    key_f1,
+    key_f2,
+    key_f3,
+    key_f4,
+    key_f5,
+    key_f6,
+    key_f7,
+    key_f8,
+    key_f9,
+    key_f10,
+    key_f11,
+    key_f12,
 } key_t;
 
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 extern void key_init(void);
+// 取出一个按键, 没有完整的按键时返回key_null
 extern key_t key_get(void);
+// 接收缓冲区满而丢掉的字节数
+extern uint16_t key_lost(void);
 
 #endif
 /************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -33,17 +33,26 @@
   */
 
 /* Includes ------------------------------------------------------------------*/
-#include <MSP430.h>
+#include <msp430.h>
 #include <stdbool.h>
 #include <stdint.h>
-#include "tetris.h"
+#include "Tetris.h"
+#include "sched.h"
 #include "uart.h"
 #include "key.h"
 #include "ui.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+#define TIMER_COUNTS_PER_MS 2000        // SMCLK 16MHz / 8
+#define TIMER_CHUNK_MS      30          // 16位计数器32.7ms回绕, 一次最多定时30ms
+#define RENDER_RETRY_MS     6           // 发送缓冲区送出一半(64字节)约需5.6ms
+#define SLEEP_FOREVER       0           // 只由按键唤醒
+
 /* Private macro -------------------------------------------------------------*/
+// 方块下落周期(ms), 级别越高速度越快
+#define FALL_MS(level)      ((level) < 11 ? (12 - (level)) * 50 : 50)
+
 #define LED_INIT()          do {P1DIR |= BIT0; P1OUT &= ~BIT0;} while (0)
 #define LED_ON()            do {P1OUT |= BIT0; } while (0)
 #define LED_OFF()           do {P1OUT &= ~BIT0;} while (0)
@@ -51,16 +60,28 @@
                                 else P1OUT |= BIT0;} while (0)
 
 /* Private variables ---------------------------------------------------------*/
-static volatile uint16_t timer_count;
+// 毫秒时钟, clock_base是TAR等于clock_count时的时间
+static volatile sched_time_t clock_base = 0;
+static volatile uint16_t clock_count = 0;
+// 休眠到timer_deadline, timer_wait为false时只由按键唤醒
+static volatile sched_time_t timer_deadline = 0;
+static volatile bool timer_wait = false;
 
 static bool pause = false;          // 游戏暂停
+static bool refresh = false;        // 地图或分数有变化
 static uint8_t level = 1;           // 级别
 static uint16_t lines = 0;          // 消除的行数
 static uint16_t score = 0;          // 分数
-static uint16_t speed_count = 0;
 
 /* Private function prototypes -----------------------------------------------*/
 static void timer_init(void);
+static sched_time_t clock_ms(void);
+static void timer_sleep(sched_time_t delay);
+static void game_fall(sched_time_t now);
+
+CREATE_TIMER(fall_timer, game_fall);        // 方块下落
+CREATE_TIMER(render_timer, NULL);           // 发送缓冲区满时, 过一会儿继续输出
+
 /* Private functions ---------------------------------------------------------*/
 
 
@@ -69,6 +90,10 @@ void game_over(void)
 {
     ui_print_game_over();
 
+    // 游戏已经结束, 等待剩下的内容全部输出
+    while (!ui_flush())
+        timer_sleep(RENDER_RETRY_MS);
+
     return;
 }
 
@@ -103,6 +128,7 @@ void get_preview_brick(const void *info)
 }
 
 
+#ifndef TETRIS_FOOTPRINT
 /**
  * \brief  在地图上画一个box
  *
@@ -119,6 +145,7 @@ void draw_box(uint8_t x, uint8_t y, uint8_t color)
 
     return;
 }
+#endif
 
 
 /**
@@ -176,80 +203,160 @@ void game_pause(void)
     pause = !pause;
 
     if (pause)
+    {
+        sched_stop(&fall_timer);
         ui_print_game_pause();
+    }
     else
-        tetris_sync_all();      // 因为打印暂停破坏了地图区显示
+    {
+        sched_start(&fall_timer, clock_ms(), FALL_MS(level));
+        ui_redraw();            // 因为打印暂停破坏了地图区显示
                                 // 所以退出时要刷新整个地图区
+    }
+
     return;
 }
 
 
-void game_run(void)
+/**
+ * \brief  左右移动方块, 遇到阻挡时停止
+ *
+ * \param  shift 移动的格数, 右为正
+ */
+static void game_shift(int8_t shift)
 {
-    static bool refresh = false;
-
-    if (!pause)
-        speed_count++;
+    for (; shift < 0; shift++)
+    {
+        if (!tetris_move(dire_left))
+            break;
+    }
 
-    // 级别越高速度越快
-    if (speed_count >= (12 - level))
+    for (; shift > 0; shift--)
     {
-        speed_count = 0;
+        if (!tetris_move(dire_right))
+            break;
+    }
 
-        refresh = true;
+    return;
+}
+
+
+/**
+ * \brief  响应左右移动以外的按键
+ *
+ * \param  key
+ */
+static void game_key(key_t key)
+{
+    switch (key)
+    {
+    case key_up:
+        tetris_move(dire_rotate);
+        break;
+    case key_down:
         tetris_move(dire_down);
+        break;
+    case key_space:
+        while (tetris_move(dire_down));
+        break;
+    case key_enter:
+        game_pause();
+        break;
+    default:
+        break;
     }
 
-    key_t key = key_get();
-    if (key != key_null)
+    return;
+}
+
+
+/**
+ * \brief  下落定时器到期, 方块下移一格
+ *
+ * \param  now
+ */
+static void game_fall(sched_time_t now)
+{
+    refresh = true;
+    tetris_move(dire_down);
+
+    sched_start(&fall_timer, now, FALL_MS(level));
+
+    return;
+}
+
+
+/**
+ * \brief  每次唤醒后调用, 处理按键并输出变化
+ */
+void game_run(void)
+{
+    int8_t shift = 0;
+    key_t key;
+
+    // 每个周期取完接收缓冲区中所有的按键, 连续的同方向移动合并成一个次数
+    // 方向改变时先执行之前的移动, 左移被墙挡住后的右移仍然有效
+    while ((key = key_get()) != key_null)
     {
         // 暂停时只响应回车键
         if (pause && key != key_enter)
-            return;
+            continue;
 
         switch (key)
         {
-        case key_up:
-            tetris_move(dire_rotate);
-            break;
-        case key_down:
-            tetris_move(dire_down);
-            break;
         case key_left:
-            tetris_move(dire_left);
+            if (shift > 0)
+            {
+                game_shift(shift);
+                shift = 0;
+            }
+            shift--;
             break;
         case key_right:
-            tetris_move(dire_right);
-            break;
-        case key_space:
-            while (tetris_move(dire_down));
-            break;
-        case key_enter:
-            game_pause();
+            if (shift < 0)
+            {
+                game_shift(shift);
+                shift = 0;
+            }
+            shift++;
             break;
         default:
+            // 其它键之前的左右移动要先生效
+            game_shift(shift);
+            shift = 0;
+            game_key(key);
             break;
         }
 
         refresh = true;
     }
 
+    game_shift(shift);
+
     if (refresh)
     {
         refresh = !refresh;
         tetris_sync();
         // 更新行数, 分数等信息
         game_info_update();
-        ui_reset_cursor();
         LED_TRIGGER();
     }
 
+    // 只输出发送缓冲区放得下的部分, 剩下的下次继续, 不会等待发送
+    // 地图区(正在下落的方块)优先于分数等信息
+    if (ui_flush())
+        ui_reset_cursor();
+    else
+        sched_start(&render_timer, clock_ms(), RENDER_RETRY_MS);
+
     return;
 }
 
 
 int main(void)
 {
+    sched_time_t delay;
+
     WDTCTL = WDTPW + WDTHOLD;
 
     if (CALBC1_16MHZ == 0xFF)                   // If calibration constant erased
@@ -271,30 +378,35 @@ int main(void)
     __bis_SR_register(GIE);         // 开全局中断
 
     ui_init();
+#ifdef TETRIS_FOOTPRINT
+    // 地图区由ui.c直接与引擎的地图比较, 不需要画box的回调
+    tetris_init(NULL, &random_num, &get_preview_brick, &get_remove_line_num);
+#else
     tetris_init(&draw_box, &random_num, &get_preview_brick, &get_remove_line_num);
+#endif
+    ui_flush();
 
     game_pause();
 
-    while (1)
+    while (!tetris_is_game_over())
     {
-        if (!tetris_is_game_over())
-        {
-            if (timer_count > 50)
-            {
-                timer_count = 0;
-                game_run();
-            }
-        }
-        else
-        {
-            // XXX
-            game_over();
-            __bis_SR_register(LPM0_bits);       // Enter LPM0
-            while (1);
-        }
+        sched_run(clock_ms());
+        game_run();
+
+        // 休眠到下一个定时器到期或收到按键, 暂停时只等按键
+        if (!sched_next(clock_ms(), &delay))
+            timer_sleep(SLEEP_FOREVER);
+        else if (delay > 0)
+            timer_sleep(delay);
+    }
+
+    game_over();
 
+    // 停止定时器, 此后一直休眠
+    TACCTL0 = 0;
+    while (1)
         __bis_SR_register(LPM0_bits);       // Enter LPM0
-    }
+
     // return 0;
 }
 
@@ -302,27 +414,99 @@ int main(void)
 
 void timer_init(void)
 {
-    TACCR0 = 16000;
-    TACTL |= TASSEL_2 + MC_1;               // SMCLK, up mode->counts up to TACCR0
-    TACTL |= TAIE;                          // Enable interrupt
+    TACTL = TASSEL_2 + ID_3 + MC_2;         // SMCLK/8, continuous mode
+    TACCR0 = TIMER_CHUNK_MS * TIMER_COUNTS_PER_MS;
+    TACCTL0 = CCIE;
+
+    return;
+}
+
+
+/**
+ * \brief  按TAR推进毫秒时钟, 须在关中断时调用
+ */
+static void clock_sync(void)
+{
+    uint16_t ms = (uint16_t)(TAR - clock_count) / TIMER_COUNTS_PER_MS;
+
+    clock_base += ms;
+    clock_count += ms * TIMER_COUNTS_PER_MS;
+
+    return;
+}
+
+
+/**
+ * \brief  当前时间
+ *
+ * \return ms
+ */
+static sched_time_t clock_ms(void)
+{
+    sched_time_t now;
+
+    __disable_interrupt();
+    clock_sync();
+    now = clock_base;
+    __enable_interrupt();
+
+    return now;
+}
+
+
+/**
+ * \brief  设置下一次比较中断, 最远TIMER_CHUNK_MS, 保证TAR回绕前同步时钟
+ *         须在关中断时调用
+ */
+static void timer_arm(void)
+{
+    sched_time_t left = TIMER_CHUNK_MS;
+
+    if (timer_wait && (int16_t)(timer_deadline - clock_base) < TIMER_CHUNK_MS)
+        left = timer_deadline - clock_base;
+
+    TACCR0 = clock_count + left * TIMER_COUNTS_PER_MS;
 
     return;
 }
 
 
-#pragma vector=TIMER0_A1_VECTOR
+/**
+ * \brief  进入LPM0, 直到delay后或收到按键
+ *
+ * \param  delay ms, SLEEP_FOREVER时只由按键唤醒
+ */
+static void timer_sleep(sched_time_t delay)
+{
+    __disable_interrupt();
+    clock_sync();
+    timer_wait = (delay != SLEEP_FOREVER);
+    timer_deadline = clock_base + delay;
+    timer_arm();
+
+    // 关中断后再检查, 取完按键后到休眠前收到的按键不必等到定时器到期
+    if (uart_rx_ready())
+        __enable_interrupt();
+    else
+        __bis_SR_register(LPM0_bits + GIE);     // Enter LPM0
+
+    return;
+}
+
+
+// 只在到期时唤醒主循环, 中间每TIMER_CHUNK_MS进来一次同步时钟
+#pragma vector=TIMER0_A0_VECTOR
 __interrupt void Timer_A(void)
 {
-    switch(TA0IV)
+    clock_sync();
+
+    if (timer_wait && (int16_t)(timer_deadline - clock_base) <= 0)
     {
-    case 2: break;              // CCR1 not used
-    case 4: break;              // CCR2 not used
-    case 10:                    // overflow
-        timer_count++;
-        break;
+        timer_wait = false;
+        LPM0_EXIT;              // exit low power mode
     }
 
-    LPM0_EXIT;                  // exit low power mode
+    timer_arm();
 }
 
 
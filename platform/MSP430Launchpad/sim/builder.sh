@@ -0,0 +1,22 @@
+#!/bin/sh
+# 在主机上编译Launchpad的仿真程序和fifo的测试程序, 用法见sim.c, fifobench.c
+# 寄存器由本目录的msp430.h代替, Launchpad的main()改名为launchpad_main()
+# 可以用SIM_CFLAGS, SIM_LDFLAGS加入编译选项, 如SIM_CFLAGS=-DTETRIS_FOOTPRINT
+
+CFLAGS="-std=c99 -O2 -Wall -Wno-unknown-pragmas -I. -I.. -I../../../src $SIM_CFLAGS"
+
+gcc $CFLAGS -Dmain=launchpad_main -c ../main.c || exit 1
+gcc $CFLAGS -c ../ui.c || exit 1
+gcc $CFLAGS -D'TERM_WAIT()=sim_tx_wait()' -c ../term.c || exit 1
+gcc $CFLAGS -c ../key.c || exit 1
+gcc $CFLAGS -c ../uart.c || exit 1
+gcc $CFLAGS -c ../fifo.c || exit 1
+gcc $CFLAGS -c ../../../src/Tetris.c || exit 1
+gcc $CFLAGS -c ../../../src/cellfb.c || exit 1
+gcc $CFLAGS -c ../../../src/sched.c || exit 1
+gcc $CFLAGS -c sim.c || exit 1
+gcc $CFLAGS -c fifobench.c || exit 1
+gcc $SIM_LDFLAGS -o sim sim.o main.o ui.o term.o key.o uart.o fifo.o Tetris.o cellfb.o sched.o || exit 1
+gcc -o fifobench fifobench.o fifo.o || exit 1
+
+rm -f *.o
@@ -0,0 +1,238 @@
+/**
+  ******************************************************************************
+  * @file    fifobench.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   在主机上测量fifo.c的吞吐量并检查数据
+  * @note    写入方和读出方在一个线程中交替进行, 与主循环和串口中断的关系
+  *          相同. 每次写入和读出的长度随机, 偏移会反复回绕; 读出的每个字节
+  *          都与写入的序列比较. 分别测量fifo_put/fifo_get, fifo_putc/fifo_getc
+  *          和fifo_reserve/fifo_commit写入, 报告每秒的字节数.
+  *
+  *          用法: fifobench [-n 每种方式的MB数] [-s 种子]
+  *          以-DTETRIS_FOOTPRINT编译时测量8位偏移的版本.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fifo.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+    mode_block,                     // fifo_put / fifo_get
+    mode_byte,                      // fifo_putc / fifo_getc
+    mode_reserve,                   // fifo_reserve / fifo_commit, fifo_get
+    MODE_COUNT,
+} bench_mode_t;
+
+/* Private define ------------------------------------------------------------*/
+#define     FIFO_SIZE           128     // 与uart.c的发送缓冲区相同
+#define     CHUNK_MAX           48      // 一次写入或读出的最大长度
+
+/* Private macro -------------------------------------------------------------*/
+// 第i个字节的值, 周期不是2的幂, 偏移错位时一定能发现
+#define     DATA(i)             ((uint8_t)((i) % 251))
+
+/* Private variables ---------------------------------------------------------*/
+CREATE_FIFO(bench, FIFO_SIZE);
+
+static const char *const mode_name[MODE_COUNT] =
+{
+    "put/get", "putc/getc", "reserve/commit",
+};
+
+static uint32_t seed = 1;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+// 仿真程序以-std=c99编译, 用处理器时间计时
+static double clock_sec(void)
+{
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+
+static uint32_t xorshift(void)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    return seed;
+}
+
+
+/**
+ * \brief  写入最多len个字节
+ *
+ * \return 写入的字节数
+ */
+static fifo_index_t write_some(bench_mode_t mode, uint64_t next, fifo_index_t len)
+{
+    uint8_t buf[CHUNK_MAX], *p;
+    fifo_index_t i, k, n;
+
+    switch (mode)
+    {
+    case mode_block:
+        for (i = 0; i < len; i++)
+            buf[i] = DATA(next + i);
+        return fifo_put(&bench, buf, len);
+
+    case mode_byte:
+        for (i = 0; i < len && fifo_putc(&bench, DATA(next + i)); i++);
+        return i;
+
+    default:
+        // 可写空间在缓冲区末尾处断开, 分两次取得
+        for (n = 0; n < len; n += i)
+        {
+            p = fifo_reserve(&bench, &i);
+            if (i == 0)
+                break;
+            if (i > len - n)
+                i = len - n;
+            for (k = 0; k < i; k++)
+                p[k] = DATA(next + n + k);
+            fifo_commit(&bench, i);
+        }
+        return n;
+    }
+}
+
+
+/**
+ * \brief  读出最多len个字节并检查
+ *
+ * \return 读出的字节数, 数据错误时返回-1
+ */
+static int read_some(bench_mode_t mode, uint64_t next, fifo_index_t len)
+{
+    uint8_t buf[CHUNK_MAX];
+    fifo_index_t i, n;
+
+    if (mode == mode_byte)
+        for (n = 0; n < len && fifo_getc(&bench, &buf[n]); n++);
+    else
+        n = fifo_get(&bench, buf, len);
+
+    for (i = 0; i < n; i++)
+    {
+        if (buf[i] != DATA(next + i))
+            return -1;
+    }
+
+    return n;
+}
+
+
+/**
+ * \brief  用一种方式传送total字节
+ *
+ * \return 每秒字节数, 数据错误时返回负数
+ */
+static double run(bench_mode_t mode, uint64_t total)
+{
+    uint64_t written = 0, read = 0;
+    double start = clock_sec();
+    int n;
+
+    fifo_init(&bench);
+
+    while (read < total)
+    {
+        written += write_some(mode, written, (fifo_index_t)(1 + xorshift() % CHUNK_MAX));
+
+        n = read_some(mode, read, (fifo_index_t)(1 + xorshift() % CHUNK_MAX));
+        if (n < 0)
+        {
+            fprintf(stderr, "%s: wrong data after %llu bytes\n", mode_name[mode],
+                    (unsigned long long)read);
+            return -1;
+        }
+        read += (uint64_t)n;
+
+        // 写入的总是不少于读出的, fifo中的字节数不能超过容量
+        if (written - read > FIFO_SIZE)
+        {
+            fprintf(stderr, "%s: %llu bytes in a fifo of %u\n", mode_name[mode],
+                    (unsigned long long)(written - read), FIFO_SIZE);
+            return -1;
+        }
+    }
+
+    return read / (clock_sec() - start);
+}
+
+
+int main(int argc, char *argv[])
+{
+    unsigned long mb = 64;
+    double rate;
+    bench_mode_t mode;
+    int i;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "-n") == 0)
+            mb = strtoul(argv[i + 1], NULL, 0);
+        else if (strcmp(argv[i], "-s") == 0)
+            seed = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+        else
+            break;
+    }
+
+    if (i < argc || seed == 0 || mb == 0)
+    {
+        fprintf(stderr, "usage: %s [-n MB per mode] [-s seed]\n", argv[0]);
+        return 1;
+    }
+
+    printf("fifo of %u bytes, %u-bit offsets, %lu MB per mode\n", FIFO_SIZE,
+           (unsigned)sizeof(fifo_index_t) * 8, mb);
+
+    for (mode = 0; mode < MODE_COUNT; mode++)
+    {
+        rate = run(mode, (uint64_t)mb << 20);
+        if (rate < 0)
+            return 1;
+        printf("%-16s %10.1f MB/s, data checked\n", mode_name[mode], rate / 1048576);
+    }
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,81 @@
+#!/bin/sh
+# 省RAM配置(TETRIS_FOOTPRINT)的RAM/flash占用报告
+#
+# 用法: footprint.sh [map文件]
+# 不指定map文件时以TETRIS_FOOTPRINT编译仿真程序, 引擎状态超出预算时编译失败
+# (见Tetris.c中的STATIC_ASSERT), 然后统计链接map文件中每个变量和函数的大小.
+# 主机上指针为8字节, 目标上的真实大小要用msp430-elf-gcc以-fdata-sections
+# -ffunction-sections -Wl,-Map=xxx.map编译固件, 再把map文件交给本脚本.
+# 固件的RAM(.data + .bss)超出RAM_BUDGET(字节)时返回失败. 默认为512, 即G2553
+# 全部的RAM; 主机上的指针比目标上大, 主机报告超出时目标上也已经放不下栈.
+# 检查目标的map文件时应减去栈的大小, 如RAM_BUDGET=384.
+
+MAP=$1
+
+if [ -z "$MAP" ]; then
+    SIM_CFLAGS="-DTETRIS_FOOTPRINT -fdata-sections -ffunction-sections" \
+    SIM_LDFLAGS="-Wl,-Map=sim.map" ./builder.sh || exit 1
+    MAP=sim.map
+fi
+
+# GNU ld的map文件中, -fdata-sections产生的每个段单独一行:
+#  .bss.map_want  0x0000000000004040  0x28 main.o
+# 段名太长时地址和大小换到下一行. 只统计固件的目标文件.
+awk -v budget="${RAM_BUDGET:-512}" '
+function hex(s,    i, n) {
+    s = tolower(s)
+    sub(/^0x/, "", s)
+    n = 0
+    for (i = 1; i <= length(s); i++)
+        n = n * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1
+    return n
+}
+function firmware(f) {
+    sub(/.*[\/\\]/, "", f)
+    return f ~ /^(main|ui|term|key|uart|fifo|Tetris|cellfb|sched)\.(o|obj)$/
+}
+function record(sec, size, file,    kind, name) {
+    if (!firmware(file) || size == 0)
+        return
+    sub(/.*[\/\\]/, "", file)
+    kind = sec
+    sub(/^\./, "", kind)
+    sub(/\..*/, "", kind)
+    # 主机上带重定位的常量放在.data.rel.ro, 目标上它们在flash中
+    if (sec ~ /^\.data\.rel\.ro/)
+        kind = "rodata"
+    name = sec
+    sub(/^\.[a-z]+\.(rel\.)?(ro\.)?(local\.)?/, "", name)
+    if (kind == "bss" || kind == "data")
+        ram[file] += size
+    if (kind != "bss")
+        flash[file] += size
+    printf "%-6s %6d  %-10s %s\n", kind, size, file, name | "sort -s -k1,1 -k2,2nr"
+}
+/^ \.(bss|data|rodata|text)\./ {
+    if (NF >= 4) {
+        record($1, hex($3), $4)
+    } else {
+        sec = $1
+        getline
+        record(sec, hex($2), $3)
+    }
+}
+END {
+    close("sort -s -k1,1 -k2,2nr")
+    printf "\n%-10s %8s %8s\n", "object", "RAM", "flash"
+    for (f in ram)
+        seen[f] = 1
+    for (f in flash)
+        seen[f] = 1
+    for (f in seen) {
+        printf "%-10s %8d %8d\n", f, ram[f], flash[f]
+        total_ram += ram[f]
+        total_flash += flash[f]
+    }
+    printf "%-10s %8d %8d\n", "total", total_ram, total_flash
+    if (budget > 0 && total_ram > budget) {
+        printf "RAM %d bytes exceeds the budget of %d bytes\n", total_ram, budget
+        exit 1
+    }
+}' "$MAP"
@@ -0,0 +1,96 @@
+/**
+  ******************************************************************************
+  * @file    msp430.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   主机仿真用的寄存器替身, 只包含Launchpad代码用到的部分
+  * @note    寄存器是sim.c中的普通变量, 进入低功耗模式时由仿真推进时钟
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _SIM_MSP430_H_
+#define _SIM_MSP430_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+#define     BIT0                0x01
+#define     BIT1                0x02
+#define     BIT2                0x04
+#define     BIT4                0x10
+
+#define     WDTPW               0x5A00
+#define     WDTHOLD             0x0080
+
+#define     UCSWRST             0x01
+#define     UCSSEL_2            0x80
+#define     UCBRS_7             0x0E
+#define     UCA0RXIE            0x01
+#define     UCA0TXIE            0x02
+
+#define     TASSEL_2            0x0200
+#define     ID_3                0x00C0
+#define     MC_2                0x0020
+#define     CCIE                0x0010
+
+#define     GIE                 0x0008
+#define     LPM0_bits           0x0010
+
+/* Exported macro ------------------------------------------------------------*/
+#define     __interrupt
+#define     __bis_SR_register(x)    sim_bis_sr(x)
+#define     LPM0_EXIT               sim_lpm_exit()
+// 程序只在仿真推进时钟时被中断, 不需要真的关中断
+#define     __disable_interrupt()   ((void)0)
+#define     __enable_interrupt()    ((void)0)
+
+/* Exported variables --------------------------------------------------------*/
+extern volatile uint16_t WDTCTL;
+extern volatile uint8_t DCOCTL, BCSCTL1;
+extern const volatile uint8_t CALBC1_16MHZ, CALDCO_16MHZ;
+
+extern volatile uint8_t P1DIR, P1OUT, P1IN, P1SEL, P1SEL2;
+
+extern volatile uint8_t IE2;
+extern volatile uint8_t UCA0CTL1, UCA0BR0, UCA0BR1, UCA0MCTL;
+extern volatile uint8_t UCA0RXBUF, UCA0TXBUF;
+
+extern volatile uint16_t TAR, TACCR0, TACCTL0, TACTL;
+
+/* Exported functions ------------------------------------------------------- */
+// 置状态寄存器的位, 含LPM0_bits时进入低功耗, 直到有中断退出低功耗
+extern void sim_bis_sr(uint16_t bits);
+// 中断服务程序中退出低功耗
+extern void sim_lpm_exit(void);
+// term.c的TERM_WAIT(), 发送缓冲区满时推进时钟
+extern void sim_tx_wait(void);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,664 @@
+/**
+  ******************************************************************************
+  * @file    sim.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   在主机上运行Launchpad的代码, 测量串口输出
+  * @note    main.c, ui.c, term.c, key.c, uart.c, fifo.c原样编译, 只把寄存器
+  *          换成sim/msp430.h中的变量. 程序进入LPM0时由这里推进仿真时钟:
+  *          Timer_A以SMCLK/8(2MHz)连续计数, TAR到达TACCR0时进入比较中断,
+  *          发送中断按115200波特率每86.8us取走一个字节, 脚本中的按键按时间
+  *          送入接收中断. 程序本身的运行时间记为0.
+  *
+  *          一次唤醒中写入发送缓冲区的内容记为一帧, 统计:
+  *          每帧字节数, 发送缓冲区最高水位, 等待发送缓冲区的时间(term_write
+  *          中的TERM_WAIT()), 从唤醒到这一帧最后一个字节发送完的延迟,
+  *          以及每秒唤醒主循环和进入定时器中断的次数(功耗).
+  *
+  *          用法: sim [-f 脚本] [-s 种子] [-t 秒] [-o 输出文件]
+  *          脚本每行为 "毫秒 按键 [重复次数 间隔毫秒]", #开始的行为注释,
+  *          按键为 left, right, up, down, space, enter.
+  *          不指定脚本时由种子产生随机按键. -o把串口输出写入文件, 可以用
+  *          cat在终端中回放.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "msp430.h"
+#include "Tetris.h"
+#include "uart.h"
+#include "key.h"
+#include "ui.h"
+
+/* Private typedef -----------------------------------------------------------*/
+// 脚本中的一次按键
+typedef struct
+{
+    uint64_t time;          //!< ns
+    uint32_t order;         //!< 同一时刻的按键保持脚本中的顺序
+    const char *seq;        //!< 按键发出的字节
+} press_t;
+
+// 接收线上的一个字节
+typedef struct
+{
+    uint64_t time;
+    uint8_t byte;
+} rx_byte_t;
+
+// 一帧在发送缓冲区中的结束位置
+typedef struct
+{
+    uint32_t end;           //!< 到这一帧为止写入发送缓冲区的总字节数
+    uint64_t wake;          //!< 产生这一帧的唤醒时刻
+} frame_mark_t;
+
+/* Private define ------------------------------------------------------------*/
+#define     NS_PER_MS           1000000ULL
+#define     COUNT_NS            500ULL          // Timer_A计一个数, SMCLK/8
+#define     BYTE_NS             86806ULL        // 起始位 + 8位 + 停止位 @ 115200
+
+#define     PRESS_MAX           16384
+#define     RX_BYTE_MAX         (PRESS_MAX * 3)
+#define     FRAME_MARK_MAX      256             // 2的幂
+
+#define     DEFAULT_SECONDS     60
+#define     DEFAULT_INTERVAL    150             // 随机按键的平均间隔, ms
+
+#define     NEVER               UINT64_MAX
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+// 寄存器
+volatile uint16_t WDTCTL;
+volatile uint8_t DCOCTL, BCSCTL1;
+const volatile uint8_t CALBC1_16MHZ = 0x8F, CALDCO_16MHZ = 0x95;
+volatile uint8_t P1DIR, P1OUT, P1IN, P1SEL, P1SEL2;
+volatile uint8_t IE2;
+volatile uint8_t UCA0CTL1 = UCSWRST, UCA0BR0, UCA0BR1, UCA0MCTL;
+volatile uint8_t UCA0RXBUF, UCA0TXBUF;
+volatile uint16_t TAR, TACCR0, TACCTL0, TACTL;
+
+static const struct
+{
+    const char *name;
+    const char *seq;
+} key_names[] =
+{
+    {"left",  "\033[D"},
+    {"right", "\033[C"},
+    {"up",    "\033[A"},
+    {"down",  "\033[B"},
+    {"space", " "},
+    {"enter", "\r"},
+};
+
+static press_t press[PRESS_MAX];
+static uint32_t press_count = 0;
+static rx_byte_t rx[RX_BYTE_MAX];
+static uint32_t rx_count = 0, rx_next = 0;
+
+static uint32_t seed = 1;
+static uint64_t duration = DEFAULT_SECONDS * 1000 * NS_PER_MS;
+static FILE *wire = NULL;
+static jmp_buf sim_done;
+
+// 时钟
+static uint64_t now = 0;
+static uint64_t tx_idle_at = 0;         // 发送移位寄存器空闲的时刻
+static uint64_t wake_at = 0;            // 最近一次唤醒的时刻
+static bool lpm_exit = false;
+static bool in_game = false;            // 已完成初始化, 进入游戏循环
+
+// 统计
+static uint16_t tx_size = 0;
+static uint16_t tx_high = 0;
+static uint32_t sent = 0, enqueued = 0, init_bytes = 0;
+static uint32_t wakeups = 0, timer_irqs = 0;
+static uint32_t frames = 0, frame_bytes_max = 0;
+static uint64_t stall_init = 0, stall_game = 0;
+static frame_mark_t marks[FRAME_MARK_MAX];
+static uint32_t mark_in = 0, mark_out = 0;
+static uint32_t latency_count = 0;
+static uint64_t latency_total = 0, latency_max = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+extern int launchpad_main(void);
+extern void Timer_A(void);
+extern void USCI0RX_ISR(void);
+extern void USCI0TX_ISR(void);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  xorshift32, 随机按键由它产生, 同一种子结果相同
+ */
+static uint32_t sim_rand(void)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    return seed;
+}
+
+
+/**
+ * \brief  发送缓冲区中的字节数
+ */
+static uint16_t tx_used(void)
+{
+    return tx_size - uart_tx_free();
+}
+
+
+/**
+ * \brief  一个字节发送完成, 结算已经全部发出的帧
+ */
+static void frame_sent(void)
+{
+    uint64_t latency;
+
+    while (mark_out != mark_in && marks[mark_out].end <= sent)
+    {
+        latency = tx_idle_at - marks[mark_out].wake;
+        latency_total += latency;
+        if (latency > latency_max)
+            latency_max = latency;
+        latency_count++;
+        mark_out = (mark_out + 1) & (FRAME_MARK_MAX - 1);
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  记录自上次以来写入发送缓冲区的内容
+ */
+static void frame_end(void)
+{
+    uint32_t total = sent + tx_used();
+    uint32_t n = total - enqueued;
+
+    enqueued = total;
+    if (n == 0)
+        return;
+
+    frames++;
+    if (n > frame_bytes_max)
+        frame_bytes_max = n;
+
+    // 记录满时丢掉最早的一帧, 延迟统计只少一个样本
+    if (((mark_in + 1) & (FRAME_MARK_MAX - 1)) == mark_out)
+        mark_out = (mark_out + 1) & (FRAME_MARK_MAX - 1);
+    marks[mark_in].end = total;
+    marks[mark_in].wake = wake_at;
+    mark_in = (mark_in + 1) & (FRAME_MARK_MAX - 1);
+
+    return;
+}
+
+
+/**
+ * \brief  发送中断请求, 发送移位寄存器空闲时取走一个字节
+ */
+static void tx_interrupt(void)
+{
+    USCI0TX_ISR();
+
+    // 缓冲区已空, 中断程序关闭了发送中断
+    if (!(IE2 & UCA0TXIE))
+        return;
+
+    sent++;
+    tx_idle_at = now + BYTE_NS;
+    if (wire != NULL)
+        fputc(UCA0TXBUF, wire);
+
+    frame_sent();
+
+    return;
+}
+
+
+/**
+ * \brief  下一次比较中断的时刻
+ *
+ * \return 没有开中断时返回NEVER
+ */
+static uint64_t timer_compare_at(void)
+{
+    uint64_t count = now / COUNT_NS;
+    uint32_t ahead;
+
+    if (!(TACCTL0 & CCIE))
+        return NEVER;
+
+    // TAR在计到TACCR0时产生中断, 已经相等时要等下一圈
+    ahead = (uint16_t)(TACCR0 - (uint16_t)count);
+    if (ahead == 0)
+        ahead = 0x10000;
+
+    return (count + ahead) * COUNT_NS;
+}
+
+
+/**
+ * \brief  处理limit之前最早的一个事件, 没有事件时时钟走到limit
+ *
+ * \param  limit
+ */
+static void sim_step(uint64_t limit)
+{
+    enum {none, tick, tx, rx_in} event = none;
+    uint64_t t = limit;
+
+    if (timer_compare_at() <= t)
+    {
+        t = timer_compare_at();
+        event = tick;
+    }
+
+    if ((IE2 & UCA0TXIE) && (tx_idle_at > now ? tx_idle_at : now) < t)
+    {
+        t = (tx_idle_at > now) ? tx_idle_at : now;
+        event = tx;
+    }
+
+    if (rx_next < rx_count && rx[rx_next].time < t)
+    {
+        t = (rx[rx_next].time > now) ? rx[rx_next].time : now;
+        event = rx_in;
+    }
+
+    if (t > now)
+        now = t;
+    TAR = (uint16_t)(now / COUNT_NS);
+
+    switch (event)
+    {
+    case tick:
+        timer_irqs++;
+        Timer_A();
+        break;
+    case tx:
+        tx_interrupt();
+        break;
+    case rx_in:
+        UCA0RXBUF = rx[rx_next++].byte;
+        if (IE2 & UCA0RXIE)
+            USCI0RX_ISR();
+        break;
+    default:
+        break;
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  等待发送缓冲区中的内容全部发出
+ */
+static void sim_drain(void)
+{
+    while (IE2 & UCA0TXIE)
+        sim_step(NEVER);
+
+    return;
+}
+
+
+/**
+ * \brief  TERM_WAIT(), 发送缓冲区满时等待发送中断取走字节
+ */
+void sim_tx_wait(void)
+{
+    uint64_t start = now;
+
+    while (uart_tx_free() == 0)
+        sim_step(NEVER);
+
+    if (in_game)
+        stall_game += now - start;
+    else
+        stall_init += now - start;
+
+    return;
+}
+
+
+/**
+ * \brief  LPM0_EXIT
+ */
+void sim_lpm_exit(void)
+{
+    lpm_exit = true;
+
+    return;
+}
+
+
+/**
+ * \brief  __bis_SR_register(), 进入LPM0时运行到下一次退出低功耗的中断
+ *
+ * \param  bits
+ */
+void sim_bis_sr(uint16_t bits)
+{
+    // 第一次开全局中断时串口已初始化, 记下发送缓冲区的大小
+    if ((bits & GIE) && tx_size == 0)
+        tx_size = uart_tx_free();
+
+    if (!(bits & LPM0_bits))
+        return;
+
+    if (!in_game)
+    {
+        // 初始画面单独统计, 不算作一帧
+        in_game = true;
+        init_bytes = enqueued = sent + tx_used();
+    }
+
+    if (tx_used() > tx_high)
+        tx_high = tx_used();
+    frame_end();
+
+    if (now >= duration)
+        longjmp(sim_done, 1);
+
+    // 游戏结束画面已全部交给发送缓冲区, main()停止定时器后一直休眠
+    if (tetris_is_game_over() && !(TACCTL0 & CCIE))
+    {
+        sim_drain();
+        longjmp(sim_done, 1);
+    }
+
+    wakeups++;
+    lpm_exit = false;
+    while (!lpm_exit)
+        sim_step(NEVER);
+
+    wake_at = now;
+
+    return;
+}
+
+
+/**
+ * \brief  按键名对应的字节
+ *
+ * \param  name
+ *
+ * \return 不认识的按键返回NULL
+ */
+static const char *key_seq(const char *name)
+{
+    uint8_t i;
+
+    for (i = 0; i < sizeof(key_names) / sizeof(key_names[0]); i++)
+    {
+        if (strcmp(name, key_names[i].name) == 0)
+            return key_names[i].seq;
+    }
+
+    return NULL;
+}
+
+
+/**
+ * \brief  添加一次按键
+ *
+ * \param  ms
+ * \param  seq
+ */
+static void press_add(uint64_t ms, const char *seq)
+{
+    if (press_count >= PRESS_MAX || ms * NS_PER_MS >= duration)
+        return;
+
+    press[press_count].time = ms * NS_PER_MS;
+    press[press_count].order = press_count;
+    press[press_count].seq = seq;
+    press_count++;
+
+    return;
+}
+
+
+/**
+ * \brief  读入按键脚本
+ *
+ * \param  path
+ *
+ * \return 成功返回true
+ */
+static bool script_load(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char line[128], name[16];
+    unsigned long ms, count, interval;
+    unsigned long line_no = 0;
+    const char *seq;
+    int n;
+
+    if (f == NULL)
+    {
+        perror(path);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        line_no++;
+        if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0')
+            continue;
+
+        count = 1;
+        interval = 0;
+        n = sscanf(line, "%lu %15s %lu %lu", &ms, name, &count, &interval);
+        seq = (n >= 2) ? key_seq(name) : NULL;
+        if (seq == NULL)
+        {
+            fprintf(stderr, "%s:%lu: bad line\n", path, line_no);
+            fclose(f);
+            return false;
+        }
+
+        while (count-- > 0)
+        {
+            press_add(ms, seq);
+            ms += interval;
+        }
+    }
+
+    fclose(f);
+
+    return true;
+}
+
+
+/**
+ * \brief  没有脚本时产生随机按键, 先按回车退出开始时的暂停
+ */
+static void script_random(void)
+{
+    static const char *const pick[] =
+    {
+        "left", "left", "right", "right", "up", "up", "down", "space",
+    };
+    uint64_t ms = 100;
+
+    press_add(ms, key_seq("enter"));
+
+    while (ms * NS_PER_MS < duration && press_count < PRESS_MAX)
+    {
+        ms += 1 + sim_rand() % (2 * DEFAULT_INTERVAL);
+        press_add(ms, key_seq(pick[sim_rand() % (sizeof(pick) / sizeof(pick[0]))]));
+    }
+
+    return;
+}
+
+
+static int press_compare(const void *a, const void *b)
+{
+    const press_t *pa = a, *pb = b;
+
+    if (pa->time != pb->time)
+        return (pa->time < pb->time) ? -1 : 1;
+
+    return (pa->order < pb->order) ? -1 : 1;
+}
+
+
+/**
+ * \brief  按键排序后展开成接收线上的字节, 字节之间至少隔一个字节的时间
+ */
+static void rx_build(void)
+{
+    uint64_t t = 0;
+    const char *p;
+    uint32_t i;
+
+    qsort(press, press_count, sizeof(press[0]), press_compare);
+
+    for (i = 0; i < press_count; i++)
+    {
+        if (t < press[i].time)
+            t = press[i].time;
+
+        for (p = press[i].seq; *p != '\0' && rx_count < RX_BYTE_MAX; p++)
+        {
+            rx[rx_count].time = t;
+            rx[rx_count].byte = (uint8_t)*p;
+            rx_count++;
+            t += BYTE_NS;
+        }
+    }
+
+    return;
+}
+
+
+static double ms_of(uint64_t ns)
+{
+    return (double)ns / NS_PER_MS;
+}
+
+
+/**
+ * \brief  输出统计结果
+ */
+static void report(void)
+{
+    double seconds = (double)now / (1000 * NS_PER_MS);
+    uint32_t game_bytes = enqueued - init_bytes;
+
+    printf("simulated time        %10.3f s%s\n", seconds,
+           tetris_is_game_over() ? " (game over)" : "");
+    printf("keys pressed          %10lu (%lu bytes lost)\n",
+           (unsigned long)press_count, (unsigned long)key_lost());
+    printf("main loop wakeups     %10lu (%.1f /s)\n",
+           (unsigned long)wakeups, seconds > 0 ? wakeups / seconds : 0.0);
+    printf("timer interrupts      %10lu (%.1f /s)\n",
+           (unsigned long)timer_irqs, seconds > 0 ? timer_irqs / seconds : 0.0);
+    printf("initial screen        %10lu bytes, %.3f ms stalled\n",
+           (unsigned long)init_bytes, ms_of(stall_init));
+    printf("frames                %10lu\n", (unsigned long)frames);
+    printf("bytes per frame       %10.1f avg, %lu max\n",
+           frames ? (double)game_bytes / frames : 0.0,
+           (unsigned long)frame_bytes_max);
+    printf("wire throughput       %10.1f bytes/s (%.1f%% of 115200 baud)\n",
+           seconds > 0 ? sent / seconds : 0.0,
+           now ? 100.0 * sent * BYTE_NS / now : 0.0);
+    printf("tx fifo high-water    %10u / %u bytes\n", tx_high, tx_size);
+    printf("stalled in term_puts  %10.3f ms\n", ms_of(stall_game));
+    printf("frame-to-wire latency %10.3f ms avg, %.3f ms max\n",
+           latency_count ? ms_of(latency_total / latency_count) : 0.0,
+           ms_of(latency_max));
+
+    return;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *script = NULL;
+    int i;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "-f") == 0)
+            script = argv[i + 1];
+        else if (strcmp(argv[i], "-s") == 0)
+            seed = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+        else if (strcmp(argv[i], "-t") == 0)
+            duration = strtoull(argv[i + 1], NULL, 0) * 1000 * NS_PER_MS;
+        else if (strcmp(argv[i], "-o") == 0)
+            wire = fopen(argv[i + 1], "wb");
+        else
+            break;
+    }
+
+    if (i < argc || seed == 0)
+    {
+        fprintf(stderr, "usage: %s [-f script] [-s seed] [-t seconds] [-o wire.txt]\n", argv[0]);
+        return 1;
+    }
+
+    if (script != NULL)
+    {
+        if (!script_load(script))
+            return 1;
+    }
+    else
+    {
+        script_random();
+    }
+
+    rx_build();
+
+    if (setjmp(sim_done) == 0)
+        launchpad_main();
+
+    report();
+
+    if (wire != NULL)
+        fclose(wire);
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
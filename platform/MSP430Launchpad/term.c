@@ -33,21 +33,24 @@
   */
 
 /* Includes ------------------------------------------------------------------*/
-#include <string.h>             // strcpy()
 #include "term.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+#define     TERM_COLUMNS        80      // screen width
+#define     UNKNOWN             0       // cursor/color not known, e.g. after cls
+
 /* Private macro -------------------------------------------------------------*/
-#define     TERM_PUTC(c)        uart_putc(c)
+// called while spinning on a full uart tx fifo, the host simulation
+// (sim/) advances its clock here
+#ifndef TERM_WAIT
+#define     TERM_WAIT()
+#endif
 
 #define     RESET               0
 #define     CLEAR               1
 #define     SAVE_CURSOR         2
 #define     RESTORE_CURSOR      3
-#define     SET_FG_COLOR        4
-#define     SET_BG_COLOR        5
-#define     SET_COUSOR_POS      6
 
 /* Private variables ---------------------------------------------------------*/
 // foreground and background, default bg = black, fg = white
@@ -59,22 +62,164 @@ static const char *ctrl_set[] =
     "\033[2J",      // clear screen
     "\033[s",       // save cursor postion
     "\033[u",       // restore cursor
-    "\033[1;37m",   // foreground, bright white, 3x
-    "\033[1;40m",   // background, bright black, 4x
-    "\033[01;01H",  // cursor, x: 01, y:01
-                    // the position of home is (1, 1)
 };
 
+// What the terminal currently shows, so that redundant escapes can be
+// skipped. Home is (1, 1), so 0 marks an unknown position.
+static uint8_t cur_column = UNKNOWN, cur_row = UNKNOWN;
+static uint8_t saved_column = UNKNOWN, saved_row = UNKNOWN;
+// SGR state, defaults means unknown. bold is set once after a reset.
+static color_t cur_fg = defaults, cur_bg = defaults;
+static bool cur_bold = false;
+
+// escape sequences are built straight in the uart tx fifo, or here when
+// the free space there wraps around the end of the buffer
+static char seq_buf[TERM_SEQ_MAX];
+static char *seq_start;
+
 /* Private function prototypes -----------------------------------------------*/
+static void term_write(const char *str);
 /* Private functions ---------------------------------------------------------*/
 
+/**
+ * \brief  decimal digits of n
+ */
+static uint8_t dec_len(uint8_t n)
+{
+    return (n >= 100) ? 3 : ((n >= 10) ? 2 : 1);
+}
+
+/**
+ * \brief  append n in decimal, without leading zeros
+ *
+ * \return end of the string
+ */
+static char *dec_put(char *buf, uint8_t n)
+{
+    if (n >= 100)
+        *buf++ = n / 100 + '0';
+    if (n >= 10)
+        *buf++ = n / 10 % 10 + '0';
+    *buf++ = n % 10 + '0';
+
+    return buf;
+}
+
+/**
+ * \brief  append <ESC>[<n><cmd>, n == 1 is the default and is omitted
+ *
+ * \return end of the string
+ */
+static char *csi_put(char *buf, uint8_t n, char cmd)
+{
+    *buf++ = '\033';
+    *buf++ = '[';
+    if (n != 1)
+        buf = dec_put(buf, n);
+    *buf++ = cmd;
+
+    return buf;
+}
+
+/**
+ * \brief  length of csi_put(n)
+ */
+static uint8_t csi_len(uint8_t n)
+{
+    return (n == 1) ? 3 : 3 + dec_len(n);
+}
+
+/**
+ * \brief  write a string as is, the cursor and color state is kept
+ *         by the caller
+ */
+static void term_write(const char *str)
+{
+    uint8_t *p;
+    uint16_t len, n;
+
+    while (*str != '\0')
+    {
+        // 发送缓冲区满时在此等待, 游戏循环中的输出都先经过
+        // term_has_room()检查, 只有初始化画面时会在这里等待
+        p = uart_tx_reserve(&len);
+        if (len == 0)
+        {
+            TERM_WAIT();
+            continue;
+        }
+
+        for (n = 0; n < len && str[n] != '\0'; n++)
+            p[n] = str[n];
+
+        uart_tx_commit(n);
+        str += n;
+    }
+
+    return;
+}
+
+/**
+ * \brief  get room for an escape sequence of up to len bytes, in the
+ *         uart tx fifo when it has that much contiguous space
+ *
+ * \return where to build the sequence, finish with seq_commit()
+ */
+static char *seq_reserve(uint8_t len)
+{
+    uint16_t room;
+
+    seq_start = (char *)uart_tx_reserve(&room);
+    if (room < len)
+        seq_start = seq_buf;
+
+    return seq_start;
+}
+
+/**
+ * \brief  send the sequence built since seq_reserve()
+ *
+ * \param  end one past its last byte
+ */
+static void seq_commit(char *end)
+{
+    uint8_t i, len = (uint8_t)(end - seq_start);
+
+    if (seq_start != seq_buf)
+    {
+        uart_tx_commit(len);
+        return;
+    }
+
+    for (i = 0; i < len; i++)
+        while (!uart_putc(seq_buf[i]))
+            TERM_WAIT();
+
+    return;
+}
+
+/**
+ * \brief  forget the terminal state, the next cursor and color
+ *         settings are sent in full
+ */
+static void term_forget(void)
+{
+    cur_column = cur_row = UNKNOWN;
+    cur_fg = cur_bg = defaults;
+    cur_bold = false;
+
+    return;
+}
+
 /**
  * \brief  reset terminal
  */
 void term_reset(void)
 {
     // reset, command: <ESC>c
-    term_puts(ctrl_set[RESET]);
+    term_write(ctrl_set[RESET]);
+    term_forget();
+    cur_column = cur_row = 1;
 
     return;
 }
@@ -85,7 +230,9 @@ void term_reset(void)
  */
 void term_cls(void)
 {
-    term_puts(ctrl_set[CLEAR]);
+    term_write(ctrl_set[CLEAR]);
+    // not every terminal moves the cursor home on <ESC>[2J
+    cur_column = cur_row = UNKNOWN;
 
     return;
 }
@@ -106,8 +253,7 @@ void term_init(color_t foreground, color_t background)
     }
 
     term_reset();
-    term_set_foreground(color_fg);
-    term_set_background(color_bg);
+    term_set_color(color_fg, color_bg);
     term_cls();
 
     return;
@@ -115,27 +261,149 @@ void term_init(color_t foreground, color_t background)
 
 
 /**
- * \brief  Set cursor Position
+ * \brief  Set cursor Position, using whichever of an absolute or a
+ *         relative move is shorter. Nothing is sent when the cursor
+ *         is already there.
  *
  * \param  row
  * \param  column
  */
 void term_set_cursor(uint8_t column, uint8_t row)
 {
-    char buffer[9];
+    char *p;
+    uint8_t abs_len, rel_len, h_len, n;
 
-    // <ESC>[01;01H
-    strcpy(buffer, ctrl_set[SET_COUSOR_POS]);
-    buffer[2] = (row / 10 % 10 + '0');
-    buffer[3] = (row % 10 + '0');
-    buffer[5] = (column / 10 % 10 + '0');
-    buffer[6] = (column % 10 + '0');
-    term_puts((const char *)buffer);
+    if (column == cur_column && row == cur_row)
+        return;
+
+    // <ESC>[<row>;<column>H, row 1 and column 1 are the defaults
+    abs_len = 3 + ((row == 1) ? 0 : dec_len(row)) + ((column == 1) ? 0 : 1 + dec_len(column));
+
+    rel_len = 0xFF;
+    if (cur_row != UNKNOWN && cur_column != UNKNOWN)
+    {
+        // vertical: LF moves down one row only when going to column 1,
+        // a terminal that adds CR on LF then still ends up in the right
+        // place; <ESC>[nB / <ESC>[nA otherwise
+        if (row == cur_row)
+            rel_len = 0;
+        else if (row == cur_row + 1 && column == 1)
+            rel_len = 1;
+        else if (row > cur_row)
+            rel_len = csi_len(row - cur_row);
+        else
+            rel_len = csi_len(cur_row - row);
+
+        // horizontal: CR to column 1, BS per column or <ESC>[nD to the
+        // left, <ESC>[nC to the right
+        if (column == cur_column)
+            h_len = 0;
+        else if (column == 1)
+            h_len = 1;
+        else if (column > cur_column)
+            h_len = csi_len(column - cur_column);
+        else if (cur_column - column < csi_len(cur_column - column))
+            h_len = cur_column - column;
+        else
+            h_len = csi_len(cur_column - column);
+
+        rel_len += h_len;
+    }
+
+    p = seq_reserve(TERM_SEQ_MAX);
+
+    if (abs_len <= rel_len)
+    {
+        *p++ = '\033';
+        *p++ = '[';
+        if (row != 1)
+            p = dec_put(p, row);
+        if (column != 1)
+        {
+            *p++ = ';';
+            p = dec_put(p, column);
+        }
+        *p++ = 'H';
+    }
+    else
+    {
+        if (row == cur_row + 1 && column == 1)
+            *p++ = '\n';
+        else if (row > cur_row)
+            p = csi_put(p, row - cur_row, 'B');
+        else if (row < cur_row)
+            p = csi_put(p, cur_row - row, 'A');
+
+        if (column == cur_column)
+            ;
+        else if (column == 1)
+            *p++ = '\r';
+        else if (column > cur_column)
+            p = csi_put(p, column - cur_column, 'C');
+        else if (cur_column - column < csi_len(cur_column - column))
+            for (n = cur_column - column; n > 0; n--)
+                *p++ = '\b';
+        else
+            p = csi_put(p, cur_column - column, 'D');
+    }
+
+    seq_commit(p);
+    cur_column = column;
+    cur_row = row;
 
     return;
 }
 
 
+/**
+ * \brief  set foreground and background color in one sequence,
+ *         colors the terminal already uses are not sent again
+ *
+ * \param  foreground
+ * \param  background
+ */
+void term_set_color(color_t foreground, color_t background)
+{
+    char *p;
+
+    if (foreground == defaults || foreground == cur_fg)
+        foreground = defaults;
+    if (background == defaults || background == cur_bg)
+        background = defaults;
+
+    if (foreground == defaults && background == defaults)
+        return;
+
+    // <ESC>[1;3x;4xm
+    p = seq_reserve(TERM_SEQ_MAX);
+    *p++ = '\033';
+    *p++ = '[';
+    if (!cur_bold)
+    {
+        *p++ = '1';
+        *p++ = ';';
+        cur_bold = true;
+    }
+    if (foreground != defaults)
+    {
+        *p++ = '3';
+        *p++ = (uint8_t)foreground % 10 + '0';
+        cur_fg = foreground;
+    }
+    if (background != defaults)
+    {
+        if (p[-1] != ';' && p[-1] != '[')
+            *p++ = ';';
+        *p++ = '4';
+        *p++ = (uint8_t)background % 10 + '0';
+        cur_bg = background;
+    }
+    *p++ = 'm';
+
+    seq_commit(p);
+
+    return;
+}
 
 
 /**
@@ -145,17 +413,7 @@ void term_set_cursor(uint8_t column, uint8_t row)
  */
 void term_set_foreground(color_t color)
 {
-    char buffer[8];
-
-    if (color != defaults)
-    {
-        strcpy(buffer, ctrl_set[SET_FG_COLOR]);
-        // <ESC>[1;37m
-        //          ^
-        //         color
-        buffer[5] = (uint8_t)color % 10 + '0';
-        term_puts((const char *)buffer);
-    }
+    term_set_color(color, defaults);
 
     return;
 }
@@ -167,45 +425,55 @@ void term_set_foreground(color_t color)
  */
 void term_set_background(color_t color)
 {
-    char buffer[8];
-
-    if (color != defaults)
-    {
-        strcpy(buffer, ctrl_set[SET_BG_COLOR]);
-        buffer[5] = (uint8_t)color % 10 + '0';
-        term_puts((const char *)buffer);
-    }
+    term_set_color(defaults, color);
 
     return;
 }
 
 /**
- * \brief  put string
+ * \brief  put string, printable characters only
  *
- * \param  color color for string
  * \param  str
  */
 void term_puts(const char *str)
 {
-    while (*str != '\0')
-    {
-        // XXX
-        // 此处使用等待的方式发送, 数据量大时可能会在此处卡顿
-        // 待改进
-        while (!TERM_PUTC(*str));
-        str++;
-    }
+    uint8_t len = 0;
+
+    while (str[len] != '\0')
+        len++;
+
+    term_write(str);
+
+    // the cursor stays on the last column instead of wrapping
+    // on most terminals, so past it the position is unknown
+    if (cur_column != UNKNOWN && cur_column + len <= TERM_COLUMNS)
+        cur_column += len;
+    else
+        cur_column = cur_row = UNKNOWN;
 
     return;
 }
 
 
+/**
+ * \brief  can len bytes be sent without waiting for the uart?
+ *
+ * \param  len
+ */
+bool term_has_room(uint8_t len)
+{
+    return uart_tx_free() >= len;
+}
+
+
 /**
  * \brief  save current corsor postion
  */
 void term_save_cursor(void)
 {
-    term_puts(ctrl_set[SAVE_CURSOR]);
+    term_write(ctrl_set[SAVE_CURSOR]);
+    saved_column = cur_column;
+    saved_row = cur_row;
 
     return;
 }
@@ -216,11 +484,11 @@ void term_save_cursor(void)
  */
 void term_restore_cursor(void)
 {
-    term_puts(ctrl_set[RESTORE_CURSOR]);
+    term_write(ctrl_set[RESTORE_CURSOR]);
+    cur_column = saved_column;
+    cur_row = saved_row;
 
     return;
 }
 
 /************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
-
-
@@ -55,6 +55,9 @@ typedef enum
 } color_t;
 
 /* Exported constants --------------------------------------------------------*/
+// longest cursor move plus color change, <ESC>[24;80H<ESC>[1;37;40m
+#define     TERM_SEQ_MAX        18
+
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 
@@ -63,6 +66,8 @@ extern void term_init(color_t foreground, color_t background);
 extern void term_cls(void);
 // put string
 extern void term_puts(const char *str);
+// can len bytes be sent without waiting?
+extern bool term_has_room(uint8_t len);
 // save current cursor position
 extern void term_save_cursor(void);
 // restore cursor position after a Save Cursor
@@ -73,6 +78,8 @@ extern void term_set_cursor(uint8_t column, uint8_t row);
 extern void term_set_foreground(color_t color);
 // set background color
 extern void term_set_background(color_t color);
+// set foreground and background color, defaults leaves one unchanged
+extern void term_set_color(color_t foreground, color_t background);
 
 
 #endif
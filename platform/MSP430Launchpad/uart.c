@@ -47,6 +47,8 @@
 CREATE_FIFO(uart_tx_fifo, UART_TX_FIFO_SIZE);
 CREATE_FIFO(uart_rx_fifo, UART_RX_FIFO_SIZE);
 
+static volatile uint16_t rx_overflow = 0;  // 接收缓冲区满时丢掉的字节数
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
@@ -111,6 +113,30 @@ bool uart_getc(uint8_t *byte)
 
 
 
+/**
+ * @brief  接收缓冲区中是否有数据
+ *
+ * @return true/false
+ */
+bool uart_rx_ready(void)
+{
+    return !fifo_is_empty(&uart_rx_fifo);
+}
+
+
+
+/**
+ * @brief  接收缓冲区满而丢掉的字节数
+ *
+ * @return
+ */
+uint16_t uart_rx_overflow(void)
+{
+    return rx_overflow;
+}
+
+
+
 /**
  * @brief  发送一个字符串
  *
@@ -129,13 +155,63 @@ uint8_t uart_puts(uint8_t *str)
 }
 
 
+/**
+ * @brief  发送缓冲区的空闲空间
+ *
+ * @return 不需要等待就能发送的字节数
+ */
+uint16_t uart_tx_free(void)
+{
+    return (uint16_t)fifo_free(&uart_tx_fifo);
+}
+
+
+/**
+ * @brief  取得发送缓冲区中一段连续的空间
+ *
+ * @param  len 返回空间长度
+ *
+ * @return 空间起始地址
+ */
+uint8_t *uart_tx_reserve(uint16_t *len)
+{
+    fifo_index_t n;
+    uint8_t *p = fifo_reserve(&uart_tx_fifo, &n);
+
+    *len = n;
+
+    return p;
+}
+
+
+/**
+ * @brief  发送uart_tx_reserve()取得的空间中已写入的数据
+ *         一次提交只开一次发送中断
+ *
+ * @param  len 已写入的字节数
+ */
+void uart_tx_commit(uint16_t len)
+{
+    if (len == 0)
+        return;
+
+    fifo_commit(&uart_tx_fifo, len);
+    IE2 |= UCA0TXIE;
+
+    return;
+}
+
+
 //  Echo back RXed character, confirm TX buffer is ready first
 #pragma vector=USCIAB0RX_VECTOR
 __interrupt void USCI0RX_ISR(void)
 {
     // while (!(IFG2 & UCA0TXIFG));              // USCI_A0 TX buffer ready?
     // UCA0TXBUF = UCA0RXBUF;                    // TX -> RXed character
-    fifo_putc(&uart_rx_fifo, UCA0RXBUF);
+    if (!fifo_putc(&uart_rx_fifo, UCA0RXBUF))
+        rx_overflow++;
+
+    LPM0_EXIT;                  // 收到按键立即唤醒主循环
 }
 
 
@@ -48,6 +48,12 @@ extern void uart_init(void);        // 115200, n, 8, 1
 extern uint8_t uart_puts(uint8_t *str);
 extern bool uart_putc(char ch);
 extern bool uart_getc(uint8_t *byte);
+extern bool uart_rx_ready(void);
+extern uint16_t uart_rx_overflow(void);
+extern uint16_t uart_tx_free(void);
+// 取得发送缓冲区中一段连续的空间, 直接写入后用uart_tx_commit()发送
+extern uint8_t *uart_tx_reserve(uint16_t *len);
+extern void uart_tx_commit(uint16_t len);
 
 #endif
 /************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -33,7 +33,12 @@
   */
 
 /* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
 #include "ui.h"
+#include "cellfb.h"
+#ifdef TETRIS_FOOTPRINT
+#include "Tetris.h"
+#endif
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -59,9 +64,55 @@
 
 #define UI_TEXT_COLOR               red         // 文字颜色
 
+#define INFO_COLOR                  CELL_COLOR(UI_TEXT_COLOR, UI_BG_COLOR)
+
+#define MSG_START_COLUMN            22          // 暂停, 结束信息开始列
+#define MSG_WIDTH                   16          // 暂停, 结束信息宽度
+
+#define ROW_MASK                    0x03FF      // 地图一行10个box
+
 /* Private macro -------------------------------------------------------------*/
 #define RESET_CURSOR()              term_set_cursor(76, 24)
 /* Private variables ---------------------------------------------------------*/
+// 预览方块与分数等信息先写入帧缓冲, 刷新时只输出变化的单元
+CREATE_CELLFB(preview_fb, 4, 4, PREVIEW_START_COLUMN + 2, PREVIEW_START_ROW + 1, 2);
+CREATE_CELLFB(level_fb, 2, 1, 55, 13, 1);
+CREATE_CELLFB(line_fb, 3, 1, 54, 17, 1);
+CREATE_CELLFB(score_fb, 4, 1, 53, 21, 1);
+
+// 地图区每个box只有两种状态, 用位图记录, 每行一个uint16_t
+// map_want为tetris_sync()画出的内容, map_shown为终端上实际的内容
+// 发送缓冲区不够时只输出一部分, 剩下的下次ui_flush()时继续
+// TETRIS_FOOTPRINT时没有map_want, 直接与引擎的地图比较, 省去40字节
+#ifndef TETRIS_FOOTPRINT
+static uint16_t map_want[MAP_HEIGHT];
+#endif
+static uint16_t map_shown[MAP_HEIGHT];
+static uint32_t map_stale = 0;              // 被暂停等信息破坏了的行
+
+// 暂停, 结束信息, 每次输出一行
+static const char *const pause_msg[] =
+{
+    "                ",
+    "   < PAUSE >    ",
+    " Press ENTER to ",
+    "    continue    ",
+    "                ",
+    NULL,
+};
+
+static const char *const game_over_msg[] =
+{
+    "                ",
+    "   GAME  OVER   ",
+    "                ",
+    NULL,
+};
+
+static const char *const *msg = NULL;       // 正在显示的信息
+static uint8_t msg_row;                     // 信息第一行在终端上的行
+static uint8_t msg_next;                    // 下一个要输出的行
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
@@ -119,16 +170,11 @@ void ui_print_level(uint8_t level)
     uint8_t i;
 
     i = wtoa(level, level_buf);
-    term_save_cursor();
-    term_set_foreground(red);
-    term_set_background(UI_BG_COLOR);
-    term_set_cursor(55, 13);
+    // 前导0, 一共2位宽度
     if (i == 1)
-        term_puts("0");
+        cellfb_put(&level_fb, 0, 0, '0', INFO_COLOR);
 
-    // 消除警告
-    term_puts((const char *)level_buf);
-    term_restore_cursor();
+    cellfb_puts(&level_fb, 2 - i, 0, (const char *)level_buf, INFO_COLOR);
 
     return;
 }
@@ -145,17 +191,12 @@ void ui_print_line(uint16_t line)
     char lines_buf[6];
     uint8_t i, j;
 
-    term_save_cursor();
-    term_set_foreground(red);
-    term_set_background(UI_BG_COLOR);
-    term_set_cursor(54, 17);
     i = wtoa(line, lines_buf);
     // 前导0, 一共3位宽度
     for (j = 0; j < 3 - i; j++)
-        term_puts("0");
+        cellfb_put(&line_fb, j, 0, '0', INFO_COLOR);
 
-    term_puts((const char *)lines_buf);
-    term_restore_cursor();
+    cellfb_puts(&line_fb, j, 0, (const char *)lines_buf, INFO_COLOR);
 
     return;
 }
@@ -173,17 +214,12 @@ void ui_print_score(uint16_t score)
     char score_buf[6];
     uint8_t i, j;
 
-    term_save_cursor();
-    term_set_foreground(red);
-    term_set_background(UI_BG_COLOR);
-    term_set_cursor(53, 21);
     i = wtoa(score, score_buf);
     // 一共4位宽度, 输出前导0
     for (j = 0; j < 4 - i; j++)
-        term_puts("0");
+        cellfb_put(&score_fb, j, 0, '0', INFO_COLOR);
 
-    term_puts((const char *)score_buf);
-    term_restore_cursor();
+    cellfb_puts(&score_fb, j, 0, (const char *)score_buf, INFO_COLOR);
 
     return;
 }
@@ -196,37 +232,92 @@ void ui_print_score(uint16_t score)
  * \param  x
  * \param  y
  * \param  color
+ *
+ * \retval true 已输出
+ *         false 发送缓冲区不够, 没有输出
  */
-static void draw_box(uint8_t x, uint8_t y, color_t color)
+static bool draw_box(uint8_t x, uint8_t y, color_t color)
 {
+    if (!term_has_room(TERM_SEQ_MAX + 2))
+        return false;
+
     term_set_background(color);
     term_set_cursor(x, y);
     term_puts("  ");
 
-    return;
+    return true;
 }
 
 /**
- * \brief  在地图区域中画一个box
+ * \brief  在地图区域中画一个box, 实际输出在ui_flush()中
  *         原点位于左上角, 坐标为(0, 0)
  *
  * \param  x 地图x坐标
  * \param  y 地图y坐标
  * \param  box true时画一个box, false时擦除box
  */
+#ifndef TETRIS_FOOTPRINT
 void ui_draw_box(uint8_t x, uint8_t y, bool box)
 {
-    color_t c;
     if (box)
-        c = BLOCK_COLOR;
+        map_want[y] |= (0x0001 << x);
     else
-        c = MAP_BG_COLOR;
-    // 一个box为两个字符宽度
-    draw_box(x * 2 + MAP_START_COLUMN, y + MAP_START_ROW, c);
+        map_want[y] &= ~(0x0001 << x);
 
     return;
 }
+#endif
+
+
+/**
+ * \brief  输出地图区中与终端上不同的box
+ *
+ * \retval true 全部输出完成
+ *         false 发送缓冲区不够, 剩下的下次再输出
+ */
+static bool map_flush(void)
+{
+    uint8_t x, y;
+    uint16_t diff;
+    bool stale;
+#ifdef TETRIS_FOOTPRINT
+    // 引擎的地图包括正在下落的方块, 只在输出期间放在栈上
+    int16_t map_want[MAP_HEIGHT];
+
+    tetris_get_map(map_want);
+#endif
+
+    for (y = 0; y < MAP_HEIGHT; y++)
+    {
+        // 被破坏的行每个box都要重画, 没画完时下次从头再画
+        stale = (map_stale & ((uint32_t)1 << y)) != 0;
+        diff = stale ? ROW_MASK : (map_want[y] ^ map_shown[y]);
+
+        for (x = 0; diff != 0; x++, diff >>= 1)
+        {
+            if (!(diff & 0x0001))
+                continue;
+
+            // 一个box为两个字符宽度
+            if (!draw_box(x * 2 + MAP_START_COLUMN, y + MAP_START_ROW,
+                          (map_want[y] & (0x0001 << x)) ? BLOCK_COLOR : MAP_BG_COLOR))
+                return false;
+
+            map_shown[y] = (map_shown[y] & ~(0x0001 << x)) | (map_want[y] & (0x0001 << x));
+        }
+
+        map_stale &= ~((uint32_t)1 << y);
+    }
+
+    return true;
+}
 
+
+/**
+ * \brief  更新预览方块, 实际输出在ui_flush()中
+ *
+ * \param  brick
+ */
 void ui_print_preview(uint16_t brick)
 {
     uint8_t x, y;
@@ -238,36 +329,129 @@ void ui_print_preview(uint16_t brick)
         {
             bit = ((brick & (0x0001 << (15 - (y * 4 + x)))) >> (15 - (y * 4 + x)));
 
+            // 一个box占用两个字符宽度, 由preview_fb的单元宽度决定
             if (bit)
-                // 乘2是因为一个box占用两个字符宽度, 加2表示预览方块在预览区的偏移
-                draw_box(x * 2 + PREVIEW_START_COLUMN + 2, y + PREVIEW_START_ROW + 1, BLOCK_COLOR);
+                cellfb_put(&preview_fb, x, y, ' ', CELL_COLOR(UI_FG_COLOR, BLOCK_COLOR));
             else
-                draw_box(x * 2 + PREVIEW_START_COLUMN + 2, y + PREVIEW_START_ROW + 1, PREVIEW_BG_COLOR);
+                cellfb_put(&preview_fb, x, y, ' ', CELL_COLOR(UI_FG_COLOR, PREVIEW_BG_COLOR));
         }
     }
 
-    term_set_background(UI_BG_COLOR);
-    RESET_CURSOR();
+    return;
+}
+
+
+/**
+ * \brief  帧缓冲的输出函数, 输出同一行中的一段单元
+ *
+ * \param  fb
+ * \param  x
+ * \param  y
+ * \param  run
+ * \param  len
+ *
+ * \return 输出的单元数
+ */
+static uint8_t fb_emit(const cellfb_t *fb, uint8_t x, uint8_t y, const cell_t *run, uint8_t len)
+{
+    char str[2] = { 0, 0 };
+    uint8_t i, w;
+
+    for (i = 0; i < len; i++)
+    {
+        // 发送缓冲区不够, 剩下的单元下次再输出
+        if (!term_has_room(TERM_SEQ_MAX + fb->cell_width))
+            return i;
+
+        term_set_cursor(fb->column + (x + i) * fb->cell_width, fb->row + y);
+
+        // 颜色相同的相邻单元不必重复设置颜色, 与终端当前颜色相同时term也不会输出
+        if (i == 0 || run[i].color != run[i - 1].color)
+            term_set_color((color_t)CELL_FG(run[i].color), (color_t)CELL_BG(run[i].color));
+
+        str[0] = (char)run[i].glyph;
+        term_puts(str);
+        for (w = 1; w < fb->cell_width; w++)
+            term_puts(" ");
+    }
+
+    return len;
+}
+
+
+/**
+ * \brief  输出暂停, 结束信息中还没输出的行
+ *
+ * \retval true 全部输出完成
+ *         false 发送缓冲区不够, 剩下的下次再输出
+ */
+static bool msg_flush(void)
+{
+    while (msg[msg_next] != NULL)
+    {
+        if (!term_has_room(TERM_SEQ_MAX + MSG_WIDTH))
+            return false;
+
+        term_set_color(white, black);
+        term_set_cursor(MSG_START_COLUMN, msg_row + msg_next);
+        term_puts(msg[msg_next]);
+        msg_next++;
+    }
+
+    return true;
+}
+
+
+/**
+ * \brief  在发送缓冲区的空闲空间内输出变化的部分, 不会等待
+ *         优先级: 暂停/结束信息, 地图区(正在下落的方块), 预览方块, 分数等
+ *
+ * \retval true 全部输出完成
+ *         false 还有没输出的部分, 下次调用时继续
+ */
+bool ui_flush(void)
+{
+    if (msg != NULL)
+    {
+        if (!msg_flush())
+            return false;
+    }
+    // 显示暂停等信息时地图区被占用
+    else if (!map_flush())
+    {
+        return false;
+    }
+
+    if (!cellfb_flush(&preview_fb, fb_emit)
+        || !cellfb_flush(&level_fb, fb_emit)
+        || !cellfb_flush(&line_fb, fb_emit)
+        || !cellfb_flush(&score_fb, fb_emit))
+        return false;
+
+    return true;
+}
+
+
+/**
+ * \brief  暂停等信息破坏了地图区显示, 下次ui_flush()时重画整个地图区
+ */
+void ui_redraw(void)
+{
+    msg = NULL;
+    map_stale = ((uint32_t)1 << MAP_HEIGHT) - 1;
 
     return;
 }
 
 
 /**
- * \brief  输出游戏结束信息
+ * \brief  输出游戏结束信息, 实际输出在ui_flush()中
  */
 void ui_print_game_over(void)
 {
-    term_set_background(black);
-    term_set_foreground(white);
-
-    term_set_cursor(22, 11);
-    term_puts("                ");
-    term_set_cursor(22, 12);
-    term_puts("   GAME  OVER   ");
-    term_set_cursor(22, 13);
-    term_puts("                ");
-    RESET_CURSOR();
+    msg = game_over_msg;
+    msg_row = 11;
+    msg_next = 0;
 
     return;
 }
@@ -275,24 +459,13 @@ void ui_print_game_over(void)
 
 
 /**
- * \brief  输出暂停信息
+ * \brief  输出暂停信息, 实际输出在ui_flush()中
  */
 void ui_print_game_pause(void)
 {
-    term_set_background(black);
-    term_set_foreground(white);
-
-    term_set_cursor(22, 10);
-    term_puts("                ");
-    term_set_cursor(22, 11);
-    term_puts("   < PAUSE >    ");
-    term_set_cursor(22, 12);
-    term_puts(" Press ENTER to ");
-    term_set_cursor(22, 13);
-    term_puts("    continue    ");
-    term_set_cursor(22, 14);
-    term_puts("                ");
-    RESET_CURSOR();
+    msg = pause_msg;
+    msg_row = 10;
+    msg_next = 0;
 
     return;
 }
@@ -300,7 +473,8 @@ void ui_print_game_pause(void)
 
 void ui_reset_cursor(void)
 {
-    RESET_CURSOR();
+    if (term_has_room(TERM_SEQ_MAX))
+        RESET_CURSOR();
 
     return;
 }
@@ -369,9 +543,16 @@ void ui_init(void)
     term_set_cursor(55, 24);
     term_puts("http://www.DevLabs.cn");
 
+    // 与上面画出的画面同步, 初始的级别, 行数, 分数随后由ui_flush()输出
+    cellfb_init(&preview_fb, ' ', CELL_COLOR(UI_FG_COLOR, PREVIEW_BG_COLOR));
+    cellfb_init(&level_fb, ' ', INFO_COLOR);
+    cellfb_init(&line_fb, ' ', INFO_COLOR);
+    cellfb_init(&score_fb, ' ', INFO_COLOR);
+
     ui_print_level(1);
     ui_print_line(0);
     ui_print_score(0);
+    ui_flush();
 
     RESET_CURSOR();
 
@@ -45,7 +45,10 @@
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 extern void ui_init(void);
+#ifndef TETRIS_FOOTPRINT
+// TETRIS_FOOTPRINT时地图区直接从引擎读取, 不需要画box
 extern void ui_draw_box(uint8_t x, uint8_t y, bool box);
+#endif
 extern void ui_print_preview(uint16_t brick);
 extern void ui_print_level(uint8_t level);
 extern void ui_print_line(uint16_t line);
@@ -53,6 +56,10 @@ extern void ui_print_score(uint16_t score);
 extern void ui_print_game_over(void);
 extern void ui_print_game_pause(void);
 extern void ui_reset_cursor(void);
+// 在发送缓冲区的空闲空间内输出变化的部分, 全部输出完成时返回true
+extern bool ui_flush(void);
+// 暂停等信息破坏了地图区显示, 下次ui_flush()时重画整个地图区
+extern void ui_redraw(void);
 
 #endif
 /************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -1,9 +1,21 @@
 
-gcc -Idep -I..\..\src -c main.c
-gcc -Idep -c ui.c
+@rem set CFLAGS=-DRENDER_THREAD to draw from a separate render thread
+@rem set BOT=1 to let the bot play: Tab hands the game over, "tetris -demo" starts with the bot
+@set CFLAGS=
+@set BOT=
+@set BOTOBJ=
+
+@if defined BOT set CFLAGS=%CFLAGS% -DBOT_PLAY -I..\..\bot
+@if defined BOT set BOTOBJ=anytime.o bot.o place.o eval.o -lpthread
+
+gcc %CFLAGS% -Idep -I..\..\src -c main.c
+gcc %CFLAGS% -Idep -I..\..\src -c render.c
+gcc -Idep -I..\..\src -c ui.c
 gcc -Idep -c ..\..\src\tetris.c
+gcc -c ..\..\src\cellfb.c
 gcc -c dep\pcc32.c
-gcc -o tetris.exe pcc32.o ui.o tetris.o main.o
+@if defined BOT gcc -std=gnu99 -O2 -I..\..\src -c ..\..\bot\anytime.c ..\..\bot\bot.c ..\..\bot\place.c ..\..\bot\eval.c
+gcc -o tetris.exe pcc32.o ui.o render.o cellfb.o tetris.o main.o %BOTOBJ%
 
 @del *.o
 @pause
@@ -38,6 +38,14 @@
 #include <locale.h>
 #include "ui.h"
 #include "Tetris.h"
+#ifdef RENDER_THREAD
+#include "render.h"
+#endif
+#ifdef BOT_PLAY
+#include <string.h>
+#include <windows.h>
+#include "anytime.h"
+#endif
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -48,13 +56,48 @@ static uint8_t level = 1;           // 级别
 static uint16_t lines = 0;          // 消除的行数
 static uint16_t score = 0;          // 分数
 static uint16_t time_count = 0;
+#ifdef RENDER_THREAD
+static uint16_t preview = 0;        // 预览方块, 随帧一起发布
+#endif
+#ifdef BOT_PLAY
+static anytime_t bot;
+static bool bot_on = false;         // 由机器人玩, Tab键切换
+#endif
 
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
+#ifdef RENDER_THREAD
+/**
+ * \brief  将当前画面发布给渲染线程
+ */
+static void game_publish(void)
+{
+    frame_t *f = render_frame();
+
+    tetris_get_map(f->map);
+    f->preview = preview;
+    f->level = level;
+    f->lines = lines;
+    f->score = score;
+    f->pause = pause;
+    f->game_over = tetris_is_game_over();
+
+    render_publish();
+
+    return;
+}
+#endif
+
+
 void game_over(void)
 {
+#ifdef RENDER_THREAD
+    game_publish();
+    render_stop();
+#else
     ui_print_game_over();
+#endif
 
     return;
 }
@@ -84,7 +127,11 @@ void get_preview_brick(const void *info)
 {
     uint16_t dat = *((uint16_t *)info);
 
+#ifdef RENDER_THREAD
+    preview = dat;
+#else
     ui_print_preview(dat);
+#endif
 
     return;
 }
@@ -99,10 +146,17 @@ void get_preview_brick(const void *info)
  */
 void draw_box(uint8_t x, uint8_t y, uint8_t color)
 {
+#ifdef RENDER_THREAD
+    // 由渲染线程比较帧数据后画出, 这里什么也不做
+    (void)x;
+    (void)y;
+    (void)color;
+#else
     if (color == 0)
         ui_draw_box(x, y, false);
     else
         ui_draw_box(x, y, true);
+#endif
 
     return;
 }
@@ -160,11 +214,15 @@ void game_pause(void)
 {
     pause = !pause;
 
+#ifdef RENDER_THREAD
+    game_publish();
+#else
     if (pause)
         ui_print_game_pause();
     else
-        tetris_sync_all();      // 因为打印暂停破坏了地图区显示
+        ui_redraw();            // 因为打印暂停破坏了地图区显示
                                 // 所以退出时要刷新整个地图区
+#endif
     return;
 }
 
@@ -188,6 +246,21 @@ void game_run(void)
         tetris_move(dire_down);
     }
 
+#ifdef BOT_PLAY
+    // 机器人每帧最多执行几个动作, 搜索在后台线程中进行, 这里不会等待
+    if (bot_on && !pause && !tetris_is_game_over())
+    {
+        int16_t map[TETRIS_MAP_HEIGHT];
+        tetris_brick_t curr, next;
+
+        tetris_get_map(map);
+        tetris_get_brick(&curr, &next);
+        bot.bag = tetris_get_bag(&bot.types);
+        if (anytime_step(&bot, map, &curr, &next, GetTickCount(), tetris_move) > 0)
+            refresh = true;
+    }
+#endif
+
     if (kbhit())
     {
         key = jkGetKey();
@@ -216,6 +289,13 @@ void game_run(void)
         case JK_ENTER:
             game_pause();
             break;
+#ifdef BOT_PLAY
+        case JK_TAB:
+            // 交给机器人时从方块的当前位置重新搜索
+            bot_on = !bot_on;
+            anytime_reset(&bot);
+            break;
+#endif
         default:
             break;
         }
@@ -227,23 +307,49 @@ void game_run(void)
     if (refresh)
     {
         refresh = !refresh;
+#ifdef RENDER_THREAD
+        game_publish();
+#else
         tetris_sync();
         // 更新行数, 分数等信息
         game_info_update();
+        ui_flush();
+#endif
     }
 
     return;
 }
 
 
+#ifdef BOT_PLAY
+int main(int argc, char *argv[])
+#else
 int main(void)
+#endif
 {
     // 随机数种子
     srand((int32_t)time(NULL));
 
+#ifdef BOT_PLAY
+    // 预览后再看一个方块, 每秒最多10个动作
+    if (!anytime_init(&bot, bot_beam, 3, 32))
+        return 1;
+    // 演示模式: 一开始就由机器人玩
+    bot_on = (argc > 1 && strcmp(argv[1], "-demo") == 0);
+#endif
+
     ui_init();
+#ifdef RENDER_THREAD
+    render_init();
+#endif
     tetris_init(&draw_box, &random_num, &get_preview_brick, &get_remove_line_num);
+#ifndef RENDER_THREAD
+    ui_flush();
+#endif
 
+#ifdef BOT_PLAY
+    if (!bot_on)
+#endif
     game_pause();
 
     while (!tetris_is_game_over())
@@ -253,6 +359,10 @@ int main(void)
 
     game_over();
 
+#ifdef BOT_PLAY
+    anytime_free(&bot);
+#endif
+
     // 按回车退出
     while (getch() != 13);
 
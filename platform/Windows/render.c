@@ -0,0 +1,201 @@
+/**
+  ******************************************************************************
+  * @file    render.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   线程渲染
+  * @note    游戏逻辑每次刷新时把整帧数据(地图, 预览方块, 分数等)写入三缓冲
+  *          中属于自己的一块, 发布时与中间块交换; 渲染线程每次只取最新的
+  *          一帧写入UI的帧缓冲, 由帧缓冲只输出变化的部分.
+  *          这样游戏速度不再受控制台输出速度影响, 来不及画的中间帧被自动跳过.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <windows.h>
+#include "render.h"
+#include "ui.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define     FRAME_FRESH         0x04    // 中间块中有尚未被取走的新帧
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+// 三缓冲, 任意时刻每一块只属于写入方, 中间, 读取方三者之一
+static frame_t frame[3];
+static uint8_t frame_back = 0;              // 游戏逻辑正在写的块
+static volatile LONG frame_middle = 1;      // 中间块索引 | FRAME_FRESH
+static uint8_t frame_front = 2;             // 渲染线程正在读的块
+
+// 屏幕上当前显示的是否为暂停, 结束信息
+static bool shown_pause = false;
+static bool shown_game_over = false;
+
+static HANDLE render_wake = NULL;
+static HANDLE render_thread = NULL;
+static volatile LONG render_running = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  取走中间块中的新帧
+ *
+ * \retval true 取到新帧, 位于frame[frame_front]
+ *         false 自上次取走后没有新帧发布
+ */
+static bool frame_take(void)
+{
+    if (!(frame_middle & FRAME_FRESH))
+        return false;
+
+    frame_front = (uint8_t)(InterlockedExchange(&frame_middle, frame_front) & ~FRAME_FRESH);
+
+    return true;
+}
+
+
+/**
+ * \brief  画出一帧, 由UI的帧缓冲只输出与屏幕上不同的部分
+ *
+ * \param  f
+ */
+static void frame_draw(const frame_t *f)
+{
+    uint8_t x, y;
+
+    if (f->pause != shown_pause)
+    {
+        // 暂停信息破坏了地图区显示, 退出暂停时要重画
+        if (f->pause)
+            ui_print_game_pause();
+        else
+            ui_redraw();
+        shown_pause = f->pause;
+    }
+
+    for (y = 0; y < TETRIS_MAP_HEIGHT; y++)
+    {
+        for (x = 0; x < TETRIS_MAP_WIDTH; x++)
+            ui_draw_box(x, y, (f->map[y] >> x) & 0x0001);
+    }
+
+    ui_print_preview(f->preview);
+    ui_print_level(f->level);
+    ui_print_line(f->lines);
+    ui_print_score(f->score);
+    ui_flush();
+
+    if (f->game_over && !shown_game_over)
+    {
+        ui_print_game_over();
+        shown_game_over = true;
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  渲染线程, 有新帧发布时被唤醒
+ */
+static DWORD WINAPI render_loop(LPVOID arg)
+{
+    (void)arg;
+
+    while (1)
+    {
+        WaitForSingleObject(render_wake, INFINITE);
+
+        // 唤醒期间可能发布了多帧, 只画最新的一帧
+        while (frame_take())
+            frame_draw(&frame[frame_front]);
+
+        if (!render_running)
+            break;
+    }
+
+    return 0;
+}
+
+
+/**
+ * \brief  启动渲染线程
+ */
+void render_init(void)
+{
+    render_running = 1;
+    render_wake = CreateEvent(NULL, FALSE, FALSE, NULL);
+    render_thread = CreateThread(NULL, 0, render_loop, NULL, 0, NULL);
+
+    return;
+}
+
+
+/**
+ * \brief  取得游戏逻辑可写入的帧
+ *
+ * \return
+ */
+frame_t *render_frame(void)
+{
+    return &frame[frame_back];
+}
+
+
+/**
+ * \brief  发布一帧, 与中间块交换后通知渲染线程
+ *         若渲染线程还没取走上一帧, 上一帧直接被覆盖
+ */
+void render_publish(void)
+{
+    frame_back = (uint8_t)(InterlockedExchange(&frame_middle, frame_back | FRAME_FRESH) & ~FRAME_FRESH);
+    SetEvent(render_wake);
+
+    return;
+}
+
+
+/**
+ * \brief  画完最后发布的帧后结束渲染线程
+ */
+void render_stop(void)
+{
+    InterlockedExchange(&render_running, 0);
+    SetEvent(render_wake);
+    WaitForSingleObject(render_thread, INFINITE);
+
+    CloseHandle(render_thread);
+    CloseHandle(render_wake);
+
+    return;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
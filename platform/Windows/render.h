@@ -0,0 +1,69 @@
+/**
+  ******************************************************************************
+  * @file    render.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   线程渲染, 游戏逻辑与屏幕输出通过三缓冲交换数据
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _RENDER_H_
+#define _RENDER_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Tetris.h"
+
+/* Exported types ------------------------------------------------------------*/
+// 一帧画面所需的全部数据, 发布之后由渲染线程只读访问
+typedef struct
+{
+    int16_t map[TETRIS_MAP_HEIGHT];     //!< 地图(含正在下落的方块)
+    uint16_t preview;                   //!< 预览方块点阵
+    uint8_t level;                      //!< 级别
+    uint16_t lines;                     //!< 消除的行数
+    uint32_t score;                     //!< 分数
+    bool pause;                         //!< 暂停中
+    bool game_over;                     //!< 游戏结束
+} frame_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+// 启动渲染线程, 须在ui_init()之后调用
+extern void render_init(void);
+// 取得可写入的帧, 填好后调用render_publish()
+extern frame_t *render_frame(void);
+// 发布render_frame()取得的帧, 永不阻塞
+extern void render_publish(void);
+// 等待最后发布的帧画完, 然后结束渲染线程
+extern void render_stop(void);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
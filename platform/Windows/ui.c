@@ -39,7 +39,9 @@
   ******************************************************************************
   */
 
+#include <string.h>
 #include "UI.h"
+#include "cellfb.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -52,28 +54,98 @@
 #define     PREVIEW_START_COLUMN    28
 #define     PREVIEW_START_ROW       3
 
+#define     GLYPH_BOX               0x80    //!< Ԫеͼ: box
+#define     GLYPH_EMPTY             0x81    //!< Ԫеͼ: հbox
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+// UIÿһֶд֡, ui_flush()ֻ仯ĵԪ
+// һȫǵķռַλ
+CREATE_CELLFB(map_fb, MAP_WIDTH, MAP_HEIGHT, MAP_START_COLUMN, MAP_START_ROW, 2);
+CREATE_CELLFB(preview_fb, 4, 4, PREVIEW_START_COLUMN, PREVIEW_START_ROW, 2);
+CREATE_CELLFB(level_fb, 4, 1, 33, 10, 1);
+CREATE_CELLFB(line_fb, 4, 1, 33, 13, 1);
+CREATE_CELLFB(score_fb, 4, 1, 33, 16, 1);
+
+// ͼͣϢ, ʱͼ
+static bool overlay = false;
+
+// һboxԪַ, xԪΪbit x, һֻ1 << MAP_WIDTH
+// һõĳʱ, ֮һд, Ԫ
+// Ԥһмеǰ4Ԫ
+static char row_cache[1 << MAP_WIDTH][MAP_WIDTH * 2];
+static uint8_t row_cached[(1 << MAP_WIDTH) / 8];
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
 /**
- * \brief  ڴϻһbox, ϽΪ(0, 0)
+ * \brief  ȡһboxַ, ûʱ
  *
+ * \param  pattern xԪΪboxʱbit xΪ1
+ *
+ * \return MAP_WIDTH * 2ַ, '\0'
+ */
+static const char *row_string(uint16_t pattern)
+{
+    uint8_t x;
+
+    if (!(row_cached[pattern >> 3] & (1 << (pattern & 0x07))))
+    {
+        for (x = 0; x < MAP_WIDTH; x++)
+            memcpy(&row_cache[pattern][x * 2], ((pattern >> x) & 0x0001) ? "" : "", 2);
+
+        row_cached[pattern >> 3] |= 1 << (pattern & 0x07);
+    }
+
+    return row_cache[pattern];
+}
+
+
+/**
+ * \brief  ֡, ͬһеһεԪ
+ *
+ * \param  fb
  * \param  x
  * \param  y
- * \param  box true box, false box
+ * \param  run
+ * \param  len
+ *
+ * \return ĵԪ
  */
-static void draw_box(uint8_t x, uint8_t y, bool box)
+static uint8_t fb_emit(const cellfb_t *fb, uint8_t x, uint8_t y, const cell_t *run, uint8_t len)
 {
-    gotoTextPos(x, y);
+    uint16_t pattern = 0;
+    uint8_t i;
 
-    if (!box)
-        printf("");
-    else
-        printf("");
+    gotoTextPos(fb->column + x * fb->cell_width, fb->row + y);
 
-    return;
+    // ֻboxһ(ͼ, Ԥ)һд
+    for (i = 0; i < len && i < MAP_WIDTH; i++)
+    {
+        if (run[i].glyph == GLYPH_BOX)
+            pattern |= 0x0001 << i;
+        else if (run[i].glyph != GLYPH_EMPTY)
+            break;
+    }
+
+    if (i == len)
+    {
+        fwrite(row_string(pattern), 2, len, stdout);
+        return len;
+    }
+
+    for (i = 0; i < len; i++)
+    {
+        if (run[i].glyph == GLYPH_EMPTY)
+            printf("");
+        else if (run[i].glyph == GLYPH_BOX)
+            printf("");
+        else
+            putchar(run[i].glyph);
+    }
+
+    return len;
 }
 
 
@@ -86,7 +158,7 @@ static void draw_box(uint8_t x, uint8_t y, bool box)
 void ui_draw_box(uint8_t x, uint8_t y, bool box)
 {
     // ȫǵһռַλ
-    draw_box(x * 2 + MAP_START_COLUMN, y + MAP_START_ROW, box);
+    cellfb_put(&map_fb, x, y, box ? GLYPH_BOX : GLYPH_EMPTY, 0);
 
     return;
 }
@@ -100,8 +172,10 @@ void ui_draw_box(uint8_t x, uint8_t y, bool box)
  */
 void ui_print_score(uint32_t score)
 {
-    gotoTextPos(33, 16);
-    printf("%4d", score);
+    char buf[12];
+
+    sprintf(buf, "%4d", (int)score);
+    cellfb_puts(&score_fb, 0, 0, buf, 0);
 
     return;
 }
@@ -114,8 +188,10 @@ void ui_print_score(uint32_t score)
  */
 void ui_print_level(uint8_t level)
 {
-    gotoTextPos(33, 10);
-    printf("%4d", level);
+    char buf[12];
+
+    sprintf(buf, "%4d", level);
+    cellfb_puts(&level_fb, 0, 0, buf, 0);
 
     return;
 }
@@ -128,8 +204,10 @@ void ui_print_level(uint8_t level)
  */
 void ui_print_line(uint16_t line)
 {
-    gotoTextPos(33, 13);
-    printf("%4d", line);
+    char buf[12];
+
+    sprintf(buf, "%4d", line);
+    cellfb_puts(&line_fb, 0, 0, buf, 0);
 
     return;
 }
@@ -140,6 +218,8 @@ void ui_print_line(uint16_t line)
  */
 void ui_print_game_over(void)
 {
+    overlay = true;
+
     gotoTextPos(4, 9);
     printf("                ");
     gotoTextPos(4, 10);
@@ -167,7 +247,7 @@ void ui_print_preview(uint16_t brick)
         {
             bit = ((brick & (0x0001 << (15 - (y * 4 + x)))) >> (15 - (y * 4 + x)));
             // ȫǵһռַλ
-            draw_box(x * 2 + PREVIEW_START_COLUMN, y + PREVIEW_START_ROW, bit);
+            cellfb_put(&preview_fb, x, y, bit ? GLYPH_BOX : GLYPH_EMPTY, 0);
         }
     }
 
@@ -182,6 +262,8 @@ void ui_print_preview(uint16_t brick)
  */
 void ui_print_game_pause(void)
 {
+    overlay = true;
+
     gotoTextPos(4, 8);
     printf("                ");
     gotoTextPos(4, 9);
@@ -198,6 +280,39 @@ void ui_print_game_pause(void)
 
 
 
+/**
+ * \brief  б仯ĵԪ
+ */
+void ui_flush(void)
+{
+    if (!overlay)
+        cellfb_flush(&map_fb, fb_emit);
+    cellfb_flush(&preview_fb, fb_emit);
+    cellfb_flush(&level_fb, fb_emit);
+    cellfb_flush(&line_fb, fb_emit);
+    cellfb_flush(&score_fb, fb_emit);
+
+    return;
+}
+
+
+/**
+ * \brief  ͣϢƻĻʾ, ´ui_flush()ʱȫػ
+ */
+void ui_redraw(void)
+{
+    overlay = false;
+
+    cellfb_invalidate(&map_fb);
+    cellfb_invalidate(&preview_fb);
+    cellfb_invalidate(&level_fb);
+    cellfb_invalidate(&line_fb);
+    cellfb_invalidate(&score_fb);
+
+    return;
+}
+
+
 void ui_init(void)
 {
     fixConsoleSize(42, 22);
@@ -229,10 +344,18 @@ void ui_init(void)
     printf("              \n");
     printf("                ");
 
+    // 滭Ļͬ
+    cellfb_init(&map_fb, GLYPH_EMPTY, 0);
+    cellfb_init(&preview_fb, GLYPH_EMPTY, 0);
+    cellfb_init(&level_fb, ' ', 0);
+    cellfb_init(&line_fb, ' ', 0);
+    cellfb_init(&score_fb, ' ', 0);
+
     ui_print_line(0);
     ui_print_level(1);
     ui_print_score(0);
     ui_print_preview(0x0000);
+    ui_flush();
 
     return;
 }
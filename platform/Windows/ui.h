@@ -54,6 +54,10 @@ extern void ui_print_line(uint16_t line);
 extern void ui_print_score(uint32_t score);
 extern void ui_print_game_over(void);
 extern void ui_print_game_pause(void);
+// 输出所有变化的部分
+extern void ui_flush(void);
+// 暂停等信息破坏了屏幕显示, 下次ui_flush()时全部重画
+extern void ui_redraw(void);
 
 #endif
 /************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
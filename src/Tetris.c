@@ -10,6 +10,7 @@
   * Date           Author       Notes
   * 2014-11-15     ykaidong     the first version
   * 2014-11-27     ykaidon      更新接口
+  * 2026-10-19     ykaidong     可重入接口, 垃圾行
   *
   ******************************************************************************
   * @attention
@@ -34,29 +35,28 @@
   */
 
 /* Includes ------------------------------------------------------------------*/
-#include "tetris.h"
+#include "Tetris.h"
 
 /* Private typedef -----------------------------------------------------------*/
-typedef struct
-{
-    int8_t x;               //!< brick在地图中的x坐标
-    int8_t y;               //!< brick在地图中的y坐标
-    int8_t index;           //!< 方块索引, 高4位记录类型, 低4位记录变形
-    uint16_t brick;         //!< 方块数据
-} brick_t;
+typedef tetris_brick_state_t brick_t;
 
 /* Private define ------------------------------------------------------------*/
-#define BRICK_TYPE                  7   // 一共7种类型的方块
+#define BRICK_TYPE                  TETRIS_BRICK_TYPES  // 一共7种类型的方块
 #define BRICK_NUM_OF_TYPE           4   // 每一种类型有4种变形
 
 #define BRICK_HEIGHT                4   // 一个brick由4*4的box组成
 #define BRICK_WIDTH                 4
 
-#define MAP_WIDTH                   10  // 地图宽
-#define MAP_HEIGHT                  20  // 地图高
+#define MAP_WIDTH                   TETRIS_MAP_WIDTH    // 地图宽
+#define MAP_HEIGHT                  TETRIS_MAP_HEIGHT   // 地图高
 
 #define BRICK_START_X               ((MAP_WIDTH / 2) - (BRICK_WIDTH / 2))
 
+#define GARBAGE_ROW                 ((1 << MAP_WIDTH) - 1)  // 垃圾行去掉一列
+
+#define BAG_ON                      0x80    // 使用7-bag
+#define BAG_FULL                    ((1 << BRICK_TYPE) - 1)
+
 #ifndef NULL
     #define NULL    ((void *)0)
 #endif
@@ -67,8 +67,36 @@ typedef struct
 #define     CLR_BIT(dat, bit)      ((dat) &= ~(0x0001 << (bit)))
 #define     GET_BIT(dat, bit)      (((dat) & (0x0001 << (bit))) >> (bit))
 
+// 编译时检查, cond不成立时数组长度为负, 编译失败
+#define     STATIC_ASSERT(cond, name)   typedef char static_assert_##name[(cond) ? 1 : -1]
+
+// 方块数据, 以及变形后更新方块数据
+#ifdef TETRIS_FOOTPRINT
+    #define BRICK_DATA(b)           (brick_table[(b).index >> 4][(b).index & 0x0F])
+    #define BRICK_UPDATE(b)
+    #define MARK_ROW(t, row)        ((t)->dirty |= (uint32_t)1 << (row))
+#else
+    #define BRICK_DATA(b)           ((b).brick)
+    #define BRICK_UPDATE(b)         ((b).brick = brick_table[(b).index >> 4][(b).index & 0x0F])
+    #define MARK_ROW(t, row)
+#endif
+
+// 实例的回调函数表, TETRIS_FOOTPRINT时只有默认实例, 总是转接到tetris_init()给出的回调函数
+#ifdef TETRIS_FOOTPRINT
+    #define OPS(t)                  (&legacy_ops)
+#else
+    #define OPS(t)                  ((t)->ops)
+#endif
+
+// 调用实例的回调函数画一个box
+#define     DRAW_BOX(t, x, y, color)    do { if (OPS(t)->draw_box != NULL) \
+                                             OPS(t)->draw_box((t), (x), (y), (color)); } while (0)
+
 /* Private variables ---------------------------------------------------------*/
-// 回调函数指针, 用来在坐标(x, y)画一个brick
+// 默认实例, 不带实例参数的接口都作用于它
+static tetris_t state;
+
+// 默认实例的回调函数指针, 由legacy_ops转接, 用来在坐标(x, y)画一个brick
 static void (*draw_box)(uint8_t x, uint8_t y, uint8_t color) = NULL;
 // 回调函数指针, 获取一个随机数
 static uint8_t (*get_random_num)(void) = NULL;
@@ -77,9 +105,6 @@ static void (*return_next_brick_info)(const void *info) = NULL;
 // 回调函数指针, 当有消行时调用
 static void (*return_remove_line_num)(uint8_t line) = NULL;
 
-static bool is_game_over = false;
-
-
 // 为了preview brick显示美观, 将方块在4 * 4 的点阵中居中
 // 实际上这个是可以直接使用方块数据表的, 但要略做更改, 懒得再算表了
 static const uint16_t preview_brick_table[BRICK_TYPE] =
@@ -126,27 +151,103 @@ static const int8_t brick_start_y[BRICK_TYPE] =
     -2, -2, -3, -3, -4, -2, -2
 };
 
-// 地图数组
-// map[0]是地图的最上方
-static int16_t map[MAP_HEIGHT];
-// 地图备份, 保存上一次的数据, 解决屏幕闪烁问题
-static int16_t map_backup[MAP_HEIGHT];
-
-static brick_t curr_brick;              // 当前方块
-static brick_t next_brick;              // 下一个方块
+#ifdef TETRIS_FOOTPRINT
+// 实例的RAM预算(字节), 超出时编译失败, 见platform/MSP430Launchpad/sim/footprint.sh
+// 回调函数指针只有tetris_init()给出的4个, 与以前一样不计在内
+#define TETRIS_STATE_BUDGET         52
+STATIC_ASSERT(sizeof(tetris_t) <= TETRIS_STATE_BUDGET, tetris_state_budget);
+STATIC_ASSERT(sizeof(brick_t) == 3, tetris_brick_packed);
+#endif
 
 /* Private function prototypes -----------------------------------------------*/
+static void legacy_draw_box(tetris_t *t, uint8_t x, uint8_t y, uint8_t color);
+static uint8_t legacy_get_random(tetris_t *t);
+static void legacy_next_brick_info(tetris_t *t, const void *info);
+static void legacy_remove_line_num(tetris_t *t, uint8_t line);
+
+// 默认实例的回调函数表, 转接到tetris_init()给出的回调函数
+static const tetris_ops_t legacy_ops =
+{
+    legacy_draw_box,
+    legacy_get_random,
+    legacy_next_brick_info,
+    legacy_remove_line_num,
+};
+
+#ifndef TETRIS_FOOTPRINT
+// ops为NULL的实例使用的回调函数表
+static const tetris_ops_t no_ops = { NULL, NULL, NULL, NULL };
+#endif
+
 /* Private functions ---------------------------------------------------------*/
 
+#ifndef TETRIS_FOOTPRINT
+/**
+ * \brief  xorshift32, 实例没有get_random回调时使用
+ *
+ * \param  t
+ *
+ * \return
+ */
+static uint8_t internal_random(tetris_t *t)
+{
+    t->seed ^= t->seed << 13;
+    t->seed ^= t->seed >> 17;
+    t->seed ^= t->seed << 5;
+
+    return (uint8_t)(t->seed >> 24);
+}
+#endif
+
+
+/**
+ * \brief  取一个随机数
+ *
+ * \param  t
+ *
+ * \return
+ */
+static uint8_t next_random(tetris_t *t)
+{
+#ifdef TETRIS_FOOTPRINT
+    return legacy_get_random(t);
+#else
+    if (t->ops->get_random != NULL)
+        return t->ops->get_random(t);
+
+    return internal_random(t);
+#endif
+}
+
+
+
 /**
  * \brief  创建一个新的方块
  *
  * \return
  */
-static brick_t create_new_brick(void)
+static brick_t create_new_brick(tetris_t *t)
 {
     brick_t brick;
-    uint8_t bt = get_random_num() % BRICK_TYPE;
+    uint8_t bt, n;
+
+    if (t->bag & BAG_ON)
+    {
+        // 袋空了重新装满, 从袋中剩下的种类中随机取一个
+        if ((t->bag & BAG_FULL) == 0)
+            t->bag |= BAG_FULL;
+
+        for (bt = 0, n = 0; bt < BRICK_TYPE; bt++)
+            n += (t->bag >> bt) & 0x01;
+        n = next_random(t) % n;
+
+        for (bt = 0; !((t->bag >> bt) & 0x01) || n-- > 0; bt++);
+        t->bag &= ~(0x01 << bt);
+    }
+    else
+    {
+        bt = next_random(t) % BRICK_TYPE;
+    }
 
     // 初始坐标
     brick.x = BRICK_START_X;
@@ -154,7 +255,7 @@ static brick_t create_new_brick(void)
 
     // 记录种类
     brick.index = bt << 4;
-    brick.brick = brick_table[bt][0];
+    BRICK_UPDATE(brick);
 
     return brick;
 }
@@ -163,27 +264,41 @@ static brick_t create_new_brick(void)
 /**
  * \brief  将地图数组中的内容同步到屏幕, 只同步改变的部分
  */
-void tetris_sync(void)
+void tetris_sync_r(tetris_t *t)
 {
     uint8_t x, y;
 
+#ifdef TETRIS_FOOTPRINT
+    // 没有地图备份, 重画改变过的行, 由平台的显示缓存去掉没变的box
+    for (y = 0; y < MAP_HEIGHT; y++)
+    {
+        if (t->dirty & ((uint32_t)1 << y))
+        {
+            for (x = 0; x < MAP_WIDTH; x++)
+                DRAW_BOX(t, x, y, (uint8_t)GET_BIT(t->map[y], x));
+        }
+    }
+
+    t->dirty = 0;
+#else
     // 为了解决全图更新时屏幕闪烁的问题
     // 新增一个备份区, 每次只更新不一样的部分
     for (y = 0; y < MAP_HEIGHT; y++)
     {
         // 只更新不一样的部分
-        if (map[y] != map_backup[y])
+        if (t->map[y] != t->map_backup[y])
         {
             for (x = 0; x < MAP_WIDTH; x++)
             {
-                if (GET_BIT(map[y], x) != GET_BIT(map_backup[y], x))
-                    draw_box(x, y, (uint8_t)GET_BIT(map[y], x));
+                if (GET_BIT(t->map[y], x) != GET_BIT(t->map_backup[y], x))
+                    DRAW_BOX(t, x, y, (uint8_t)GET_BIT(t->map[y], x));
             }
         }
     }
 
     for (y = 0; y < MAP_HEIGHT; y++)
-        map_backup[y] = map[y];
+        t->map_backup[y] = t->map[y];
+#endif
 
     return;
 }
@@ -193,7 +308,7 @@ void tetris_sync(void)
 /**
  * \brief  同步所有
  */
-void tetris_sync_all(void)
+void tetris_sync_all_r(tetris_t *t)
 {
     uint8_t x, y;
 
@@ -201,31 +316,155 @@ void tetris_sync_all(void)
     {
         for (x = 0; x < MAP_WIDTH; x++)
         {
-            draw_box(x, y, (uint8_t)GET_BIT(map[y], x));
+            DRAW_BOX(t, x, y, (uint8_t)GET_BIT(t->map[y], x));
         }
     }
 
+#ifdef TETRIS_FOOTPRINT
+    t->dirty = 0;
+#endif
+
     return;
 }
 
 
 
+/**
+ * \brief  上次同步以后改变过的行, 与tetris_sync()使用相同的比较
+ *
+ * \return bit y为1表示第y行改变过
+ *         TETRIS_FOOTPRINT时为画过方块的行, 其中可能有内容没变的行
+ */
+uint32_t tetris_changed_rows_r(const tetris_t *t)
+{
+#ifdef TETRIS_FOOTPRINT
+    return t->dirty;
+#else
+    uint32_t rows = 0;
+    uint8_t y;
+
+    for (y = 0; y < MAP_HEIGHT; y++)
+    {
+        if (t->map[y] != t->map_backup[y])
+            rows |= (uint32_t)1 << y;
+    }
+
+    return rows;
+#endif
+}
+
+
+
+/**
+ * \brief  复制当前地图, 供不通过draw_box回调的显示方式使用(如线程渲染)
+ *
+ * \param  t
+ * \param  dest 目标缓存, 至少TETRIS_MAP_HEIGHT个元素
+ */
+void tetris_get_map_r(const tetris_t *t, int16_t *dest)
+{
+    uint8_t y;
+
+    for (y = 0; y < MAP_HEIGHT; y++)
+        dest[y] = t->map[y];
+
+    return;
+}
+
+
+
+/**
+ * \brief  导出方块信息
+ *
+ * \param  dest
+ * \param  brick
+ */
+static void export_brick(tetris_brick_t *dest, const brick_t brick)
+{
+    if (dest == NULL)
+        return;
+
+    dest->type = (uint8_t)brick.index >> 4;
+    dest->rotation = (uint8_t)brick.index & 0x0F;
+    dest->x = brick.x;
+    dest->y = brick.y;
+    dest->shape = BRICK_DATA(brick);
+
+    return;
+}
+
+
+/**
+ * \brief  取得当前方块和下一个方块
+ *
+ * \param  t
+ * \param  curr 可以为NULL
+ * \param  next 可以为NULL
+ */
+void tetris_get_brick_r(const tetris_t *t, tetris_brick_t *curr, tetris_brick_t *next)
+{
+    export_brick(curr, t->curr_brick);
+    export_brick(next, t->next_brick);
+
+    return;
+}
+
+
+
+/**
+ * \brief  取得方块刚出现时的数据, 出现后立即旋转时坐标不变
+ *
+ * \param  type     0 - 6
+ * \param  rotation 0 - 3
+ * \param  brick
+ */
+void tetris_brick_spawn(uint8_t type, uint8_t rotation, tetris_brick_t *brick)
+{
+    type %= BRICK_TYPE;
+    rotation %= BRICK_NUM_OF_TYPE;
+
+    brick->type = type;
+    brick->rotation = rotation;
+    brick->x = BRICK_START_X;
+    brick->y = brick_start_y[type];
+    brick->shape = brick_table[type][rotation];
+
+    return;
+}
+
+
+/**
+ * \brief  旋转到指定变形时检测的点阵
+ *
+ * \param  type
+ * \param  rotation 旋转后的变形
+ *
+ * \return
+ */
+uint16_t tetris_rotate_mask(uint8_t type, uint8_t rotation)
+{
+    return rotate_mask[type % BRICK_TYPE][rotation % BRICK_NUM_OF_TYPE];
+}
+
+
+
 /**
  * \brief  game over?
  *
  * \return
  */
-bool tetris_is_game_over(void)
+bool tetris_is_game_over_r(const tetris_t *t)
 {
-    return is_game_over;
+    return t->is_game_over;
 }
 
 /**
  * \brief  在地图数组中画指定方块
  *
+ * \param  t
  * \param  brick
  */
-static void draw_brick(const brick_t brick)
+static void draw_brick(tetris_t *t, const brick_t brick)
 {
     uint8_t box_x, box_y;
 
@@ -238,9 +477,10 @@ static void draw_brick(const brick_t brick)
             // 因为如果要调用此函数时已经经过冲突检测, 所以其它条件必然符合
             if (brick.y + box_y >= 0
                 // && brick.y < MAP_HEIGHT
-                && GET_BIT(brick.brick, 15 - (box_y * BRICK_WIDTH + box_x)))
+                && GET_BIT(BRICK_DATA(brick), 15 - (box_y * BRICK_WIDTH + box_x)))
             {
-                SET_BIT(map[box_y + brick.y], box_x + brick.x);
+                SET_BIT(t->map[box_y + brick.y], box_x + brick.x);
+                MARK_ROW(t, box_y + brick.y);
             }
         }
     }
@@ -254,9 +494,10 @@ static void draw_brick(const brick_t brick)
 /**
  * \brief  在方块数组中清除指定方块
  *
+ * \param  t
  * \param  brick
  */
-static void clear_brick(const brick_t brick)
+static void clear_brick(tetris_t *t, const brick_t brick)
 {
     uint8_t box_x, box_y;
 
@@ -267,9 +508,10 @@ static void clear_brick(const brick_t brick)
             // 保证在地图区域内
             if (brick.y + box_y >= 0
                 // && brick.y < MAP_HEIGHT
-                && GET_BIT(brick.brick, 15 - (box_y * BRICK_WIDTH + box_x)))
+                && GET_BIT(BRICK_DATA(brick), 15 - (box_y * BRICK_WIDTH + box_x)))
             {
-                CLR_BIT(map[box_y + brick.y], box_x + brick.x);
+                CLR_BIT(t->map[box_y + brick.y], box_x + brick.x);
+                MARK_ROW(t, box_y + brick.y);
             }
         }
     }
@@ -281,12 +523,14 @@ static void clear_brick(const brick_t brick)
 /**
  * \brief  冲突检测, 检测之前要将当前方块从地图数组中清掉.
  *
- * \param  dest 目标位
+ * \param  t
+ * \param  dest  目标位
+ * \param  shape 检测的点阵, 移动时为方块数据, 旋转时为旋转掩码
  *
  * \retval true 方块在目标位有冲突
  *         false 方块在目标位无冲突
  */
-static bool is_conflict(const brick_t dest)
+static bool is_conflict(const tetris_t *t, const brick_t dest, uint16_t shape)
 {
     int8_t box_y, box_x;
     bool exp = true;
@@ -296,7 +540,7 @@ static bool is_conflict(const brick_t dest)
         for (box_x = 0; box_x < BRICK_WIDTH; box_x++)
         {
             // 依次检测每一个box
-            if ((GET_BIT(dest.brick, (15 - (box_y * BRICK_WIDTH + box_x)))))
+            if ((GET_BIT(shape, (15 - (box_y * BRICK_WIDTH + box_x)))))
             {
                 // box在地图外的情况(只存在新方块刚被创建时)
                 // 这时不用检测地图部分(因为没在地图内)
@@ -313,7 +557,7 @@ static bool is_conflict(const brick_t dest)
                     exp = (((box_x + dest.x) > (MAP_WIDTH - 1))        // 右边界
                         || ((box_x + dest.x) < 0)                             // 左边界
                         || ((box_y + dest.y) > (MAP_HEIGHT - 1))    // 下边界
-                        || (GET_BIT(map[box_y + dest.y], (box_x + dest.x))));// 地图内
+                        || (GET_BIT(t->map[box_y + dest.y], (box_x + dest.x))));// 地图内
                 }
                 if (exp)
                     return true;
@@ -326,47 +570,82 @@ static bool is_conflict(const brick_t dest)
 
 
 /**
- * \brief
+ * \brief  开始新的一局, 回调函数已经设置好
  *
- * \param  draw_box_to_map
- * \param  get_random
- * \param  next_brick_info
- * \param  remove_line_num
+ * \param  t
  */
-void tetris_init(void (*draw_box_to_map)(uint8_t x, uint8_t y, uint8_t color),
-                 uint8_t (*get_random)(void),
-                 void (*next_brick_info)(const void *info),
-                 void (*remove_line_num)(uint8_t line))
+static void instance_start(tetris_t *t)
 {
     uint8_t i;
 
-    draw_box = draw_box_to_map;
-    get_random_num = get_random;
-    return_next_brick_info = next_brick_info;
-    return_remove_line_num = remove_line_num;
-    is_game_over = false;
+    t->is_game_over = false;
+    t->bag = 0;
 
     // 初始化地图
     for (i = 0; i < MAP_HEIGHT; i++)
-        map[i] = 0;
+    {
+        t->map[i] = 0;
+#ifndef TETRIS_FOOTPRINT
+        t->map_backup[i] = 0;
+#endif
+    }
 
-    curr_brick = create_new_brick();
-    next_brick = create_new_brick();
+    t->curr_brick = create_new_brick(t);
+    t->next_brick = create_new_brick(t);
 
     // 返回预览方块信息
-    if (return_next_brick_info != NULL)
-        return_next_brick_info(&preview_brick_table[next_brick.index >> 4]);
+    if (OPS(t)->next_brick_info != NULL)
+        OPS(t)->next_brick_info(t, &preview_brick_table[t->next_brick.index >> 4]);
+
+    draw_brick(t, t->curr_brick);
+    tetris_sync_all_r(t);
+
+    return;
+}
+
+
+#ifndef TETRIS_FOOTPRINT
+/**
+ * \brief  初始化一个实例
+ *
+ * \param  t
+ * \param  ops  回调函数表, 可以为NULL(不显示, 如机器人搜索, 服务器)
+ * \param  user 使用者的数据, 回调函数中由t->user取得
+ * \param  seed 内部随机数的种子, 只在ops->get_random为NULL时使用
+ */
+void tetris_init_r(tetris_t *t, const tetris_ops_t *ops, void *user, uint32_t seed)
+{
+    t->ops = (ops != NULL) ? ops : &no_ops;
+    t->user = user;
+    t->seed = (seed != 0) ? seed : 1;   // xorshift的状态不能为0
+
+    instance_start(t);
 
-    draw_brick(curr_brick);
-    tetris_sync_all();
+    return;
+}
+
+/**
+ * \brief  复制实例
+ *
+ * \param  dest
+ * \param  src
+ * \param  ops  副本的回调函数表, 可以为NULL
+ * \param  user 副本的使用者数据
+ */
+void tetris_copy_r(tetris_t *dest, const tetris_t *src, const tetris_ops_t *ops, void *user)
+{
+    *dest = *src;
+    dest->ops = (ops != NULL) ? ops : &no_ops;
+    dest->user = user;
 
     return;
 }
+#endif
 
 /**
  * \brief  消行
  */
-static void line_clear_check(void)
+static void line_clear_check(tetris_t *t)
 {
     uint8_t row, l;
 
@@ -378,22 +657,24 @@ static void line_clear_check(void)
     // 就以此开始替换
     for (row = 0; row < MAP_HEIGHT; row++)
     {
-        if (map[row] >= 0x3FF)
+        if (t->map[row] >= 0x3FF)
         {
             l++;
 
             uint8_t i;
             for (i = row; i > 0; i--)
             {
-                map[i] = map[i - 1];
+                t->map[i] = t->map[i - 1];
+                MARK_ROW(t, i);
             }
-            map[0] = 0;
+            t->map[0] = 0;
+            MARK_ROW(t, 0);
         }
     }
 
     // 有消行, 返回消行数
-    if (return_remove_line_num != NULL)
-        return_remove_line_num(l);
+    if (OPS(t)->remove_line_num != NULL)
+        OPS(t)->remove_line_num(t, l);
 
     return;
 }
@@ -403,14 +684,16 @@ static void line_clear_check(void)
 /**
  * \brief  移动方块
  *
+ * \param  t
  * \param  direction
  *
  * \retval true 移动失败
  *         false 移动成功
  */
-bool tetris_move(dire_t direction)
+bool tetris_move_r(tetris_t *t, dire_t direction)
 {
-    brick_t dest_brick = curr_brick;
+    brick_t dest_brick = t->curr_brick;
+    uint16_t shape;
     bool is_move = false;
 
     switch ((uint8_t)direction)
@@ -430,7 +713,6 @@ bool tetris_move(dire_t direction)
             uint8_t i = dest_brick.index & 0x0F;
             i++;
             dest_brick.index = (dest_brick.index & 0xF0) | (i % 4);
-            dest_brick.brick = rotate_mask[dest_brick.index >> 4][dest_brick.index & 0x0F];
 
             break;
         }
@@ -438,18 +720,24 @@ bool tetris_move(dire_t direction)
             break;
     }
 
+    // 旋转时检测旋转掩码, 保证旋转经过的位置也没有阻挡
+    if (direction == dire_rotate)
+        shape = rotate_mask[dest_brick.index >> 4][dest_brick.index & 0x0F];
+    else
+        shape = BRICK_DATA(dest_brick);
+
     // 在检测之前先将当前方块从地图中清掉
-    clear_brick(curr_brick);
+    clear_brick(t, t->curr_brick);
 
     // 无冲突, 更改之
-    if (!is_conflict(dest_brick))
+    if (!is_conflict(t, dest_brick, shape))
     {
-        // 旋转, 要方块信息从旋转mask改回来
+        // 旋转, 更新方块数据
         if (direction == dire_rotate)
         {
-            dest_brick.brick = brick_table[dest_brick.index >> 4][dest_brick.index & 0x0F];
+            BRICK_UPDATE(dest_brick);
         }
-        curr_brick = dest_brick;
+        t->curr_brick = dest_brick;
         is_move = true;
     }
     else
@@ -458,31 +746,276 @@ bool tetris_move(dire_t direction)
         if (direction == dire_down)
         {
             // 先将当前方块画到地图中
-            draw_brick(curr_brick);
+            draw_brick(t, t->curr_brick);
             // 如果下落完成时当前方块还有部分在地图外
             // 或者下一个方块无法再放进地图, 游戏结束
-            if (curr_brick.y + 1 <= 0)
+            if (t->curr_brick.y + 1 <= 0)
             {
-                is_game_over = true;
+                t->is_game_over = true;
             }
             // 消行
-            line_clear_check();
+            line_clear_check(t);
             // 产生新方块
-            curr_brick = next_brick;
-            next_brick = create_new_brick();
+            t->curr_brick = t->next_brick;
+            t->next_brick = create_new_brick(t);
             // 预览方块信息
-            if (return_next_brick_info != NULL)
-                return_next_brick_info(&preview_brick_table[next_brick.index >> 4]);
+            if (OPS(t)->next_brick_info != NULL)
+                OPS(t)->next_brick_info(t, &preview_brick_table[t->next_brick.index >> 4]);
         }
         is_move = false;
     }
 
-    draw_brick(curr_brick);
+    draw_brick(t, t->curr_brick);
 
     return is_move;
 }
 
 
+/**
+ * \brief  在地图底部加入垃圾行, 原有的内容向上推
+ *
+ * \param  t
+ * \param  rows 行数
+ * \param  hole 垃圾行中空的一列
+ */
+void tetris_add_garbage_r(tetris_t *t, uint8_t rows, uint8_t hole)
+{
+    uint8_t y;
+
+    if (rows == 0 || t->is_game_over)
+        return;
+
+    if (rows > MAP_HEIGHT)
+        rows = MAP_HEIGHT;
+
+    clear_brick(t, t->curr_brick);
+
+    // 被推出顶端的行中有box, 游戏结束
+    for (y = 0; y < rows; y++)
+    {
+        if (t->map[y] != 0)
+            t->is_game_over = true;
+    }
+
+    for (y = 0; y < MAP_HEIGHT - rows; y++)
+    {
+        t->map[y] = t->map[y + rows];
+        MARK_ROW(t, y);
+    }
+
+    for (; y < MAP_HEIGHT; y++)
+    {
+        t->map[y] = GARBAGE_ROW & ~(0x0001 << (hole % MAP_WIDTH));
+        MARK_ROW(t, y);
+    }
+
+    // 当前方块与推上来的内容重叠时向上移, 完全在地图上方时必然不重叠
+    while (is_conflict(t, t->curr_brick, BRICK_DATA(t->curr_brick)))
+        t->curr_brick.y--;
+
+    draw_brick(t, t->curr_brick);
+
+    return;
+}
+
+
+/**
+ * \brief  改用7-bag产生方块, 当前方块和下一个方块从袋中重新产生
+ *
+ * \param  t
+ */
+void tetris_use_bag_r(tetris_t *t)
+{
+    clear_brick(t, t->curr_brick);
+
+    t->bag = BAG_ON | BAG_FULL;
+    t->curr_brick = create_new_brick(t);
+    t->next_brick = create_new_brick(t);
+
+    if (OPS(t)->next_brick_info != NULL)
+        OPS(t)->next_brick_info(t, &preview_brick_table[t->next_brick.index >> 4]);
+
+    draw_brick(t, t->curr_brick);
+
+    return;
+}
+
+
+/**
+ * \brief  之后产生的方块可能的种类
+ *
+ * \param  t
+ * \param  types bit n为1表示可能是种类n
+ *
+ * \retval true  使用7-bag
+ *         false 没有使用7-bag, 每种都可能
+ */
+bool tetris_get_bag_r(const tetris_t *t, uint8_t *types)
+{
+    if (!(t->bag & BAG_ON))
+    {
+        *types = BAG_FULL;
+        return false;
+    }
+
+    // 袋空了时下一次先装满
+    *types = (t->bag & BAG_FULL) ? (t->bag & BAG_FULL) : BAG_FULL;
+
+    return true;
+}
+
+
+/**
+ * \brief  默认实例的回调函数转接
+ */
+static void legacy_draw_box(tetris_t *t, uint8_t x, uint8_t y, uint8_t color)
+{
+    (void)t;
+
+    if (draw_box != NULL)
+        draw_box(x, y, color);
+
+    return;
+}
+
+
+static uint8_t legacy_get_random(tetris_t *t)
+{
+    if (get_random_num != NULL)
+        return get_random_num();
+
+#ifdef TETRIS_FOOTPRINT
+    // 实例中没有随机数状态, get_random必须提供
+    (void)t;
+    return 0;
+#else
+    return internal_random(t);
+#endif
+}
+
+
+static void legacy_next_brick_info(tetris_t *t, const void *info)
+{
+    (void)t;
+
+    if (return_next_brick_info != NULL)
+        return_next_brick_info(info);
+
+    return;
+}
+
+
+static void legacy_remove_line_num(tetris_t *t, uint8_t line)
+{
+    (void)t;
+
+    if (return_remove_line_num != NULL)
+        return_remove_line_num(line);
+
+    return;
+}
+
+
+/**
+ * \brief  初始化默认实例
+ *
+ * \param  draw_box_to_map
+ * \param  get_random
+ * \param  next_brick_info
+ * \param  remove_line_num
+ */
+void tetris_init(void (*draw_box_to_map)(uint8_t x, uint8_t y, uint8_t color),
+                 uint8_t (*get_random)(void),
+                 void (*next_brick_info)(const void *info),
+                 void (*remove_line_num)(uint8_t line))
+{
+    draw_box = draw_box_to_map;
+    get_random_num = get_random;
+    return_next_brick_info = next_brick_info;
+    return_remove_line_num = remove_line_num;
+
+#ifdef TETRIS_FOOTPRINT
+    instance_start(&state);
+#else
+    tetris_init_r(&state, &legacy_ops, NULL, 1);
+#endif
+
+    return;
+}
+
+
+bool tetris_move(dire_t direction)
+{
+    return tetris_move_r(&state, direction);
+}
+
+
+void tetris_sync(void)
+{
+    tetris_sync_r(&state);
+
+    return;
+}
+
+
+void tetris_sync_all(void)
+{
+    tetris_sync_all_r(&state);
+
+    return;
+}
+
+
+bool tetris_is_game_over(void)
+{
+    return tetris_is_game_over_r(&state);
+}
+
+
+void tetris_get_map(int16_t *dest)
+{
+    tetris_get_map_r(&state, dest);
+
+    return;
+}
+
+
+uint32_t tetris_changed_rows(void)
+{
+    return tetris_changed_rows_r(&state);
+}
+
+
+void tetris_get_brick(tetris_brick_t *curr, tetris_brick_t *next)
+{
+    tetris_get_brick_r(&state, curr, next);
+
+    return;
+}
+
+
+void tetris_add_garbage(uint8_t rows, uint8_t hole)
+{
+    tetris_add_garbage_r(&state, rows, hole);
+
+    return;
+}
+
+
+void tetris_use_bag(void)
+{
+    tetris_use_bag_r(&state);
+
+    return;
+}
+
+
+bool tetris_get_bag(uint8_t *types)
+{
+    return tetris_get_bag_r(&state, types);
+}
+
+
 /************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
 
 
@@ -40,6 +40,11 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/* Exported constants --------------------------------------------------------*/
+#define TETRIS_MAP_WIDTH            10  // 地图宽
+#define TETRIS_MAP_HEIGHT           20  // 地图高
+#define TETRIS_BRICK_TYPES          7   // 方块的种类数
+
 /* Exported types ------------------------------------------------------------*/
 
 // direction
@@ -51,7 +56,67 @@ typedef enum
     dire_rotate,    //!< 旋转
 } dire_t;
 
-/* Exported constants --------------------------------------------------------*/
+// 方块的位置和形状, 供地图之外的观察者使用(如共享内存发布)
+typedef struct
+{
+    uint8_t type;           //!< 0 - 6, 依次为S, Z, L, J, I, O, T
+    uint8_t rotation;       //!< 0 - 3
+    int8_t x;               //!< 4 * 4点阵左上角在地图中的坐标, y可以为负
+    int8_t y;
+    uint16_t shape;         //!< 点阵, bit15为左上角, bit(15 - (row * 4 + col))
+} tetris_brick_t;
+
+// 引擎实例, 见下面的可重入接口
+typedef struct tetris tetris_t;
+
+// 实例的回调函数, 含义与tetris_init()的参数相同, 多了实例参数
+// 整个表和其中任何一项都可以为NULL, get_random为NULL时使用实例内部的随机数
+typedef struct
+{
+    void (*draw_box)(tetris_t *t, uint8_t x, uint8_t y, uint8_t color);
+    uint8_t (*get_random)(tetris_t *t);
+    void (*next_brick_info)(tetris_t *t, const void *info);
+    void (*remove_line_num)(tetris_t *t, uint8_t line);
+} tetris_ops_t;
+
+// 引擎内部的方块状态, 使用者请用tetris_get_brick()
+typedef struct
+{
+    int8_t x;               //!< brick在地图中的x坐标
+    int8_t y;               //!< brick在地图中的y坐标
+    int8_t index;           //!< 方块索引, 高4位记录类型, 低4位记录变形
+#ifndef TETRIS_FOOTPRINT
+    uint16_t brick;         //!< 方块数据, TETRIS_FOOTPRINT时每次由index查表
+#endif
+} tetris_brick_state_t;
+
+// 引擎实例的全部状态, 成员只由引擎访问; 实例可以整个复制, 如保存快照
+// 定义TETRIS_FOOTPRINT时为RAM很小的单片机省去地图备份(40字节),
+// 改为记录改变过的行, 方块数据也不再保存, 每次查表.
+// 这时只能使用默认实例, 回调函数只有tetris_init()给出的那些, 实例中
+// 没有随机数状态, ops和user, get_random必须提供
+struct tetris
+{
+    int16_t map[TETRIS_MAP_HEIGHT];             //!< 地图数组, map[0]是地图的最上方
+#ifdef TETRIS_FOOTPRINT
+    uint32_t dirty;                             //!< 上次同步以后改变过的行
+#else
+    int16_t map_backup[TETRIS_MAP_HEIGHT];      //!< 地图备份, 保存上一次的数据, 解决屏幕闪烁问题
+#endif
+#ifndef TETRIS_FOOTPRINT
+    uint32_t seed;                              //!< 内部随机数的状态
+#endif
+    tetris_brick_state_t curr_brick;            //!< 当前方块
+    tetris_brick_state_t next_brick;            //!< 下一个方块
+    bool is_game_over;
+    uint8_t bag;                                //!< 7-bag时bit7为1, bit0 - 6为袋中剩下的种类
+#ifndef TETRIS_FOOTPRINT
+    const tetris_ops_t *ops;                    //!< 回调函数
+    void *user;                                 //!< 使用者的数据, 引擎不使用
+#endif
+};
+
+
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 extern bool tetris_move(dire_t direction);
@@ -59,6 +124,23 @@ extern void tetris_sync(void);
 extern void tetris_sync_all(void);
 extern bool tetris_is_game_over(void);
 
+// 复制当前地图(包括正在下落的方块)到dest, dest至少要有TETRIS_MAP_HEIGHT个元素
+// 每个元素的bit0 - bit9对应一行中x = 0 - 9的box, dest[0]是地图的最上方
+extern void tetris_get_map(int16_t *dest);
+
+// 上次tetris_sync()以后改变过的行, bit y为1表示第y行(map[y])改变过
+// 要在tetris_sync()之前调用, 同步之后所有行都算作没变
+extern uint32_t tetris_changed_rows(void);
+
+// 当前方块和下一个方块, 下一个方块的坐标为出现时的坐标, 不需要的参数可以为NULL
+extern void tetris_get_brick(tetris_brick_t *curr, tetris_brick_t *next);
+
+// 方块数据, 供在引擎之外模拟移动的使用者(如机器人)
+// type类型, rotation变形的方块在刚出现时的坐标和点阵, 与tetris_get_brick()的格式相同
+extern void tetris_brick_spawn(uint8_t type, uint8_t rotation, tetris_brick_t *brick);
+// 旋转到rotation变形时检测的点阵, 包括旋转经过的位置, 坐标与方块相同
+extern uint16_t tetris_rotate_mask(uint8_t type, uint8_t rotation);
+
 // 初始化, 需要的回调函数说明:
 // 在(x, y)画一个box, color为颜色, 注意0表示清除, 不表示任何颜色
 // draw_box_to_map(uint8_t x, uint8_t y, uint8_t color)
@@ -78,6 +160,40 @@ extern void tetris_init(
     void (*next_brick_info)(const void *info),
     void (*remove_line_num)(uint8_t line)
     );
+
+// 在地图底部加入rows行垃圾行, 每行只有hole列为空, 原有的内容被向上推
+// 被推出顶端的行中有box时游戏结束, 当前方块与垃圾行重叠时向上移
+extern void tetris_add_garbage(uint8_t rows, uint8_t hole);
+
+// 改用7-bag产生方块: 每7个方块中7种各出现一次, 要在初始化之后立即调用,
+// 当前方块和下一个方块从袋中重新产生
+extern void tetris_use_bag(void);
+// 之后产生的方块可能的种类, bit n为1表示种类n; 使用7-bag时返回true
+// 没有使用7-bag时每种都可能
+extern bool tetris_get_bag(uint8_t *types);
+
+// 可重入接口, 每个实例互不影响, 可以在多个线程中各自使用不同的实例
+// 上面的函数都是对一个默认实例调用这些函数
+// seed为内部随机数的种子, 只在ops->get_random为NULL时使用
+// TETRIS_FOOTPRINT时实例中没有ops和user, 没有tetris_init_r()和tetris_copy_r()
+#ifndef TETRIS_FOOTPRINT
+extern void tetris_init_r(tetris_t *t, const tetris_ops_t *ops, void *user, uint32_t seed);
+#endif
+extern bool tetris_move_r(tetris_t *t, dire_t direction);
+extern void tetris_sync_r(tetris_t *t);
+extern void tetris_sync_all_r(tetris_t *t);
+extern bool tetris_is_game_over_r(const tetris_t *t);
+extern void tetris_get_map_r(const tetris_t *t, int16_t *dest);
+extern uint32_t tetris_changed_rows_r(const tetris_t *t);
+extern void tetris_get_brick_r(const tetris_t *t, tetris_brick_t *curr, tetris_brick_t *next);
+extern void tetris_add_garbage_r(tetris_t *t, uint8_t rows, uint8_t hole);
+extern void tetris_use_bag_r(tetris_t *t);
+extern bool tetris_get_bag_r(const tetris_t *t, uint8_t *types);
+// 复制实例(快照), 副本使用ops和user, 随机数状态等其它状态与src相同
+// 可以把快照复制回原来的实例以恢复, 或在副本上试走(如机器人的模拟)
+#ifndef TETRIS_FOOTPRINT
+extern void tetris_copy_r(tetris_t *dest, const tetris_t *src, const tetris_ops_t *ops, void *user);
+#endif
 #endif
 
 /************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,230 @@
+/**
+  ******************************************************************************
+  * @file    cellfb.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   与平台无关的字符单元帧缓冲
+  * @note    UI的每一部分(地图, 预览区, 分数等)都先写入各自的区域,
+  *          写入时只有内容真正改变的单元才被置脏; 刷新时把同一行中
+  *          连续的脏单元合成一段交给平台输出, 没变的单元不产生任何输出.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cellfb.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+#define     IS_DIRTY(fb, i)     ((fb)->dirty[(i) >> 3] & (0x01 << ((i) & 0x07)))
+#define     SET_DIRTY(fb, i)    ((fb)->dirty[(i) >> 3] |= (0x01 << ((i) & 0x07)))
+#define     CLR_DIRTY(fb, i)    ((fb)->dirty[(i) >> 3] &= ~(0x01 << ((i) & 0x07)))
+
+#define     DIRTY_BYTES(fb)     (((uint16_t)(fb)->width * (fb)->height + 7) / 8)
+
+// 两段脏单元之间的干净单元少于这么多字符时, 直接重新输出它们
+// 比移动光标更省, 终端上右移光标至少要<ESC>[C三个字节, 多列时四个字节
+#define     MERGE_COLUMNS       4
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  以指定内容填充整个区域, 用于与初始画面同步
+ *
+ * \param  fb
+ * \param  glyph
+ * \param  color
+ */
+void cellfb_init(const cellfb_t *fb, uint8_t glyph, uint8_t color)
+{
+    uint16_t i;
+
+    for (i = 0; i < (uint16_t)fb->width * fb->height; i++)
+    {
+        fb->cell[i].glyph = glyph;
+        fb->cell[i].color = color;
+    }
+
+    for (i = 0; i < DIRTY_BYTES(fb); i++)
+        fb->dirty[i] = 0;
+
+    return;
+}
+
+
+/**
+ * \brief  写一个单元
+ *
+ * \param  fb
+ * \param  x     区域内的x坐标(单元)
+ * \param  y     区域内的y坐标(单元)
+ * \param  glyph
+ * \param  color
+ */
+void cellfb_put(const cellfb_t *fb, uint8_t x, uint8_t y, uint8_t glyph, uint8_t color)
+{
+    uint16_t i;
+
+    if (x >= fb->width || y >= fb->height)
+        return;
+
+    i = (uint16_t)y * fb->width + x;
+
+    // 内容没变, 屏幕上的内容仍然是对的
+    if (fb->cell[i].glyph == glyph && fb->cell[i].color == color)
+        return;
+
+    fb->cell[i].glyph = glyph;
+    fb->cell[i].color = color;
+    SET_DIRTY(fb, i);
+
+    return;
+}
+
+
+/**
+ * \brief  写一个字符串
+ *
+ * \param  fb
+ * \param  x
+ * \param  y
+ * \param  str
+ * \param  color
+ */
+void cellfb_puts(const cellfb_t *fb, uint8_t x, uint8_t y, const char *str, uint8_t color)
+{
+    while (*str != '\0' && x < fb->width)
+    {
+        cellfb_put(fb, x, y, (uint8_t)*str, color);
+        str++;
+        x++;
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  将整个区域置脏
+ *
+ * \param  fb
+ */
+void cellfb_invalidate(const cellfb_t *fb)
+{
+    uint16_t i, cells = (uint16_t)fb->width * fb->height;
+
+    for (i = 0; i < DIRTY_BYTES(fb); i++)
+        fb->dirty[i] = 0xFF;
+
+    // 最后一个字节中超出区域的位不对应任何单元, cellfb_flush()不会清除它们
+    if (cells & 0x07)
+        fb->dirty[i - 1] = (uint8_t)((0x01 << (cells & 0x07)) - 1);
+
+    return;
+}
+
+
+/**
+ * \brief  is dirty?
+ *
+ * \param  fb
+ */
+bool cellfb_is_dirty(const cellfb_t *fb)
+{
+    uint16_t i;
+
+    for (i = 0; i < DIRTY_BYTES(fb); i++)
+    {
+        if (fb->dirty[i] != 0)
+            return true;
+    }
+
+    return false;
+}
+
+
+/**
+ * \brief  输出所有脏单元
+ *
+ * \param  fb
+ * \param  emit 平台的输出函数
+ *
+ * \retval true  全部输出完成
+ *         false emit没有接收全部单元, 剩下的单元保持为脏
+ */
+bool cellfb_flush(const cellfb_t *fb, cellfb_emit_t emit)
+{
+    uint8_t x, y, n, len, done;
+    uint16_t i;
+
+    for (y = 0; y < fb->height; y++)
+    {
+        i = (uint16_t)y * fb->width;
+
+        for (x = 0; x < fb->width; )
+        {
+            if (!IS_DIRTY(fb, i + x))
+            {
+                x++;
+                continue;
+            }
+
+            // 同一行中连续的脏单元合成一段, 中间只隔几个字符的干净单元
+            // 也并入这一段, 屏幕上它们的内容与缓冲一致, 重新输出不会出错
+            len = 1;
+            for (n = x + 1; n < fb->width; n++)
+            {
+                if (IS_DIRTY(fb, i + n))
+                    len = n - x + 1;
+                else if ((n - x - len + 1) * fb->cell_width >= MERGE_COLUMNS)
+                    break;
+            }
+
+            done = emit(fb, x, y, &fb->cell[i + x], len);
+
+            while (done > 0)
+            {
+                done--;
+                CLR_DIRTY(fb, i + x + done);
+            }
+
+            // 平台暂时不能输出更多, 剩下的下次再输出
+            if (IS_DIRTY(fb, i + x + len - 1))
+                return false;
+
+            x += len;
+        }
+    }
+
+    return true;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
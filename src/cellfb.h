@@ -0,0 +1,96 @@
+/**
+  ******************************************************************************
+  * @file    cellfb.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   与平台无关的字符单元帧缓冲
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _CELLFB_H_
+#define _CELLFB_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported types ------------------------------------------------------------*/
+// 一个字符单元, glyph的含义由平台决定(ASCII字符或平台自定义的图形码)
+typedef struct
+{
+    uint8_t glyph;          //!< 字符
+    uint8_t color;          //!< 高4位背景色, 低4位前景色
+} cell_t;
+
+// 屏幕上的一块矩形区域, 区域的配置不会改变, 可以放在ROM中
+typedef struct
+{
+    cell_t *cell;           //!< width * height个单元, 按行存放
+    uint8_t *dirty;         //!< 每个单元一位, 为1表示屏幕上的内容已过时
+    uint8_t width;          //!< 区域宽(单元)
+    uint8_t height;         //!< 区域高(单元)
+    uint8_t column;         //!< 区域左上角在屏幕上的列
+    uint8_t row;            //!< 区域左上角在屏幕上的行
+    uint8_t cell_width;     //!< 一个单元占用的字符宽度
+} cellfb_t;
+
+// 输出一段连续的脏单元, 位于区域内(x, y)开始的同一行中
+// 返回实际输出的单元数, 少于len时剩下的单元保持为脏, 下次再输出
+typedef uint8_t (*cellfb_emit_t)(const cellfb_t *fb, uint8_t x, uint8_t y,
+                                 const cell_t *run, uint8_t len);
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+#define     CELL_COLOR(fg, bg)      ((uint8_t)((((bg) & 0x0F) << 4) | ((fg) & 0x0F)))
+#define     CELL_FG(color)          ((color) & 0x0F)
+#define     CELL_BG(color)          ((color) >> 4)
+
+//! 创建一个名字为 FB_NAME 的区域, 左上角位于屏幕(COLUMN, ROW)
+#define     CREATE_CELLFB(FB_NAME, WIDTH, HEIGHT, COLUMN, ROW, CELL_WIDTH)     \
+    static cell_t FB_NAME##_cell[(WIDTH) * (HEIGHT)];                          \
+    static uint8_t FB_NAME##_dirty[((WIDTH) * (HEIGHT) + 7) / 8];              \
+    static const cellfb_t FB_NAME = {                                          \
+        FB_NAME##_cell, FB_NAME##_dirty,                                       \
+        WIDTH, HEIGHT, COLUMN, ROW, CELL_WIDTH}
+
+/* Exported functions ------------------------------------------------------- */
+// 以指定内容填充整个区域, 认为屏幕上已经是这些内容(不置脏)
+extern void cellfb_init(const cellfb_t *fb, uint8_t glyph, uint8_t color);
+// 写一个单元, 内容有变化时置脏
+extern void cellfb_put(const cellfb_t *fb, uint8_t x, uint8_t y, uint8_t glyph, uint8_t color);
+// 从(x, y)开始写一个字符串, 超出区域的部分被丢弃
+extern void cellfb_puts(const cellfb_t *fb, uint8_t x, uint8_t y, const char *str, uint8_t color);
+// 屏幕上的内容被破坏, 下次全部重新输出
+extern void cellfb_invalidate(const cellfb_t *fb);
+// 是否还有未输出的单元
+extern bool cellfb_is_dirty(const cellfb_t *fb);
+// 将所有脏单元交给emit输出, 全部输出完成时返回true
+extern bool cellfb_flush(const cellfb_t *fb, cellfb_emit_t emit);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,381 @@
+/**
+  ******************************************************************************
+  * @file    delta.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   观战数据流的编码与解码
+  * @note    每个tick编码为若干条带标记的记录, 以DELTA_END结束:
+  *            DELTA_KEYFRAME  后接整个地图, 解码方从空地图开始
+  *            DELTA_MAP       后接与上一帧异或后的地图
+  *            DELTA_PREVIEW 等 HUD的一项, 只在改变或关键帧时发送
+  *          地图按行(10位)游程编码, 每段两个字节(小端):
+  *            bit 14 - 10 为段长 - 1, bit 9 - 0 为这一段中每一行的值
+  *          异或之后没变的行为0, 连成一段只占两个字节; 一共20行.
+  *          关键帧按固定间隔发送, 中途加入的观众从关键帧开始解码.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "delta.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+// 记录标记
+#define     DELTA_END               'E'     // 一个tick结束
+#define     DELTA_KEYFRAME          'K'     // 地图, 相对空地图
+#define     DELTA_MAP               'M'     // 地图, 相对上一帧
+#define     DELTA_PREVIEW           'P'     // 2字节
+#define     DELTA_LEVEL             'V'     // 1字节
+#define     DELTA_LINES             'L'     // 2字节
+#define     DELTA_SCORE             'S'     // 4字节
+#define     DELTA_FLAGS             'F'     // 1字节
+
+#define     ROW_MASK                0x03FF
+#define     RUN_MAX                 32      // 段长占5位
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  小端写入
+ *
+ * \return 写入之后的位置
+ */
+static uint8_t *put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+
+    return p + 2;
+}
+
+
+static uint16_t get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+
+/**
+ * \brief  地图的游程编码
+ *
+ * \param  p
+ * \param  row 每行的值, 只用低10位
+ *
+ * \return 写入之后的位置
+ */
+static uint8_t *put_rows(uint8_t *p, const uint16_t *row)
+{
+    uint8_t y, n;
+
+    for (y = 0; y < TETRIS_MAP_HEIGHT; y += n)
+    {
+        for (n = 1; y + n < TETRIS_MAP_HEIGHT && n < RUN_MAX; n++)
+        {
+            if (row[y + n] != row[y])
+                break;
+        }
+
+        p = put16(p, (uint16_t)(((n - 1) << 10) | row[y]));
+    }
+
+    return p;
+}
+
+
+/**
+ * \brief  初始化编码器, 第一帧为关键帧
+ *
+ * \param  enc
+ * \param  keyframe_interval
+ */
+void delta_encoder_init(delta_encoder_t *enc, uint16_t keyframe_interval)
+{
+    enc->keyframe_interval = keyframe_interval;
+    delta_force_keyframe(enc);
+
+    return;
+}
+
+
+/**
+ * \brief  下一个tick发送关键帧
+ *
+ * \param  enc
+ */
+void delta_force_keyframe(delta_encoder_t *enc)
+{
+    enc->since_keyframe = 0xFFFF;
+
+    return;
+}
+
+
+/**
+ * \brief  编码一个tick
+ *
+ * \param  enc
+ * \param  frame 这个tick的画面
+ * \param  rows  可能改变过的行, 由引擎的tetris_changed_rows()得到,
+ *               不在其中的行认为与上一帧相同; 不确定时传入全部行
+ * \param  buf   至少DELTA_TICK_MAX字节
+ *
+ * \return 写入的字节数
+ */
+uint8_t delta_encode(delta_encoder_t *enc, const delta_frame_t *frame,
+                     uint32_t rows, uint8_t *buf)
+{
+    uint16_t diff[TETRIS_MAP_HEIGHT];
+    uint8_t *p = buf;
+    bool key, changed = false;
+    uint8_t y;
+
+    key = (enc->since_keyframe == 0xFFFF)
+       || (enc->keyframe_interval != 0 && enc->since_keyframe + 1 >= enc->keyframe_interval);
+
+    if (key)
+    {
+        enc->since_keyframe = 0;
+
+        *p++ = DELTA_KEYFRAME;
+        for (y = 0; y < TETRIS_MAP_HEIGHT; y++)
+            diff[y] = (uint16_t)frame->map[y] & ROW_MASK;
+        p = put_rows(p, diff);
+    }
+    else
+    {
+        if (enc->since_keyframe < 0xFFFE)
+            enc->since_keyframe++;
+
+        // 只比较引擎报告改变过的行
+        for (y = 0; y < TETRIS_MAP_HEIGHT; y++)
+        {
+            diff[y] = 0;
+            if (rows & ((uint32_t)1 << y))
+                diff[y] = (uint16_t)(frame->map[y] ^ enc->last.map[y]) & ROW_MASK;
+            if (diff[y] != 0)
+                changed = true;
+        }
+
+        if (changed)
+        {
+            *p++ = DELTA_MAP;
+            p = put_rows(p, diff);
+        }
+    }
+
+    // 关键帧的diff是相对空地图的
+    for (y = 0; y < TETRIS_MAP_HEIGHT; y++)
+    {
+        if (key)
+            enc->last.map[y] = 0;
+        enc->last.map[y] ^= (int16_t)diff[y];
+    }
+
+    if (key || frame->preview != enc->last.preview)
+    {
+        *p++ = DELTA_PREVIEW;
+        p = put16(p, frame->preview);
+    }
+
+    if (key || frame->level != enc->last.level)
+    {
+        *p++ = DELTA_LEVEL;
+        *p++ = frame->level;
+    }
+
+    if (key || frame->lines != enc->last.lines)
+    {
+        *p++ = DELTA_LINES;
+        p = put16(p, frame->lines);
+    }
+
+    if (key || frame->score != enc->last.score)
+    {
+        *p++ = DELTA_SCORE;
+        p = put16(p, (uint16_t)frame->score);
+        p = put16(p, (uint16_t)(frame->score >> 16));
+    }
+
+    if (key || frame->flags != enc->last.flags)
+    {
+        *p++ = DELTA_FLAGS;
+        *p++ = frame->flags;
+    }
+
+    *p++ = DELTA_END;
+
+    enc->last.preview = frame->preview;
+    enc->last.level = frame->level;
+    enc->last.lines = frame->lines;
+    enc->last.score = frame->score;
+    enc->last.flags = frame->flags;
+
+    return (uint8_t)(p - buf);
+}
+
+
+/**
+ * \brief  初始化解码器, 收到关键帧之前没有有效的帧
+ *
+ * \param  dec
+ */
+void delta_decoder_init(delta_decoder_t *dec)
+{
+    dec->synced = false;
+
+    return;
+}
+
+
+/**
+ * \brief  解码地图的游程编码, 与map异或
+ *
+ * \return 用掉的字节数, 数据不完整时返回0, 错误时返回DELTA_ERROR
+ */
+static uint16_t get_rows(const uint8_t *buf, uint16_t len, int16_t *map)
+{
+    uint16_t used = 0, run;
+    uint8_t y = 0, n;
+
+    while (y < TETRIS_MAP_HEIGHT)
+    {
+        if (used + 2 > len)
+            return 0;
+
+        run = get16(buf + used);
+        used += 2;
+
+        n = (uint8_t)((run >> 10) & (RUN_MAX - 1)) + 1;
+        if ((run & 0x8000) || y + n > TETRIS_MAP_HEIGHT)
+            return DELTA_ERROR;
+
+        for (; n > 0; n--, y++)
+            map[y] ^= (int16_t)(run & ROW_MASK);
+    }
+
+    return used;
+}
+
+
+/**
+ * \brief  解码一个tick
+ *
+ * \param  dec
+ * \param  buf
+ * \param  len buf中的字节数, 可以包含之后的tick
+ *
+ * \return 用掉的字节数, 解码后dec->frame为这个tick的画面(dec->synced时)
+ *         数据不完整时返回0, dec不变; 数据错误时返回DELTA_ERROR
+ */
+uint16_t delta_decode(delta_decoder_t *dec, const uint8_t *buf, uint16_t len)
+{
+    // 解码到一个tick结束才更新dec, 数据不完整时下次从头再解
+    delta_frame_t f = dec->frame;
+    bool synced = dec->synced;
+    uint16_t used = 0, n;
+    uint8_t y, tag, size;
+
+    while (1)
+    {
+        if (used >= len)
+            return 0;
+
+        tag = buf[used++];
+
+        if (tag == DELTA_END)
+            break;
+
+        if (tag == DELTA_KEYFRAME || tag == DELTA_MAP)
+        {
+            if (tag == DELTA_KEYFRAME)
+            {
+                for (y = 0; y < TETRIS_MAP_HEIGHT; y++)
+                    f.map[y] = 0;
+                synced = true;
+            }
+
+            n = get_rows(buf + used, len - used, f.map);
+            if (n == 0 || n == DELTA_ERROR)
+                return n;
+            used += n;
+            continue;
+        }
+
+        switch (tag)
+        {
+        case DELTA_LEVEL:
+        case DELTA_FLAGS:
+            size = 1;
+            break;
+        case DELTA_PREVIEW:
+        case DELTA_LINES:
+            size = 2;
+            break;
+        case DELTA_SCORE:
+            size = 4;
+            break;
+        default:
+            return DELTA_ERROR;
+        }
+
+        if (used + size > len)
+            return 0;
+
+        switch (tag)
+        {
+        case DELTA_LEVEL:
+            f.level = buf[used];
+            break;
+        case DELTA_FLAGS:
+            f.flags = buf[used];
+            break;
+        case DELTA_PREVIEW:
+            f.preview = get16(buf + used);
+            break;
+        case DELTA_LINES:
+            f.lines = get16(buf + used);
+            break;
+        default:
+            f.score = get16(buf + used) | ((uint32_t)get16(buf + used + 2) << 16);
+            break;
+        }
+
+        used += size;
+    }
+
+    dec->frame = f;
+    dec->synced = synced;
+
+    return used;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,94 @@
+/**
+  ******************************************************************************
+  * @file    delta.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   观战数据流的编码与解码, 每个tick只发送变化的部分
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _DELTA_H_
+#define _DELTA_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Tetris.h"
+
+/* Exported types ------------------------------------------------------------*/
+// 一帧画面, 编码方填好后交给delta_encode(), 解码方由delta_decode()还原
+typedef struct
+{
+    int16_t map[TETRIS_MAP_HEIGHT];     //!< 地图(含正在下落的方块)
+    uint16_t preview;                   //!< 预览方块点阵
+    uint8_t level;                      //!< 级别
+    uint16_t lines;                     //!< 消除的行数
+    uint32_t score;                     //!< 分数
+    uint8_t flags;                      //!< DELTA_PAUSE, DELTA_GAME_OVER
+} delta_frame_t;
+
+typedef struct
+{
+    delta_frame_t last;                 //!< 上一帧, 下一帧与它比较
+    uint16_t keyframe_interval;         //!< 每隔多少tick发送一次关键帧
+    uint16_t since_keyframe;            //!< 距离上一个关键帧的tick数
+} delta_encoder_t;
+
+typedef struct
+{
+    delta_frame_t frame;                //!< 最近一次完整解码的帧
+    bool synced;                        //!< 已收到关键帧, frame有效
+} delta_decoder_t;
+
+/* Exported constants --------------------------------------------------------*/
+#define     DELTA_PAUSE             0x01
+#define     DELTA_GAME_OVER         0x02
+
+// 一个tick编码后最多的字节数
+#define     DELTA_TICK_MAX          64
+
+// delta_decode()遇到错误的数据
+#define     DELTA_ERROR             0xFFFF
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+// keyframe_interval为0时只在第一帧发送关键帧
+extern void delta_encoder_init(delta_encoder_t *enc, uint16_t keyframe_interval);
+// 编码一个tick, rows为可能改变过的行(tetris_changed_rows()), 返回写入buf的字节数
+// buf至少DELTA_TICK_MAX字节
+extern uint8_t delta_encode(delta_encoder_t *enc, const delta_frame_t *frame,
+                            uint32_t rows, uint8_t *buf);
+// 下一个tick发送关键帧, 如有新的观众加入时
+extern void delta_force_keyframe(delta_encoder_t *enc);
+
+extern void delta_decoder_init(delta_decoder_t *dec);
+// 解码一个tick, 返回用掉的字节数, 数据不完整时返回0, 数据错误时返回DELTA_ERROR
+extern uint16_t delta_decode(delta_decoder_t *dec, const uint8_t *buf, uint16_t len);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,169 @@
+/**
+  ******************************************************************************
+  * @file    sched.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   与平台无关的定时器调度
+  * @note    已启动的定时器按到期时间排成一个链表, 表头就是下一次需要唤醒
+  *          的时间. 定时器只有几个(下落, 刷新等), 插入时顺序查找比堆或
+  *          时间轮更简单也更省RAM. 平台在空闲时用sched_next()得到可以
+  *          休眠多久, 把硬件定时器设置到那个时刻, 不再需要固定周期的中断.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "sched.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+// a早于b, 时间回绕后仍然正确
+#define     BEFORE(a, b)        ((int16_t)(sched_time_t)((a) - (b)) < 0)
+
+/* Private variables ---------------------------------------------------------*/
+static sched_timer_t *timer_list = NULL;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  启动定时器
+ *
+ * \param  timer
+ * \param  now   当前时间
+ * \param  delay 从now开始多久后到期
+ */
+void sched_start(sched_timer_t *timer, sched_time_t now, sched_time_t delay)
+{
+    sched_timer_t **p;
+
+    sched_stop(timer);
+
+    timer->deadline = now + delay;
+    timer->armed = true;
+
+    // 到期时间相同时排在后面, 先启动的先调用
+    for (p = &timer_list; *p != NULL; p = &(*p)->next)
+    {
+        if (BEFORE(timer->deadline, (*p)->deadline))
+            break;
+    }
+
+    timer->next = *p;
+    *p = timer;
+
+    return;
+}
+
+
+/**
+ * \brief  停止定时器, 未启动时什么也不做
+ *
+ * \param  timer
+ */
+void sched_stop(sched_timer_t *timer)
+{
+    sched_timer_t **p;
+
+    if (!timer->armed)
+        return;
+
+    for (p = &timer_list; *p != NULL; p = &(*p)->next)
+    {
+        if (*p == timer)
+        {
+            *p = timer->next;
+            break;
+        }
+    }
+
+    timer->next = NULL;
+    timer->armed = false;
+
+    return;
+}
+
+
+/**
+ * \brief  is armed?
+ *
+ * \param  timer
+ */
+bool sched_armed(const sched_timer_t *timer)
+{
+    return timer->armed;
+}
+
+
+/**
+ * \brief  调用所有已到期定时器的handler
+ *
+ * \param  now
+ */
+void sched_run(sched_time_t now)
+{
+    sched_timer_t *timer;
+
+    // handler可能重新启动自己或其它定时器, 每次都从表头取
+    while (timer_list != NULL && !BEFORE(now, timer_list->deadline))
+    {
+        timer = timer_list;
+        sched_stop(timer);
+
+        if (timer->handler != NULL)
+            timer->handler(now);
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  离最近的到期时间还有多久
+ *
+ * \param  now
+ * \param  delay 返回等待时间, 已到期时为0
+ *
+ * \retval true  有已启动的定时器
+ *         false 没有, delay不变
+ */
+bool sched_next(sched_time_t now, sched_time_t *delay)
+{
+    if (timer_list == NULL)
+        return false;
+
+    if (BEFORE(now, timer_list->deadline))
+        *delay = timer_list->deadline - now;
+    else
+        *delay = 0;
+
+    return true;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    sched.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   与平台无关的定时器调度, 只在最近的到期时间唤醒
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _SCHED_H_
+#define _SCHED_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported types ------------------------------------------------------------*/
+// 时间由平台提供, 单位通常为ms, 回绕后比较仍然正确
+// 只要所有到期时间与当前时间相差不超过32767
+typedef uint16_t sched_time_t;
+
+typedef struct sched_timer
+{
+    struct sched_timer *next;           //!< 按到期时间排列的下一个定时器
+    sched_time_t deadline;              //!< 到期时间
+    bool armed;                         //!< 已启动, 尚未到期
+    void (*handler)(sched_time_t now);  //!< 到期时调用, 可以为NULL(只用于唤醒)
+} sched_timer_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+//! 创建一个名字为 TIMER_NAME 的定时器, 到期时调用 HANDLER
+#define     CREATE_TIMER(TIMER_NAME, HANDLER)                                  \
+    static sched_timer_t TIMER_NAME = {NULL, 0, false, HANDLER}
+
+/* Exported functions ------------------------------------------------------- */
+// 启动定时器, 在now之后delay到期, 已启动的定时器重新计时
+extern void sched_start(sched_timer_t *timer, sched_time_t now, sched_time_t delay);
+// 停止定时器
+extern void sched_stop(sched_timer_t *timer);
+// 定时器是否已启动
+extern bool sched_armed(const sched_timer_t *timer);
+// 按到期顺序调用所有已到期定时器的handler, 调用前定时器已停止, handler中可以重新启动
+extern void sched_run(sched_time_t now);
+// 离最近的到期时间还有多久, 已到期时为0, 没有已启动的定时器时返回false
+extern bool sched_next(sched_time_t now, sched_time_t *delay);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,12 @@
+#!/bin/sh
+# 在主机上编译回放导出程序, 用法见frames.c
+
+CFLAGS="-std=gnu99 -O2 -Wall -I../../src -I../replay"
+
+gcc $CFLAGS -c frames.c || exit 1
+gcc $CFLAGS -c ../replay/replay.c || exit 1
+gcc $CFLAGS -c ../../src/Tetris.c || exit 1
+gcc $CFLAGS -c ../../src/util.c || exit 1
+gcc -o frames frames.o replay.o Tetris.o util.o -lpthread || exit 1
+
+rm -f *.o
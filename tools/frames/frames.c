@@ -0,0 +1,511 @@
+/**
+  ******************************************************************************
+  * @file    frames.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   把按键记录回放成图片序列(PPM), 用于查问题和制作视频
+  * @note    不需要终端: 主线程按记录驱动引擎, 按固定帧率记下每一帧的
+  *          地图, 预览方块和分数, 多个线程把帧画到预先分配的缓冲区中,
+  *          主线程再按顺序写出. 所有帧写入同一个文件(PPM流), 顺序写,
+  *          大缓冲, 可以直接交给ffmpeg:
+  *              ffmpeg -f image2pipe -c:v ppm -r 30 -i game.ppm game.mp4
+  *
+  *          用法: frames [-r 帧率] [-z 格子像素] [-j 线程数] [-t 秒]
+  *                       [-o 输出文件] 记录文件
+  *          记录文件的格式见tools/replay/replay.c.
+  *          回放到游戏结束, 或最后一个按键之后一秒, 或-t指定的时间.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "Tetris.h"
+#include "replay.h"
+
+/* Private typedef -----------------------------------------------------------*/
+// 画一帧所需的全部数据
+typedef struct
+{
+    int16_t map[TETRIS_MAP_HEIGHT];
+    uint16_t preview;
+    uint8_t level;
+    uint16_t lines;
+    uint32_t score;
+    bool pause;
+    bool game_over;
+} snapshot_t;
+
+// 缓冲池中的一块, 依次为 空闲 -> 已记录 -> 正在画 -> 已画好 -> 写出后空闲
+typedef enum
+{
+    slot_free,
+    slot_filled,
+    slot_rendering,
+    slot_rendered,
+} slot_state_t;
+
+typedef struct
+{
+    snapshot_t snap;
+    uint8_t *pixels;        //!< RGB, 每块在开始时一次分配
+    slot_state_t state;
+} slot_t;
+
+/* Private define ------------------------------------------------------------*/
+// 画面布局, 单位为格子: 左边地图区, 右边预览区和分数
+#define     IMAGE_COLUMNS       21
+#define     IMAGE_ROWS          22
+#define     MAP_LEFT            1
+#define     MAP_TOP             1
+#define     PANEL_LEFT          12
+// 图像宽高为uint16_t, PPM头也按此输出, 格子不能大于这个像素数
+#define     CELL_MAX            (65535 / (IMAGE_COLUMNS > IMAGE_ROWS ? IMAGE_COLUMNS : IMAGE_ROWS))
+
+#define     FONT_WIDTH          3
+#define     FONT_HEIGHT         5
+
+#define     OUT_BUFFER_SIZE     (4 * 1024 * 1024)
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+static const uint8_t color_back[3]  = { 40,  40,  48};
+static const uint8_t color_map[3]   = { 16,  16,  24};
+static const uint8_t color_empty[3] = { 28,  28,  40};
+static const uint8_t color_box[3]   = { 64, 140, 255};
+static const uint8_t color_text[3]  = {230, 230, 230};
+static const uint8_t color_label[3] = {150, 150, 170};
+
+// 3 * 5点阵字体, 每行3位, 高位在左
+static const struct
+{
+    char ch;
+    uint8_t row[FONT_HEIGHT];
+} font[] =
+{
+    {'0', {7, 5, 5, 5, 7}}, {'1', {2, 6, 2, 2, 7}}, {'2', {7, 1, 7, 4, 7}},
+    {'3', {7, 1, 7, 1, 7}}, {'4', {5, 5, 7, 1, 1}}, {'5', {7, 4, 7, 1, 7}},
+    {'6', {7, 4, 7, 5, 7}}, {'7', {7, 1, 1, 1, 1}}, {'8', {7, 5, 7, 5, 7}},
+    {'9', {7, 5, 7, 1, 7}}, {'A', {2, 5, 7, 5, 5}}, {'C', {7, 4, 4, 4, 7}},
+    {'E', {7, 4, 7, 4, 7}}, {'G', {7, 4, 5, 5, 7}}, {'I', {7, 2, 2, 2, 7}},
+    {'L', {4, 4, 4, 4, 7}}, {'M', {5, 7, 7, 5, 5}}, {'N', {6, 5, 5, 5, 5}},
+    {'O', {7, 5, 5, 5, 7}}, {'P', {7, 5, 7, 4, 4}}, {'R', {6, 5, 6, 5, 5}},
+    {'S', {7, 4, 7, 1, 7}}, {'T', {7, 2, 2, 2, 2}}, {'U', {5, 5, 5, 5, 7}},
+    {'V', {5, 5, 5, 5, 2}}, {'X', {5, 5, 2, 5, 5}},
+};
+
+// 图像
+static uint16_t cell = 12;          // 一个格子的像素
+static uint16_t width, height;
+static size_t frame_size;
+
+// 缓冲池
+static slot_t *slot = NULL;
+static uint32_t slot_count;
+static uint32_t filled = 0;         // 已记录的帧数
+static uint32_t next_render = 0;    // 下一个要画的帧
+static bool done = false;
+static bool write_error = false;    // 写出失败过, 如磁盘满
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t changed = PTHREAD_COND_INITIALIZER;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  画一个实心矩形
+ */
+static void fill(uint8_t *pixels, int x, int y, int w, int h, const uint8_t *color)
+{
+    uint8_t *p;
+    int i, j;
+
+    for (j = y; j < y + h; j++)
+    {
+        p = pixels + ((size_t)j * width + x) * 3;
+        for (i = 0; i < w; i++, p += 3)
+        {
+            p[0] = color[0];
+            p[1] = color[1];
+            p[2] = color[2];
+        }
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  在像素(x, y)写一个字符串, 一个字体点为dot * dot像素
+ */
+static void text(uint8_t *pixels, int x, int y, int dot, const char *str, const uint8_t *color)
+{
+    size_t i;
+    int r, c;
+
+    for (; *str != '\0'; str++, x += (FONT_WIDTH + 1) * dot)
+    {
+        for (i = 0; i < sizeof(font) / sizeof(font[0]); i++)
+        {
+            if (font[i].ch == *str)
+                break;
+        }
+
+        if (i == sizeof(font) / sizeof(font[0]))
+            continue;
+
+        for (r = 0; r < FONT_HEIGHT; r++)
+        {
+            for (c = 0; c < FONT_WIDTH; c++)
+            {
+                if (font[i].row[r] & (0x04 >> c))
+                    fill(pixels, x + c * dot, y + r * dot, dot, dot, color);
+            }
+        }
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  画一个格子, 留一个像素的缝
+ */
+static void box(uint8_t *pixels, int column, int row, bool on)
+{
+    fill(pixels, column * cell, row * cell, cell - 1, cell - 1, on ? color_box : color_empty);
+
+    return;
+}
+
+
+/**
+ * \brief  画一帧
+ *
+ * \param  s
+ * \param  pixels
+ */
+static void render(const snapshot_t *s, uint8_t *pixels)
+{
+    int dot = cell / 4 ? cell / 4 : 1;
+    const char *msg;
+    int x, y;
+    char buf[12];
+
+    fill(pixels, 0, 0, width, height, color_back);
+    fill(pixels, MAP_LEFT * cell - 1, MAP_TOP * cell - 1,
+         TETRIS_MAP_WIDTH * cell + 1, TETRIS_MAP_HEIGHT * cell + 1, color_map);
+
+    for (y = 0; y < TETRIS_MAP_HEIGHT; y++)
+    {
+        for (x = 0; x < TETRIS_MAP_WIDTH; x++)
+            box(pixels, MAP_LEFT + x, MAP_TOP + y, (s->map[y] >> x) & 0x0001);
+    }
+
+    text(pixels, PANEL_LEFT * cell, 1 * cell, dot, "NEXT", color_label);
+    for (y = 0; y < 4; y++)
+    {
+        for (x = 0; x < 4; x++)
+            box(pixels, PANEL_LEFT + x, 3 + y, (s->preview >> (15 - (y * 4 + x))) & 0x0001);
+    }
+
+    text(pixels, PANEL_LEFT * cell, 9 * cell, dot, "LEVEL", color_label);
+    sprintf(buf, "%u", s->level);
+    text(pixels, PANEL_LEFT * cell, 10 * cell + cell / 2, dot, buf, color_text);
+
+    text(pixels, PANEL_LEFT * cell, 13 * cell, dot, "LINES", color_label);
+    sprintf(buf, "%u", s->lines);
+    text(pixels, PANEL_LEFT * cell, 14 * cell + cell / 2, dot, buf, color_text);
+
+    text(pixels, PANEL_LEFT * cell, 17 * cell, dot, "SCORE", color_label);
+    sprintf(buf, "%lu", (unsigned long)s->score);
+    text(pixels, PANEL_LEFT * cell, 18 * cell + cell / 2, dot, buf, color_text);
+
+    // 暂停, 结束信息画在地图区中间
+    if (s->pause || s->game_over)
+    {
+        msg = s->game_over ? "GAME OVER" : "PAUSE";
+        x = (int)strlen(msg) * (FONT_WIDTH + 1) * dot - dot;
+        fill(pixels, MAP_LEFT * cell, 9 * cell, TETRIS_MAP_WIDTH * cell, 3 * cell, color_back);
+        text(pixels, MAP_LEFT * cell + (TETRIS_MAP_WIDTH * cell - x) / 2,
+             10 * cell + (cell - FONT_HEIGHT * dot) / 2, dot, msg, color_text);
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  绘图线程, 按帧号顺序取已记录的帧来画, 画完的帧由主线程写出
+ */
+static void *render_worker(void *arg)
+{
+    slot_t *s;
+
+    (void)arg;
+
+    pthread_mutex_lock(&lock);
+
+    while (1)
+    {
+        if (next_render < filled)
+        {
+            s = &slot[next_render % slot_count];
+            next_render++;
+            s->state = slot_rendering;
+            pthread_mutex_unlock(&lock);
+
+            render(&s->snap, s->pixels);
+
+            pthread_mutex_lock(&lock);
+            s->state = slot_rendered;
+            pthread_cond_broadcast(&changed);
+        }
+        else if (done)
+        {
+            break;
+        }
+        else
+        {
+            pthread_cond_wait(&changed, &lock);
+        }
+    }
+
+    pthread_mutex_unlock(&lock);
+
+    return NULL;
+}
+
+
+/**
+ * \brief  按顺序写出已画好的帧
+ *
+ * \param  out
+ * \param  written 已写出的帧数
+ * \param  limit   写到这一帧之前为止
+ * \param  wait    下一帧还没画好时是否等待
+ */
+static void write_frames(FILE *out, uint32_t *written, uint32_t limit, bool wait)
+{
+    slot_t *s;
+
+    pthread_mutex_lock(&lock);
+
+    while (*written < limit)
+    {
+        s = &slot[*written % slot_count];
+
+        if (s->state != slot_rendered)
+        {
+            if (!wait)
+                break;
+            pthread_cond_wait(&changed, &lock);
+            continue;
+        }
+
+        pthread_mutex_unlock(&lock);
+
+        // 已画好的块只有主线程访问, 写出时不必加锁
+        fprintf(out, "P6\n%u %u\n255\n", width, height);
+        if (fwrite(s->pixels, 1, frame_size, out) != frame_size)
+            write_error = true;
+
+        pthread_mutex_lock(&lock);
+        s->state = slot_free;
+        (*written)++;
+    }
+
+    pthread_mutex_unlock(&lock);
+
+    return;
+}
+
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-r fps] [-z cell 2-%d] [-j threads] [-t seconds] [-o out.ppm] replay\n", name, CELL_MAX);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *out_path = "-", *replay = NULL;
+    unsigned long fps = 30, threads = 0, seconds = 0, zoom = cell;
+    uint32_t end, frame, now, written = 0;
+    pthread_t *worker;
+    FILE *out;
+    uint32_t i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:z:j:t:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            fps = strtoul(optarg, NULL, 0);
+            break;
+        case 'z':
+            zoom = strtoul(optarg, NULL, 0);
+            break;
+        case 'j':
+            threads = strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            seconds = strtoul(optarg, NULL, 0);
+            break;
+        case 'o':
+            out_path = optarg;
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (optind != argc - 1 || fps == 0 || zoom < 2 || zoom > CELL_MAX)
+        return usage(argv[0]);
+
+    cell = (uint16_t)zoom;
+
+    replay = argv[optind];
+    if (!replay_load(replay))
+        return 1;
+
+    end = replay_end();
+    if (seconds != 0)
+        end = (uint32_t)(seconds * 1000);
+
+    if (threads == 0)
+        threads = (unsigned long)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads == 0)
+        threads = 1;
+
+    out = (strcmp(out_path, "-") == 0) ? stdout : fopen(out_path, "wb");
+    if (out == NULL)
+    {
+        perror(out_path);
+        return 1;
+    }
+    setvbuf(out, NULL, _IOFBF, OUT_BUFFER_SIZE);
+
+    // 缓冲池在开始时一次分配, 之后不再分配内存
+    width = IMAGE_COLUMNS * cell;
+    height = IMAGE_ROWS * cell;
+    frame_size = (size_t)width * height * 3;
+    slot_count = (uint32_t)threads * 2 + 2;
+    slot = calloc(slot_count, sizeof(slot[0]));
+    worker = calloc(threads, sizeof(worker[0]));
+    if (slot == NULL || worker == NULL)
+        return 1;
+    for (i = 0; i < slot_count; i++)
+    {
+        slot[i].pixels = malloc(frame_size);
+        if (slot[i].pixels == NULL)
+            return 1;
+    }
+
+    for (i = 0; i < threads; i++)
+        pthread_create(&worker[i], NULL, render_worker, NULL);
+
+    replay_start();
+
+    for (frame = 0; ; frame++)
+    {
+        now = (uint32_t)((uint64_t)frame * 1000 / fps);
+
+        // 按时间顺序处理到这一帧为止的按键和下落
+        replay_advance(now);
+
+        // 等待这一帧的块空闲, 同时写出已画好的帧
+        while (1)
+        {
+            pthread_mutex_lock(&lock);
+            if (slot[frame % slot_count].state == slot_free)
+                break;
+            pthread_mutex_unlock(&lock);
+
+            write_frames(out, &written, frame, true);
+        }
+
+        tetris_get_map(slot[frame % slot_count].snap.map);
+        slot[frame % slot_count].snap.preview = replay_preview();
+        slot[frame % slot_count].snap.level = replay_level();
+        slot[frame % slot_count].snap.lines = replay_lines();
+        slot[frame % slot_count].snap.score = replay_score();
+        slot[frame % slot_count].snap.pause = replay_is_pause();
+        slot[frame % slot_count].snap.game_over = tetris_is_game_over();
+        slot[frame % slot_count].state = slot_filled;
+        filled = frame + 1;
+        pthread_cond_broadcast(&changed);
+        pthread_mutex_unlock(&lock);
+
+        write_frames(out, &written, frame, false);
+
+        if (tetris_is_game_over() || now >= end)
+            break;
+    }
+
+    write_frames(out, &written, filled, true);
+
+    pthread_mutex_lock(&lock);
+    done = true;
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&lock);
+
+    for (i = 0; i < threads; i++)
+        pthread_join(worker[i], NULL);
+
+    if (fflush(out) != 0 || ferror(out))
+        write_error = true;
+    if (out != stdout && fclose(out) != 0)
+        write_error = true;
+    if (write_error)
+    {
+        fprintf(stderr, "%s: write failed\n", out_path);
+        return 1;
+    }
+
+    fprintf(stderr, "%lu frames, %ux%u, %lu lines, score %lu%s\n",
+            (unsigned long)filled, width, height, (unsigned long)replay_lines(),
+            (unsigned long)replay_score(), tetris_is_game_over() ? ", game over" : "");
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,17 @@
+#!/bin/sh
+# 在主机上编译共享内存发布的示例程序, 用法见livegame.c和liveview.c
+# 其他程序读取游戏状态时只需要live.h和live_reader.c
+
+CFLAGS="-std=gnu99 -O2 -Wall -I../../src -I../replay"
+
+gcc $CFLAGS -c livegame.c || exit 1
+gcc $CFLAGS -c liveview.c || exit 1
+gcc $CFLAGS -c live.c || exit 1
+gcc $CFLAGS -c live_reader.c || exit 1
+gcc $CFLAGS -c ../replay/replay.c || exit 1
+gcc $CFLAGS -c ../../src/Tetris.c || exit 1
+gcc $CFLAGS -c ../../src/util.c || exit 1
+gcc -o livegame livegame.o live.o replay.o Tetris.o util.o -lrt || exit 1
+gcc -o liveview liveview.o live_reader.o util.o -lrt || exit 1
+
+rm -f *.o
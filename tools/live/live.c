@@ -0,0 +1,169 @@
+/**
+  ******************************************************************************
+  * @file    live.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   游戏状态的发布(写入方)
+  * @note    只有一个写入方. 发布时直接写共享内存, 不加锁, 不做系统调用,
+  *          任何读取方都不能让游戏循环等待.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "live.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static live_segment_t *segment = NULL;
+static char segment_name[64];
+static uint32_t seq = 0;                // 只有写入方改变seq, 不用读共享内存
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  创建共享内存段
+ *
+ * \param  name 共享内存名, 以'/'开头
+ *
+ * \return 成功返回true
+ */
+bool live_open(const char *name)
+{
+    int fd;
+
+    if (strlen(name) >= sizeof(segment_name))
+        return false;
+
+    fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        perror(name);
+        return false;
+    }
+
+    if (ftruncate(fd, sizeof(live_segment_t)) != 0)
+    {
+        perror(name);
+        close(fd);
+        return false;
+    }
+
+    segment = mmap(NULL, sizeof(live_segment_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED)
+    {
+        perror(name);
+        segment = NULL;
+        return false;
+    }
+
+    strcpy(segment_name, name);
+
+    // 上一次运行留下的段, 从不小于原来的偶数seq继续
+    // 与live_publish()相同, 清除期间seq为奇数, 已经连上的读取方会重读
+    seq = (__atomic_load_n(&segment->seq, __ATOMIC_RELAXED) + 1) & ~(uint32_t)1;
+    __atomic_store_n(&segment->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memset(&segment->state, 0, sizeof(segment->state));
+    segment->size = sizeof(live_segment_t);
+    seq += 2;
+    __atomic_store_n(&segment->seq, seq, __ATOMIC_RELEASE);
+    __atomic_store_n(&segment->magic, LIVE_MAGIC, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+
+/**
+ * \brief  发布一次, 与读取方没有任何同步, 最多写两次seq
+ *
+ * \param  level
+ * \param  lines
+ * \param  score
+ * \param  flags LIVE_PAUSE, LIVE_GAME_OVER
+ */
+void live_publish(uint8_t level, uint16_t lines, uint32_t score, uint8_t flags)
+{
+    live_state_t *s;
+
+    if (segment == NULL)
+        return;
+
+    s = &segment->state;
+
+    // 奇数: 正在写, 之后的写入不能排到它前面
+    __atomic_store_n(&segment->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    s->tick++;
+    tetris_get_map(s->map);
+    tetris_get_brick(&s->curr, &s->next);
+    s->score = score;
+    s->lines = lines;
+    s->level = level;
+    s->flags = flags;
+
+    // 偶数: 写完, 之前的写入不能排到它后面
+    seq += 2;
+    __atomic_store_n(&segment->seq, seq, __ATOMIC_RELEASE);
+
+    return;
+}
+
+
+/**
+ * \brief  结束发布
+ */
+void live_close(void)
+{
+    if (segment == NULL)
+        return;
+
+    __atomic_store_n(&segment->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    segment->state.flags |= LIVE_ENDED;
+    seq += 2;
+    __atomic_store_n(&segment->seq, seq, __ATOMIC_RELEASE);
+
+    munmap(segment, sizeof(live_segment_t));
+    shm_unlink(segment_name);
+    segment = NULL;
+
+    return;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
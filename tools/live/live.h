@@ -0,0 +1,96 @@
+/**
+  ******************************************************************************
+  * @file    live.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   通过POSIX共享内存发布游戏状态, 以及读取方的接口
+  * @note    一个写入方(游戏), 任意多个读取方(观看, 教练程序, 统计等).
+  *          共享内存段由顺序锁(seqlock)保护: 写入方写之前把seq加成奇数,
+  *          写完加成偶数, 从不等待读取方; 读取方在seq为偶数且复制前后
+  *          不变时得到一致的快照, 否则重读.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _LIVE_H_
+#define _LIVE_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Tetris.h"
+
+/* Exported types ------------------------------------------------------------*/
+// 一次发布的全部内容
+typedef struct
+{
+    uint32_t tick;                      //!< 发布的次数, 从1开始
+    int16_t map[TETRIS_MAP_HEIGHT];     //!< 地图(含正在下落的方块)
+    tetris_brick_t curr;                //!< 当前方块
+    tetris_brick_t next;                //!< 下一个方块
+    uint32_t score;                     //!< 分数
+    uint16_t lines;                     //!< 消除的行数
+    uint8_t level;                      //!< 级别
+    uint8_t flags;                      //!< LIVE_PAUSE, LIVE_GAME_OVER, LIVE_ENDED
+} live_state_t;
+
+// 共享内存段的布局
+typedef struct
+{
+    uint32_t magic;                     //!< LIVE_MAGIC, 写入方初始化完成后写入
+    uint32_t size;                      //!< sizeof(live_segment_t), 防止两边版本不同
+    uint32_t seq;                       //!< 顺序锁, 奇数表示正在写
+    live_state_t state;
+} live_segment_t;
+
+/* Exported constants --------------------------------------------------------*/
+#define     LIVE_MAGIC          0x54455452      // "TETR"
+
+#define     LIVE_PAUSE          0x01
+#define     LIVE_GAME_OVER      0x02
+#define     LIVE_ENDED          0x04            // 写入方已退出, 不会再有新的发布
+
+// 默认的共享内存名
+#define     LIVE_NAME           "/tetris-live"
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+// 写入方, live.c
+extern bool live_open(const char *name);
+// 每个tick调用一次, 从引擎取地图和方块, 加上平台的HUD数据
+extern void live_publish(uint8_t level, uint16_t lines, uint32_t score, uint8_t flags);
+// 发布LIVE_ENDED, 删除共享内存名, 已连接的读取方仍然可以读最后的状态
+extern void live_close(void);
+
+// 读取方, live_reader.c, 不依赖引擎
+extern const live_segment_t *live_attach(const char *name);
+// 复制一份一致的快照, 写入方太频繁导致多次重试仍失败时返回false
+extern bool live_read(const live_segment_t *seg, live_state_t *dest);
+extern void live_detach(const live_segment_t *seg);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,136 @@
+/**
+  ******************************************************************************
+  * @file    live_reader.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   游戏状态的读取方
+  * @note    只读映射, 读取方不会改变共享内存中的任何内容, 多个读取方之间,
+  *          读取方与写入方之间都互不影响. 不需要链接引擎.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "live.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+// 连续这么多次碰到写入方正在写就放弃, 由调用者决定下次什么时候再读
+#define     READ_TRIES          1000
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  连接写入方的共享内存段
+ *
+ * \param  name 与live_open()相同的名字
+ *
+ * \return 失败(不存在, 写入方还没初始化完, 版本不同)返回NULL
+ */
+const live_segment_t *live_attach(const char *name)
+{
+    live_segment_t *seg;
+    struct stat st;
+    int fd;
+
+    fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+        return NULL;
+
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(live_segment_t))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    seg = mmap(NULL, sizeof(live_segment_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED)
+        return NULL;
+
+    if (__atomic_load_n(&seg->magic, __ATOMIC_ACQUIRE) != LIVE_MAGIC
+        || seg->size != sizeof(live_segment_t))
+    {
+        munmap(seg, sizeof(live_segment_t));
+        return NULL;
+    }
+
+    return seg;
+}
+
+
+/**
+ * \brief  读一份一致的快照
+ *
+ * \param  seg
+ * \param  dest
+ *
+ * \retval true  dest为某一次完整的发布
+ *         false 重试READ_TRIES次都与写入方冲突, dest的内容无效
+ */
+bool live_read(const live_segment_t *seg, live_state_t *dest)
+{
+    uint32_t before, after;
+    uint16_t tries;
+
+    for (tries = 0; tries < READ_TRIES; tries++)
+    {
+        before = __atomic_load_n(&seg->seq, __ATOMIC_ACQUIRE);
+        if (before & 1)
+            continue;
+
+        memcpy(dest, (const void *)&seg->state, sizeof(*dest));
+
+        // 复制完成之后再读seq, 期间没有写入才是一致的
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&seg->seq, __ATOMIC_RELAXED);
+        if (before == after)
+            return true;
+    }
+
+    return false;
+}
+
+
+void live_detach(const live_segment_t *seg)
+{
+    munmap((void *)seg, sizeof(live_segment_t));
+
+    return;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,150 @@
+/**
+  ******************************************************************************
+  * @file    livegame.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   回放按键记录, 每个tick发布一次游戏状态
+  * @note    用法: livegame [-r tick率] [-x 倍速] [-n 共享内存名] 记录文件
+  *          -x 0 表示不等待, 尽快回放. 结束时报告每次发布的耗时,
+  *          用来确认读取方再多也不影响游戏循环.
+  *          记录文件的格式见tools/replay/replay.c.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "Tetris.h"
+#include "replay.h"
+#include "live.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-r ticks/s] [-x speed] [-n name] replay\n", name);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *name = LIVE_NAME;
+    unsigned long rate = 60;
+    double speed = 1.0;
+    uint64_t start, t, cost, cost_total = 0, cost_max = 0;
+    uint32_t tick, now, end;
+    struct timespec ts;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:x:n:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            rate = strtoul(optarg, NULL, 0);
+            break;
+        case 'x':
+            speed = atof(optarg);
+            break;
+        case 'n':
+            name = optarg;
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (optind != argc - 1 || rate == 0 || speed < 0)
+        return usage(argv[0]);
+
+    if (!replay_load(argv[optind]) || !live_open(name))
+        return 1;
+
+    end = replay_end();
+    replay_start();
+    start = clock_ns();
+
+    for (tick = 0; ; tick++)
+    {
+        now = (uint32_t)((uint64_t)tick * 1000 / rate);
+
+        // 按倍速等到这个tick的时间
+        if (speed > 0)
+        {
+            t = start + (uint64_t)(now * 1000000.0 / speed);
+            ts.tv_sec = (time_t)(t / 1000000000u);
+            ts.tv_nsec = (long)(t % 1000000000u);
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        }
+
+        replay_advance(now);
+        tetris_sync();
+
+        t = clock_ns();
+        live_publish(replay_level(), replay_lines(), replay_score(),
+                     (replay_is_pause() ? LIVE_PAUSE : 0)
+                     | (tetris_is_game_over() ? LIVE_GAME_OVER : 0));
+        cost = clock_ns() - t;
+
+        cost_total += cost;
+        if (cost > cost_max)
+            cost_max = cost;
+
+        if (tetris_is_game_over() || now >= end)
+            break;
+    }
+
+    live_close();
+
+    tick++;
+    printf("%lu ticks published to %s, %lu lines, score %lu%s\n",
+           (unsigned long)tick, name, (unsigned long)replay_lines(),
+           (unsigned long)replay_score(), tetris_is_game_over() ? ", game over" : "");
+    printf("publish: %.0f ns average, %lu ns max\n",
+           (double)cost_total / tick, (unsigned long)cost_max);
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
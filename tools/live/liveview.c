@@ -0,0 +1,225 @@
+/**
+  ******************************************************************************
+  * @file    liveview.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   连接正在运行的游戏, 显示或读取共享内存中的状态
+  * @note    用法: liveview [-n 共享内存名] [-i 间隔毫秒] [-b 秒]
+  *          默认每隔一段时间读一次, 有新的发布时把地图打印出来, 当前方块
+  *          用'@'表示; 写入方退出后结束.
+  *          -b 不打印, 在指定时间内连续读, 报告每秒读到的快照数和重试情况.
+  *          只链接读取方(live_reader.c), 不需要引擎.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "live.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  (x, y)是否为当前方块的一部分
+ */
+static bool in_brick(const tetris_brick_t *b, int x, int y)
+{
+    int col = x - b->x, row = y - b->y;
+
+    if (col < 0 || col > 3 || row < 0 || row > 3)
+        return false;
+
+    return (b->shape >> (15 - (row * 4 + col))) & 0x0001;
+}
+
+
+/**
+ * \brief  打印一个快照
+ */
+static void show(const live_state_t *s)
+{
+    static const char brick_name[] = "SZLJIOT";
+    int x, y;
+
+    printf("tick %lu  level %u  lines %u  score %lu  next %c%s%s\n",
+           (unsigned long)s->tick, s->level, s->lines, (unsigned long)s->score,
+           brick_name[s->next.type % 7],
+           (s->flags & LIVE_PAUSE) ? "  PAUSE" : "",
+           (s->flags & LIVE_GAME_OVER) ? "  GAME OVER" : "");
+
+    for (y = 0; y < TETRIS_MAP_HEIGHT; y++)
+    {
+        putchar('|');
+        for (x = 0; x < TETRIS_MAP_WIDTH; x++)
+        {
+            if (!((s->map[y] >> x) & 0x0001))
+                putchar(' ');
+            else if (in_brick(&s->curr, x, y))
+                putchar('@');
+            else
+                putchar('#');
+        }
+        puts("|");
+    }
+    puts("+----------+");
+    fflush(stdout);
+
+    return;
+}
+
+
+/**
+ * \brief  连续读, 统计读取速度
+ */
+static void bench(const live_segment_t *seg, unsigned long seconds)
+{
+    unsigned long reads = 0, failed = 0, fresh = 0, backwards = 0;
+    uint64_t start = clock_ns(), stop = start + (uint64_t)seconds * 1000000000u;
+    uint32_t last = 0;
+    live_state_t s;
+
+    while (clock_ns() < stop)
+    {
+        if (!live_read(seg, &s))
+        {
+            failed++;
+            continue;
+        }
+
+        reads++;
+        if (s.tick != last)
+        {
+            // 一致的快照中tick不会倒退
+            if (s.tick < last)
+                backwards++;
+            fresh++;
+            last = s.tick;
+        }
+
+        if (s.flags & LIVE_ENDED)
+            break;
+    }
+
+    seconds = (unsigned long)((clock_ns() - start) / 1000000u);
+    if (seconds == 0)
+        seconds = 1;
+    printf("%lu snapshots in %lu ms, %.0f/s, %lu distinct ticks, %lu failed, %lu out of order\n",
+           reads, seconds, reads * 1000.0 / seconds, fresh, failed, backwards);
+
+    return;
+}
+
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-n name] [-i interval ms] [-b seconds]\n", name);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *name = LIVE_NAME;
+    unsigned long interval = 200, seconds = 0;
+    const live_segment_t *seg;
+    uint32_t last = 0;
+    live_state_t s;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:i:b:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            name = optarg;
+            break;
+        case 'i':
+            interval = strtoul(optarg, NULL, 0);
+            break;
+        case 'b':
+            seconds = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (optind != argc)
+        return usage(argv[0]);
+
+    seg = live_attach(name);
+    if (seg == NULL)
+    {
+        fprintf(stderr, "%s: no game running\n", name);
+        return 1;
+    }
+
+    if (seconds != 0)
+    {
+        bench(seg, seconds);
+        live_detach(seg);
+        return 0;
+    }
+
+    while (1)
+    {
+        if (live_read(seg, &s))
+        {
+            if (s.tick != last)
+            {
+                show(&s);
+                last = s.tick;
+            }
+
+            if (s.flags & LIVE_ENDED)
+                break;
+        }
+
+        usleep(interval * 1000);
+    }
+
+    live_detach(seg);
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
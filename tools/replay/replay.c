@@ -0,0 +1,344 @@
+/**
+  ******************************************************************************
+  * @file    replay.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   主机工具共用的按键记录回放
+  * @note    记录文件与platform/MSP430Launchpad/sim的脚本格式相同:
+  *          每行 "毫秒 按键 [重复次数 间隔毫秒]", 按键为 left, right, up,
+  *          down, space, enter; 另外可以有一行 "seed 数字" 指定方块序列.
+  *          与两个平台一样, 游戏开始时处于暂停状态, 回车开始.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+// 一次按键
+typedef struct
+{
+    uint32_t time;          //!< ms
+    uint32_t order;         //!< 同一时刻的按键保持记录中的顺序
+    char key;               //!< 'l', 'r', 'u', 'd', ' ', '\r'
+} press_t;
+
+/* Private define ------------------------------------------------------------*/
+#define     PRESS_MAX           (1024 * 1024)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static press_t *press = NULL;
+static uint32_t press_count = 0;
+static uint32_t next_press = 0;
+static uint32_t load_seed = 1;         // 记录文件中的种子, 每次回放从它开始
+static uint32_t seed = 1;
+
+static bool pause = true;
+static uint32_t next_fall = 0;
+
+// 引擎回调的结果
+static uint16_t preview = 0;
+static uint8_t level = 1;
+static uint16_t lines = 0;
+static uint32_t score = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  xorshift32, 方块序列只由种子决定
+ */
+static uint8_t random_num(void)
+{
+    return (uint8_t)(xorshift(&seed) >> 24);
+}
+
+
+static void draw_box(uint8_t x, uint8_t y, uint8_t color)
+{
+    // 需要地图时用tetris_get_map()取
+    (void)x;
+    (void)y;
+    (void)color;
+
+    return;
+}
+
+
+static void get_preview_brick(const void *info)
+{
+    preview = *(const uint16_t *)info;
+
+    return;
+}
+
+
+/**
+ * \brief  计分规则与MSP430平台相同
+ */
+static void get_remove_line_num(uint8_t line)
+{
+    lines += line;
+    score += line_score[line <= 4 ? line : 0];
+    level = lines / 25 + 1;
+
+    return;
+}
+
+
+static int press_compare(const void *a, const void *b)
+{
+    const press_t *pa = a, *pb = b;
+
+    if (pa->time != pb->time)
+        return (pa->time < pb->time) ? -1 : 1;
+
+    return (pa->order < pb->order) ? -1 : 1;
+}
+
+
+/**
+ * \brief  响应一个按键, 与平台的game_key()相同
+ */
+static void game_key(char key, uint32_t now)
+{
+    if (key == '\r')
+    {
+        pause = !pause;
+        next_fall = now + FALL_MS(level);
+        return;
+    }
+
+    if (pause)
+        return;
+
+    switch (key)
+    {
+    case 'l':
+        tetris_move(dire_left);
+        break;
+    case 'r':
+        tetris_move(dire_right);
+        break;
+    case 'u':
+        tetris_move(dire_rotate);
+        break;
+    case 'd':
+        tetris_move(dire_down);
+        break;
+    case ' ':
+        while (tetris_move(dire_down));
+        break;
+    default:
+        break;
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  读入按键记录, 按时间排序
+ *
+ * \param  path
+ *
+ * \return 成功返回true
+ */
+bool replay_load(const char *path)
+{
+    static const struct
+    {
+        const char *name;
+        char key;
+    } key_names[] =
+    {
+        {"left", 'l'}, {"right", 'r'}, {"up", 'u'},
+        {"down", 'd'}, {"space", ' '}, {"enter", '\r'},
+    };
+    FILE *f = fopen(path, "r");
+    char line[128], name[16];
+    unsigned long ms, count, interval, line_no = 0;
+    size_t i;
+    int n;
+
+    if (f == NULL)
+    {
+        perror(path);
+        return false;
+    }
+
+    // 再次读入时丢弃上一个记录
+    free(press);
+    press_count = 0;
+    load_seed = 1;
+
+    press = malloc(PRESS_MAX * sizeof(press[0]));
+    if (press == NULL)
+    {
+        fclose(f);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        line_no++;
+        if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0')
+            continue;
+
+        if (sscanf(line, "seed %lu", &ms) == 1)
+        {
+            load_seed = ms ? (uint32_t)ms : 1;
+            continue;
+        }
+
+        count = 1;
+        interval = 0;
+        n = sscanf(line, "%lu %15s %lu %lu", &ms, name, &count, &interval);
+
+        for (i = 0; n >= 2 && i < sizeof(key_names) / sizeof(key_names[0]); i++)
+        {
+            if (strcmp(name, key_names[i].name) == 0)
+                break;
+        }
+
+        if (n < 2 || i == sizeof(key_names) / sizeof(key_names[0]))
+        {
+            fprintf(stderr, "%s:%lu: bad line\n", path, line_no);
+            fclose(f);
+            return false;
+        }
+
+        for (; count > 0 && press_count < PRESS_MAX; count--, ms += interval)
+        {
+            press[press_count].time = (uint32_t)ms;
+            press[press_count].order = press_count;
+            press[press_count].key = key_names[i].key;
+            press_count++;
+        }
+    }
+
+    fclose(f);
+
+    qsort(press, press_count, sizeof(press[0]), press_compare);
+
+    return true;
+}
+
+
+/**
+ * \brief  初始化引擎, 从记录的开头回放
+ */
+void replay_start(void)
+{
+    next_press = 0;
+    seed = load_seed;
+    pause = true;
+    next_fall = 0;
+    preview = 0;
+    level = 1;
+    lines = 0;
+    score = 0;
+
+    tetris_init(&draw_box, &random_num, &get_preview_brick, &get_remove_line_num);
+
+    return;
+}
+
+
+/**
+ * \brief  按时间顺序处理到now为止的按键和下落
+ *
+ * \param  now ms, 不小于上一次调用的值
+ */
+void replay_advance(uint32_t now)
+{
+    while (!tetris_is_game_over())
+    {
+        if (next_press < press_count && press[next_press].time <= now
+            && (pause || press[next_press].time <= next_fall))
+        {
+            game_key(press[next_press].key, press[next_press].time);
+            next_press++;
+        }
+        else if (!pause && next_fall <= now)
+        {
+            tetris_move(dire_down);
+            next_fall += FALL_MS(level);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return;
+}
+
+
+uint32_t replay_end(void)
+{
+    return press_count ? press[press_count - 1].time + 1000 : 1000;
+}
+
+
+bool replay_is_pause(void)
+{
+    return pause;
+}
+
+
+uint16_t replay_preview(void)
+{
+    return preview;
+}
+
+
+uint8_t replay_level(void)
+{
+    return level;
+}
+
+
+uint16_t replay_lines(void)
+{
+    return lines;
+}
+
+
+uint32_t replay_score(void)
+{
+    return score;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file    replay.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   主机工具共用的按键记录回放
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _REPLAY_H_
+#define _REPLAY_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Tetris.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+// 方块下落周期(ms), 与MSP430平台相同
+#define     FALL_MS(level)      ((level) < 11 ? (12 - (level)) * 50 : 50)
+
+/* Exported functions ------------------------------------------------------- */
+// 读入记录文件, 出错时已打印原因
+extern bool replay_load(const char *path);
+// 初始化引擎, 游戏处于暂停状态
+extern void replay_start(void);
+// 按时间顺序处理到now(ms)为止的按键和下落
+extern void replay_advance(uint32_t now);
+// 最后一个按键之后一秒
+extern uint32_t replay_end(void);
+
+extern bool replay_is_pause(void);
+extern uint16_t replay_preview(void);
+extern uint8_t replay_level(void);
+extern uint16_t replay_lines(void);
+extern uint32_t replay_score(void);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
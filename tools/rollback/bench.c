@@ -0,0 +1,309 @@
+/**
+  ******************************************************************************
+  * @file    bench.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   回滚的开销测试和一致性检查
+  * @note    两个会话(玩家0和玩家1各一端)通过模拟的本地连接交换按键,
+  *          对端的按键晚d帧到达. 每一局结束时两端的状态必须与没有延迟
+  *          直接模拟的结果完全相同.
+  *          两种按键模式:
+  *              typical 每个玩家约1/4的帧有按键
+  *              worst   每一帧都有按键, 每次收到远端按键都预测错误,
+  *                      每一帧都回滚d帧, 即最坏情况
+  *          报告每次回滚(恢复快照并重新模拟d帧)的耗时, 以及它占60Hz
+  *          一帧(16.67ms)的比例.
+  *
+  *          用法: bench [-n 帧数] [-s 种子] [-d 延迟帧数]...
+  *          不给-d时测试8帧和16帧.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Tetris.h"
+#include "rollback.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define     DELAY_MAX           8           // 最多几个-d
+#define     FRAME_NS            16666667    // 60Hz
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static uint32_t seed = 1;
+static bool worst = false;
+
+// 每次回滚的耗时
+static uint32_t *sample = NULL;
+static uint32_t sample_count = 0;
+
+// 三个会话都比较大, 不放在栈上
+static rollback_t reference, peer[2];
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  某一局某一帧某个玩家的按键, 只由参数决定, 两端各自算出相同的值
+ */
+static uint8_t key_of(uint32_t match, uint32_t frame, uint8_t player)
+{
+    static const uint8_t key_table[8] = {'l', 'r', 'u', 'd', 'l', 'r', 'u', ' '};
+    uint32_t h = seed ^ (match * 0x9E3779B9u) ^ (frame * 0x85EBCA6Bu) ^ (player * 0xC2B2AE35u);
+
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+
+    if (!worst && (h & 0x03) != 0)
+        return 0;
+
+    return key_table[(h >> 8) & 0x07];
+}
+
+
+/**
+ * \brief  比较两个会话的当前状态
+ */
+static bool same_state(const rollback_t *a, const rollback_t *b)
+{
+    int16_t ma[TETRIS_MAP_HEIGHT], mb[TETRIS_MAP_HEIGHT];
+    tetris_brick_t ca, na, cb, nb;
+    uint8_t i;
+
+    for (i = 0; i < 2; i++)
+    {
+        tetris_get_map_r(&a->state.game[i], ma);
+        tetris_get_map_r(&b->state.game[i], mb);
+        tetris_get_brick_r(&a->state.game[i], &ca, &na);
+        tetris_get_brick_r(&b->state.game[i], &cb, &nb);
+
+        if (memcmp(ma, mb, sizeof(ma)) != 0 || memcmp(&ca, &cb, sizeof(ca)) != 0
+            || memcmp(&na, &nb, sizeof(na)) != 0
+            || a->state.lines[i] != b->state.lines[i]
+            || tetris_is_game_over_r(&a->state.game[i]) != tetris_is_game_over_r(&b->state.game[i]))
+            return false;
+    }
+
+    return true;
+}
+
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+
+/**
+ * \brief  远端按键到达, 记录回滚的耗时
+ */
+static bool deliver(rollback_t *rb, uint32_t match, uint32_t frame, uint8_t player, uint32_t limit)
+{
+    uint64_t start = clock_ns();
+    int n = rollback_remote_input(rb, frame, key_of(match, frame, player));
+    uint64_t cost = clock_ns() - start;
+
+    if (n < 0)
+        return false;
+
+    if (n > 0 && sample_count < limit)
+        sample[sample_count++] = (uint32_t)cost;
+
+    return true;
+}
+
+
+/**
+ * \brief  以延迟d帧运行, 返回false表示两端不一致
+ */
+static bool run(uint32_t delay, uint32_t frames)
+{
+    uint32_t match, f, end, total = 0, lines = 0;
+    uint64_t resimulated = 0, rollbacks = 0;
+    double avg;
+    uint32_t i, p99;
+
+    sample_count = 0;
+
+    for (match = 0; total < frames; match++)
+    {
+        rollback_init(&reference, seed + match, 0);
+        rollback_init(&peer[0], seed + match, 0);
+        rollback_init(&peer[1], seed + match, 1);
+
+        // 参照: 两个玩家的按键都立即可知
+        for (end = 0; end < frames - total; end++)
+        {
+            rollback_remote_input(&reference, end, key_of(match, end, 1));
+            rollback_advance(&reference, key_of(match, end, 0));
+
+            if (tetris_is_game_over_r(&reference.state.game[0])
+                || tetris_is_game_over_r(&reference.state.game[1]))
+            {
+                end++;
+                break;
+            }
+        }
+
+        // 两端: 对端的按键晚delay帧到达
+        for (f = 0; f < end; f++)
+        {
+            // 模拟第f帧之前收到第f - delay帧的按键, 回滚正好delay帧
+            if (f >= delay)
+            {
+                if (!deliver(&peer[0], match, f - delay, 1, frames)
+                    || !deliver(&peer[1], match, f - delay, 0, frames))
+                    return false;
+            }
+
+            rollback_advance(&peer[0], key_of(match, f, 0));
+            rollback_advance(&peer[1], key_of(match, f, 1));
+        }
+
+        // 最后几帧的按键
+        for (f = (end > delay) ? end - delay : 0; f < end; f++)
+        {
+            if (!deliver(&peer[0], match, f, 1, frames) || !deliver(&peer[1], match, f, 0, frames))
+                return false;
+        }
+
+        if (!same_state(&reference, &peer[0]) || !same_state(&reference, &peer[1]))
+        {
+            fprintf(stderr, "match %lu: peers diverged\n", (unsigned long)match);
+            return false;
+        }
+
+        total += end;
+        lines += reference.state.lines[0] + reference.state.lines[1];
+        rollbacks += peer[0].rollbacks + peer[1].rollbacks;
+        resimulated += peer[0].resimulated + peer[1].resimulated;
+    }
+
+    printf("%-7s delay %2lu: %lu frames, %lu matches, %lu lines, %llu rollbacks, %.1f frames each\n",
+           worst ? "worst" : "typical", (unsigned long)delay, (unsigned long)total,
+           (unsigned long)match, (unsigned long)lines, (unsigned long long)rollbacks,
+           rollbacks ? (double)resimulated / rollbacks : 0.0);
+
+    if (sample_count == 0)
+        return true;
+
+    for (i = 0, avg = 0; i < sample_count; i++)
+        avg += sample[i];
+    avg /= sample_count;
+
+    qsort(sample, sample_count, sizeof(sample[0]), compare_u32);
+    // max中可能含有被操作系统调度出去的时间, p99更能代表回滚本身
+    p99 = sample[sample_count - 1 - sample_count / 100];
+    printf("                  rollback: avg %.1f us, p99 %.1f us (%.3f%% of a 60Hz frame), max %.1f us\n",
+           avg / 1000, p99 / 1000.0, p99 * 100.0 / FRAME_NS, sample[sample_count - 1] / 1000.0);
+
+    return true;
+}
+
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-n frames] [-s seed] [-d delay (1 - %u)]...\n", name, ROLLBACK_MAX);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    unsigned long frames = 100000, delay[DELAY_MAX] = {8, 16};
+    uint8_t delays = 0, i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:s:d:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            frames = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            if (delays < DELAY_MAX)
+                delay[delays++] = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (delays == 0)
+        delays = 2;
+
+    for (i = 0; i < delays; i++)
+    {
+        if (delay[i] == 0 || delay[i] > ROLLBACK_MAX)
+            return usage(argv[0]);
+    }
+
+    if (optind != argc || frames == 0)
+        return usage(argv[0]);
+
+    sample = malloc(frames * 2 * sizeof(sample[0]));
+    if (sample == NULL)
+        return 1;
+
+    for (worst = false; ; worst = true)
+    {
+        for (i = 0; i < delays; i++)
+        {
+            if (!run((uint32_t)delay[i], (uint32_t)frames))
+                return 1;
+        }
+
+        if (worst)
+            break;
+    }
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,12 @@
+#!/bin/sh
+# 在主机上编译回滚的测试程序, 用法见bench.c
+
+CFLAGS="-std=gnu99 -O2 -Wall -I../../src"
+
+gcc $CFLAGS -c bench.c || exit 1
+gcc $CFLAGS -c rollback.c || exit 1
+gcc $CFLAGS -c ../../src/Tetris.c || exit 1
+gcc $CFLAGS -c ../../src/util.c || exit 1
+gcc -o bench bench.o rollback.o Tetris.o util.o || exit 1
+
+rm -f *.o
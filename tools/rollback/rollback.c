@@ -0,0 +1,260 @@
+/**
+  ******************************************************************************
+  * @file    rollback.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   双人对战的确定性帧同步与回滚
+  * @note    两端各自模拟两个玩家: 本地按键立即生效, 远端按键还没到时
+  *          预测为没有按键, 照常模拟. 每一帧开始前把状态存入环形缓冲,
+  *          收到的远端按键与预测不同时, 恢复那一帧的快照, 用正确的按键
+  *          重新模拟到当前帧. 引擎实例的全部状态(包括随机数)都在tetris_t
+  *          中, 快照就是一次结构体复制, 两端的结果完全相同.
+  *          规则与tools/versus/server.c相同: 先处理按键, 然后下落,
+  *          最后推入这一帧收到的垃圾行.
+  ******************************************************************************
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include "rollback.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static void on_remove_line(tetris_t *t, uint8_t line);
+
+static const tetris_ops_t session_ops =
+{
+    NULL,               // 不显示, 需要时由使用者取地图
+    NULL,               // 使用实例内部的随机数, 是快照的一部分
+    NULL,
+    on_remove_line,
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  引擎回调, 消行时给对手送垃圾行(2行1, 3行2, 4行4)
+ */
+static void on_remove_line(tetris_t *t, uint8_t line)
+{
+    static const uint8_t garbage_table[5] = {0, 0, 1, 2, 4};
+    rollback_state_t *s = t->user;
+    uint8_t i = (t == &s->game[0]) ? 0 : 1;
+
+    if (line == 0 || line > 4)
+        return;
+
+    s->lines[i] += line;
+    s->garbage[i ^ 1] += garbage_table[line];
+
+    return;
+}
+
+
+/**
+ * \brief  响应一个按键
+ */
+static void apply_key(tetris_t *t, uint8_t key)
+{
+    switch (key)
+    {
+    case 'l':
+        tetris_move_r(t, dire_left);
+        break;
+    case 'r':
+        tetris_move_r(t, dire_right);
+        break;
+    case 'u':
+        tetris_move_r(t, dire_rotate);
+        break;
+    case 'd':
+        tetris_move_r(t, dire_down);
+        break;
+    case ' ':
+        while (tetris_move_r(t, dire_down));
+        break;
+    default:
+        break;
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  模拟一帧
+ *
+ * \param  s
+ * \param  input 两个玩家的按键
+ * \param  frame 帧号
+ */
+static void step(rollback_state_t *s, const uint8_t *input, uint32_t frame)
+{
+    uint8_t i;
+
+    for (i = 0; i < 2; i++)
+    {
+        if (tetris_is_game_over_r(&s->game[i]))
+            continue;
+
+        apply_key(&s->game[i], input[i]);
+
+        if (frame % ROLLBACK_FALL == 0)
+            tetris_move_r(&s->game[i], dire_down);
+    }
+
+    // 两边都处理完才推入垃圾行, 与处理顺序无关
+    for (i = 0; i < 2; i++)
+    {
+        if (s->garbage[i] != 0)
+        {
+            tetris_add_garbage_r(&s->game[i], s->garbage[i],
+                                 (uint8_t)(xorshift(&s->seed) % TETRIS_MAP_WIDTH));
+            s->garbage[i] = 0;
+        }
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  某一帧的远端按键, 还没收到时预测为没有按键
+ */
+static uint8_t remote_key(const rollback_t *rb, uint32_t frame)
+{
+    const rollback_input_t *in = &rb->remote[frame % ROLLBACK_RING];
+
+    return (in->frame == frame) ? in->key : 0;
+}
+
+
+/**
+ * \brief  初始化会话
+ *
+ * \param  rb
+ * \param  seed  两端相同
+ * \param  local 本地玩家
+ */
+void rollback_init(rollback_t *rb, uint32_t seed, uint8_t local)
+{
+    uint8_t i;
+
+    for (i = 0; i < 2; i++)
+    {
+        tetris_init_r(&rb->state.game[i], &session_ops, &rb->state, seed);
+        rb->state.lines[i] = 0;
+        rb->state.garbage[i] = 0;
+    }
+    rb->state.seed = (seed * 2654435761u) | 1;
+
+    for (i = 0; i < ROLLBACK_RING; i++)
+        rb->remote[i].frame = UINT32_MAX;
+
+    rb->frame = 0;
+    rb->local = local & 0x01;
+    rb->rollbacks = 0;
+    rb->resimulated = 0;
+
+    return;
+}
+
+
+/**
+ * \brief  模拟一帧
+ *
+ * \param  rb
+ * \param  key 本地按键
+ *
+ * \return 这一帧的帧号, 对端用它标记收到的按键
+ */
+uint32_t rollback_advance(rollback_t *rb, uint8_t key)
+{
+    rollback_frame_t *f = &rb->ring[rb->frame % ROLLBACK_RING];
+
+    f->state = rb->state;
+    f->input[rb->local] = key;
+    f->input[rb->local ^ 1] = remote_key(rb, rb->frame);
+    step(&rb->state, f->input, rb->frame);
+
+    return rb->frame++;
+}
+
+
+/**
+ * \brief  收到远端按键
+ *
+ * \param  rb
+ * \param  frame 按键所属的帧
+ * \param  key   0为没有按键, 确认这一帧的预测
+ *
+ * \return 重新模拟的帧数, 0表示预测正确或这一帧还没模拟
+ *         -1表示帧号超出范围, 按键被丢掉, 两端会不一致
+ */
+int rollback_remote_input(rollback_t *rb, uint32_t frame, uint8_t key)
+{
+    uint8_t remote = rb->local ^ 1;
+    rollback_frame_t *f;
+    uint32_t g;
+
+    if (frame + ROLLBACK_MAX < rb->frame || frame > rb->frame + ROLLBACK_AHEAD)
+        return -1;
+
+    rb->remote[frame % ROLLBACK_RING].frame = frame;
+    rb->remote[frame % ROLLBACK_RING].key = key;
+
+    if (frame >= rb->frame)
+        return 0;
+
+    f = &rb->ring[frame % ROLLBACK_RING];
+    if (f->input[remote] == key)
+        return 0;
+
+    // 回到那一帧开始的状态, 用正确的按键重新模拟, 途中更新每一帧的快照
+    rb->state = f->state;
+    for (g = frame; g < rb->frame; g++)
+    {
+        f = &rb->ring[g % ROLLBACK_RING];
+        f->state = rb->state;
+        f->input[remote] = remote_key(rb, g);
+        step(&rb->state, f->input, g);
+    }
+
+    rb->rollbacks++;
+    rb->resimulated += rb->frame - frame;
+
+    return (int)(rb->frame - frame);
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,96 @@
+/**
+  ******************************************************************************
+  * @file    rollback.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   双人对战的确定性帧同步与回滚
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _ROLLBACK_H_
+#define _ROLLBACK_H_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Tetris.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define     ROLLBACK_RING       64      // 快照和远端按键的环形缓冲大小
+#define     ROLLBACK_MAX        31      // 最多回滚的帧数
+#define     ROLLBACK_AHEAD      32      // 远端按键最多可以提前的帧数
+
+// 方块下落间隔(帧), 与tools/versus/server.c的默认值相同
+#define     ROLLBACK_FALL       30
+
+/* Exported types ------------------------------------------------------------*/
+// 两个玩家的全部状态, 整个复制即为快照
+typedef struct
+{
+    tetris_t game[2];
+    uint16_t lines[2];
+    uint8_t garbage[2];                 //!< 这一帧收到的垃圾行, 帧结束时推入
+    uint32_t seed;                      //!< 垃圾行缺口的随机数
+} rollback_state_t;
+
+typedef struct
+{
+    rollback_state_t state;             //!< 这一帧开始时的状态
+    uint8_t input[2];                   //!< 这一帧两个玩家的按键, 远端可能是预测的
+} rollback_frame_t;
+
+typedef struct
+{
+    uint32_t frame;                     //!< 按键所属的帧
+    uint8_t key;
+} rollback_input_t;
+
+// 会话, 初始化之后不能移动(引擎实例的user指向state)
+typedef struct
+{
+    rollback_state_t state;             //!< 当前状态, 即第frame帧开始时
+    rollback_frame_t ring[ROLLBACK_RING];
+    rollback_input_t remote[ROLLBACK_RING];
+    uint32_t frame;                     //!< 下一个要模拟的帧
+    uint8_t local;                      //!< 本地玩家, 0或1
+    uint32_t rollbacks;                 //!< 回滚次数
+    uint32_t resimulated;               //!< 回滚时重新模拟的帧数
+} rollback_t;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+// 两端用相同的seed, local分别为0和1
+extern void rollback_init(rollback_t *rb, uint32_t seed, uint8_t local);
+// 用本地按键(0为没有按键)模拟一帧, 远端按键未到时预测为没有按键, 返回这一帧的帧号
+extern uint32_t rollback_advance(rollback_t *rb, uint8_t key);
+// 收到远端某一帧的按键, 预测错误时回滚并重新模拟到当前帧
+// 返回重新模拟的帧数, 帧号超出范围(太旧或太超前)时返回-1
+extern int rollback_remote_input(rollback_t *rb, uint32_t frame, uint8_t key);
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,13 @@
+#!/bin/sh
+# 在主机上编译观战数据流的编码校验程序, 用法见spectate.c
+
+CFLAGS="-std=gnu99 -O2 -Wall -I../../src -I../replay"
+
+gcc $CFLAGS -c spectate.c || exit 1
+gcc $CFLAGS -c ../replay/replay.c || exit 1
+gcc $CFLAGS -c ../../src/delta.c || exit 1
+gcc $CFLAGS -c ../../src/Tetris.c || exit 1
+gcc $CFLAGS -c ../../src/util.c || exit 1
+gcc -o spectate spectate.o replay.o delta.o Tetris.o util.o || exit 1
+
+rm -f *.o
@@ -0,0 +1,228 @@
+/**
+  ******************************************************************************
+  * @file    spectate.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   把按键记录编码成观战数据流, 并解码校验
+  * @note    按固定tick率回放记录, 每个tick由引擎的tetris_changed_rows()
+  *          得到改变过的行, 交给delta_encode()编码; 同时用两个解码器解码:
+  *          一个从头开始, 一个从中途加入(从下一个关键帧开始同步),
+  *          每个tick都与原始画面比较. 最后报告每tick字节数和压缩比.
+  *
+  *          用法: spectate [-r tick率] [-k 关键帧间隔(tick)] [-t 秒]
+  *                         [-o 输出文件] 记录文件
+  *          记录文件的格式见tools/replay/replay.c.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Tetris.h"
+#include "delta.h"
+#include "replay.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+// 不压缩时一帧的字节数: 地图, 预览, 级别, 行数, 分数, 标志
+#define     RAW_FRAME_SIZE      (TETRIS_MAP_HEIGHT * 2 + 2 + 1 + 2 + 4 + 1)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * \brief  比较解码出的帧与原始画面
+ */
+static bool frame_equal(const delta_frame_t *a, const delta_frame_t *b)
+{
+    uint8_t y;
+
+    for (y = 0; y < TETRIS_MAP_HEIGHT; y++)
+    {
+        if (((a->map[y] ^ b->map[y]) & 0x03FF) != 0)
+            return false;
+    }
+
+    return a->preview == b->preview && a->level == b->level
+        && a->lines == b->lines && a->score == b->score
+        && a->flags == b->flags;
+}
+
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-r ticks/s] [-k keyframe ticks] [-t seconds] [-o out.bin] replay\n", name);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *out_path = NULL;
+    unsigned long rate = 30, keyframe = 150, seconds = 0;
+    uint32_t tick, now, end, join, join_synced = 0;
+    unsigned long total = 0, idle = 0, largest = 0;
+    delta_encoder_t enc;
+    delta_decoder_t dec, late;
+    delta_frame_t frame;
+    uint8_t buf[DELTA_TICK_MAX], size;
+    FILE *out = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:k:t:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            rate = strtoul(optarg, NULL, 0);
+            break;
+        case 'k':
+            keyframe = strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            seconds = strtoul(optarg, NULL, 0);
+            break;
+        case 'o':
+            out_path = optarg;
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (optind != argc - 1 || rate == 0 || keyframe > 0xFFFE)
+        return usage(argv[0]);
+
+    if (!replay_load(argv[optind]))
+        return 1;
+
+    end = seconds ? (uint32_t)(seconds * 1000) : replay_end();
+
+    if (out_path != NULL)
+    {
+        out = fopen(out_path, "wb");
+        if (out == NULL)
+        {
+            perror(out_path);
+            return 1;
+        }
+    }
+
+    delta_encoder_init(&enc, (uint16_t)keyframe);
+    delta_decoder_init(&dec);
+    delta_decoder_init(&late);
+
+    // 中途加入的观众从一半的时间开始收数据
+    join = (uint32_t)((uint64_t)end * rate / 2000);
+
+    replay_start();
+
+    for (tick = 0; ; tick++)
+    {
+        now = (uint32_t)((uint64_t)tick * 1000 / rate);
+        replay_advance(now);
+
+        tetris_get_map(frame.map);
+        frame.preview = replay_preview();
+        frame.level = replay_level();
+        frame.lines = replay_lines();
+        frame.score = replay_score();
+        frame.flags = (replay_is_pause() ? DELTA_PAUSE : 0)
+                    | (tetris_is_game_over() ? DELTA_GAME_OVER : 0);
+
+        // 改变过的行在同步之前取
+        size = delta_encode(&enc, &frame, tetris_changed_rows(), buf);
+        tetris_sync();
+
+        total += size;
+        if (size == 1)
+            idle++;
+        if (size > largest)
+            largest = size;
+        if (out != NULL)
+            fwrite(buf, 1, size, out);
+
+        if (delta_decode(&dec, buf, size) != size || !frame_equal(&dec.frame, &frame))
+        {
+            fprintf(stderr, "tick %lu: decoded frame differs\n", (unsigned long)tick);
+            return 1;
+        }
+
+        if (tick >= join)
+        {
+            if (delta_decode(&late, buf, size) != size)
+            {
+                fprintf(stderr, "tick %lu: late decoder failed\n", (unsigned long)tick);
+                return 1;
+            }
+
+            if (late.synced && join_synced == 0)
+                join_synced = tick + 1;
+
+            if (late.synced && !frame_equal(&late.frame, &frame))
+            {
+                fprintf(stderr, "tick %lu: late decoder differs\n", (unsigned long)tick);
+                return 1;
+            }
+        }
+
+        if (tetris_is_game_over() || now >= end)
+            break;
+    }
+
+    if (out != NULL)
+        fclose(out);
+
+    tick++;
+    printf("%lu ticks at %lu/s, keyframe every %lu ticks\n",
+           (unsigned long)tick, rate, keyframe);
+    printf("stream: %lu bytes, %.2f bytes/tick, largest tick %lu bytes, %lu idle ticks\n",
+           total, (double)total / tick, largest, idle);
+    printf("raw:    %lu bytes, %u bytes/tick, ratio %.1f:1\n",
+           (unsigned long)tick * RAW_FRAME_SIZE, RAW_FRAME_SIZE,
+           (double)tick * RAW_FRAME_SIZE / total);
+    printf("bandwidth: %.0f bit/s per spectator\n", (double)total * 8 * rate / tick);
+    if (join_synced != 0)
+        printf("late join at tick %lu, in sync after %lu ticks\n",
+               (unsigned long)join, (unsigned long)(join_synced - join));
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,14 @@
+#!/bin/sh
+# 在主机上编译对战服务器和压力测试程序, 用法见server.c和loadgen.c
+
+CFLAGS="-std=gnu99 -D_GNU_SOURCE -O2 -Wall -I../../src"
+
+gcc $CFLAGS -c server.c || exit 1
+gcc $CFLAGS -c loadgen.c || exit 1
+gcc $CFLAGS -c ../../src/delta.c || exit 1
+gcc $CFLAGS -c ../../src/Tetris.c || exit 1
+gcc $CFLAGS -c ../../src/util.c || exit 1
+gcc -o server server.o delta.o Tetris.o util.o || exit 1
+gcc -o loadgen loadgen.o delta.o util.o || exit 1
+
+rm -f *.o
@@ -0,0 +1,317 @@
+/**
+  ******************************************************************************
+  * @file    loadgen.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   对战服务器的压力测试
+  * @note    一个线程用epoll模拟大量客户端: 每个客户端加入, 收到画面后随机
+  *          按键, 一局结束后马上再加入. 收到的数据都用delta_decode()解码,
+  *          检查数据流没有错误.
+  *          延迟为按键发出到收到下一个画面的时间, 包含等待服务器tick的时间.
+  *
+  *          用法: loadgen [-s socket路径] [-c 客户端数] [-t 秒]
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include "delta.h"
+#include "versus.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    int fd;
+    delta_decoder_t dec;
+    uint64_t key_sent;              //!< 最早一个还没看到画面的按键的发送时间, 0为没有
+    uint16_t in_len;
+    uint8_t in[4096];
+} client_t;
+
+/* Private define ------------------------------------------------------------*/
+#define     EVENT_MAX           256
+#define     LATENCY_SLOTS       10000       // 10us一格, 最多100ms
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static client_t *client;
+static uint32_t seed = 0x9E3779B9;
+
+// 统计
+static unsigned long ticks = 0, wins = 0, errors = 0, keys = 0;
+static unsigned long latency[LATENCY_SLOTS + 1];
+static unsigned long latency_count = 0;
+static uint64_t latency_max = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static void client_send(client_t *c, uint8_t byte)
+{
+    // 本地socket, 客户端发得很少, 不会写满
+    if (send(c->fd, &byte, 1, MSG_NOSIGNAL) != 1)
+        errors++;
+
+    return;
+}
+
+
+/**
+ * \brief  收到一个画面, 随机按键
+ */
+static void client_tick(client_t *c, uint64_t now)
+{
+    static const uint8_t key_table[8] = {'l', 'r', 'u', 'd', 'l', 'r', 'u', ' '};
+    uint64_t slot;
+    uint32_t r;
+
+    ticks++;
+
+    if (c->key_sent != 0)
+    {
+        if (now - c->key_sent > latency_max)
+            latency_max = now - c->key_sent;
+        slot = (now - c->key_sent) / 10000;
+        latency[slot < LATENCY_SLOTS ? slot : LATENCY_SLOTS]++;
+        latency_count++;
+        c->key_sent = 0;
+    }
+
+    r = xorshift(&seed);
+    if ((r & 0x03) != 0)
+        return;
+
+    client_send(c, key_table[(r >> 8) & 0x07]);
+    keys++;
+    c->key_sent = now;
+
+    return;
+}
+
+
+/**
+ * \brief  处理收到的数据, 不完整的消息留到下次
+ */
+static void client_read(client_t *c)
+{
+    uint64_t now = clock_ns();
+    uint16_t used, n;
+    ssize_t got;
+
+    got = recv(c->fd, c->in + c->in_len, sizeof(c->in) - c->in_len, 0);
+    if (got <= 0)
+    {
+        if (got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+        {
+            fprintf(stderr, "connection closed by server\n");
+            exit(1);
+        }
+        return;
+    }
+    c->in_len += (uint16_t)got;
+
+    for (used = 0; used < c->in_len; )
+    {
+        if (c->in[used] == VERSUS_RESULT)
+        {
+            if (used + 2 > c->in_len)
+                break;
+
+            wins += c->in[used + 1];
+            used += 2;
+
+            // 马上开始下一局
+            delta_decoder_init(&c->dec);
+            client_send(c, VERSUS_JOIN);
+            c->key_sent = 0;
+        }
+        else if (c->in[used] == VERSUS_TICK)
+        {
+            n = delta_decode(&c->dec, c->in + used + 1, c->in_len - used - 1);
+            if (n == 0)
+                break;
+
+            if (n == DELTA_ERROR || !c->dec.synced)
+            {
+                errors++;
+                c->in_len = 0;
+                return;
+            }
+
+            used += n + 1;
+            client_tick(c, now);
+        }
+        else
+        {
+            errors++;
+            c->in_len = 0;
+            return;
+        }
+    }
+
+    memmove(c->in, c->in + used, c->in_len - used);
+    c->in_len -= used;
+
+    return;
+}
+
+
+static double percentile(double p)
+{
+    unsigned long target = (unsigned long)(latency_count * p), sum = 0;
+    uint32_t i;
+
+    for (i = 0; i <= LATENCY_SLOTS; i++)
+    {
+        sum += latency[i];
+        if (sum > target)
+            break;
+    }
+
+    return i * 0.01;
+}
+
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-s socket] [-c clients] [-t seconds]\n", name);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *path = VERSUS_PATH;
+    unsigned long count = 1000, seconds = 10;
+    struct epoll_event ev, events[EVENT_MAX];
+    struct sockaddr_un addr;
+    struct rlimit rl;
+    uint64_t start, stop;
+    double elapsed;
+    uint32_t i;
+    int epoll_fd, opt, n, k;
+
+    while ((opt = getopt(argc, argv, "s:c:t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            path = optarg;
+            break;
+        case 'c':
+            count = strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            seconds = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (optind != argc || count < 2 || seconds == 0 || strlen(path) >= sizeof(addr.sun_path))
+        return usage(argv[0]);
+
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0)
+    {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    client = calloc(count, sizeof(client[0]));
+    if (client == NULL)
+        return 1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    epoll_fd = epoll_create1(0);
+
+    for (i = 0; i < count; i++)
+    {
+        client[i].fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (client[i].fd < 0 || connect(client[i].fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+        {
+            perror(path);
+            return 1;
+        }
+
+        // 连接后再设为非阻塞, 连接时服务器的backlog满了就等待
+        if (fcntl(client[i].fd, F_SETFL, O_NONBLOCK) != 0)
+            return 1;
+
+        delta_decoder_init(&client[i].dec);
+        ev.events = EPOLLIN;
+        ev.data.u32 = i;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client[i].fd, &ev);
+        client_send(&client[i], VERSUS_JOIN);
+    }
+
+    start = clock_ns();
+    stop = start + seconds * 1000000000ull;
+
+    while (clock_ns() < stop)
+    {
+        n = epoll_wait(epoll_fd, events, EVENT_MAX, 100);
+        for (k = 0; k < n; k++)
+            client_read(&client[events[k].data.u32]);
+    }
+
+    elapsed = (clock_ns() - start) / 1e9;
+
+    // 每局恰好有一个胜者, 除非同时输掉
+    printf("%lu clients, %.1f s: %lu matches won, %.1f matches/s\n",
+           count, elapsed, wins, wins / elapsed);
+    printf("%lu ticks received (%.0f/s), %lu keys sent, %lu stream errors\n",
+           ticks, ticks / elapsed, keys, errors);
+    if (latency_count != 0)
+        printf("key to next frame: p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+               percentile(0.5), percentile(0.99), latency_max / 1e6);
+
+    return errors != 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
@@ -0,0 +1,805 @@
+/**
+  ******************************************************************************
+  * @file    server.c
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   双人对战服务器
+  * @note    一个线程, epoll同时处理所有连接, timerfd产生固定频率的tick.
+  *          每个玩家一个引擎实例(tetris_init_r), 同一局的两个实例用相同的
+  *          种子, 方块序列相同. 一次消除n行时给对手送去垃圾行
+  *          (2行1, 3行2, 4行4), 在这个tick结束时从对手的地图底部推入.
+  *          客户端不读数据以致发送缓冲满时断开它, 不让一个客户端拖慢其他人.
+  *
+  *          用法: server [-s socket路径] [-r tick率] [-g 下落间隔(tick)]
+  *                       [-t 运行秒数]
+  *          结束(Ctrl+C或-t到时)时报告局数和每个tick的处理时间.
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/resource.h>
+#include "Tetris.h"
+#include "delta.h"
+#include "versus.h"
+#include "util.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct match match_t;
+
+typedef struct player
+{
+    int fd;
+    tetris_t game;
+    delta_encoder_t enc;
+    match_t *match;                 //!< NULL: 没有在对局中
+    struct player *opponent;
+    struct player *wait_next;       //!< 等待队列中的下一个
+    bool waiting;                   //!< 已加入, 在等待队列中
+    uint16_t preview;
+    uint16_t lines;
+    uint16_t sent;                  //!< 发给对手的垃圾行数
+    uint8_t garbage;                //!< 这个tick收到的垃圾行数
+    uint8_t key[16];                //!< 这个tick收到的按键
+    uint8_t key_count;
+    uint16_t out_len;               //!< out中尚未发出的字节数
+    uint8_t out[4096];
+} player_t;
+
+struct match
+{
+    player_t *player[2];
+    uint32_t seed;                  //!< 垃圾行缺口的随机数
+    uint32_t index;                 //!< 在match_list中的位置
+};
+
+/* Private define ------------------------------------------------------------*/
+#define     EVENT_MAX           256
+#define     TICK_SAMPLES        (1 << 16)   // 保存最近这么多个tick的处理时间
+
+#define     TAG_LISTEN          ((uint64_t)-1)
+#define     TAG_TIMER           ((uint64_t)-2)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static int epoll_fd, listen_fd, timer_fd;
+
+// 以fd为下标
+static player_t **players = NULL;
+static int players_size = 0;
+static uint32_t connected = 0;
+
+static match_t **match_list = NULL;
+static uint32_t match_count = 0, match_size = 0;
+// 已加入, 等待对手的玩家, 按加入的顺序两两开始一局
+static player_t *wait_head = NULL, *wait_tail = NULL;
+
+static uint32_t seed = 0x2545F491;
+static uint32_t fall_ticks = 30;
+static uint64_t tick = 0;
+
+// 统计
+static unsigned long matches_started = 0, matches_finished = 0, dropped = 0, overruns = 0;
+static uint32_t tick_ns[TICK_SAMPLES];
+
+static volatile sig_atomic_t running = 1;
+
+/* Private function prototypes -----------------------------------------------*/
+static void player_close(player_t *p);
+
+/* Private functions ---------------------------------------------------------*/
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    running = 0;
+
+    return;
+}
+
+
+/**
+ * \brief  引擎回调, 产生新方块
+ */
+static void on_next_brick(tetris_t *t, const void *info)
+{
+    ((player_t *)t->user)->preview = *(const uint16_t *)info;
+
+    return;
+}
+
+
+/**
+ * \brief  引擎回调, 消行时给对手送垃圾行
+ */
+static void on_remove_line(tetris_t *t, uint8_t line)
+{
+    static const uint8_t garbage_table[5] = {0, 0, 1, 2, 4};
+    player_t *p = t->user;
+
+    if (line == 0)
+        return;
+
+    p->lines += line;
+    if (p->opponent != NULL && line <= 4)
+    {
+        p->opponent->garbage += garbage_table[line];
+        p->sent += garbage_table[line];
+    }
+
+    return;
+}
+
+
+static const tetris_ops_t player_ops =
+{
+    NULL,               // 服务器不显示
+    NULL,               // 使用实例内部的随机数, 同一局的两个实例种子相同
+    on_next_brick,
+    on_remove_line,
+};
+
+
+/**
+ * \brief  发送数据, 先尽量直接写, 写不完的放入发送缓冲
+ *
+ * \return 发送缓冲满时断开连接, 返回false
+ */
+static bool player_send(player_t *p, const uint8_t *data, uint16_t len)
+{
+    struct epoll_event ev;
+    ssize_t n = 0;
+
+    if (p->out_len == 0)
+    {
+        n = send(p->fd, data, len, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                player_close(p);
+                return false;
+            }
+            n = 0;
+        }
+
+        if (n == len)
+            return true;
+
+        // 开始等待可写
+        ev.events = EPOLLIN | EPOLLOUT;
+        ev.data.u64 = (uint64_t)p->fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, p->fd, &ev);
+    }
+
+    if ((size_t)(p->out_len + len - n) > sizeof(p->out))
+    {
+        dropped++;
+        player_close(p);
+        return false;
+    }
+
+    memcpy(p->out + p->out_len, data + n, len - n);
+    p->out_len += (uint16_t)(len - n);
+
+    return true;
+}
+
+
+/**
+ * \brief  可写时发送缓冲中的数据
+ */
+static void player_flush(player_t *p)
+{
+    struct epoll_event ev;
+    ssize_t n;
+
+    n = send(p->fd, p->out, p->out_len, MSG_NOSIGNAL);
+    if (n < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+            player_close(p);
+        return;
+    }
+
+    memmove(p->out, p->out + n, p->out_len - n);
+    p->out_len -= (uint16_t)n;
+
+    if (p->out_len == 0)
+    {
+        ev.events = EPOLLIN;
+        ev.data.u64 = (uint64_t)p->fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, p->fd, &ev);
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  发送这个tick的画面
+ */
+static bool player_send_tick(player_t *p)
+{
+    uint8_t buf[1 + DELTA_TICK_MAX];
+    delta_frame_t frame;
+    uint8_t size;
+
+    tetris_get_map_r(&p->game, frame.map);
+    frame.preview = p->preview;
+    frame.level = 1;
+    frame.lines = p->lines;
+    frame.score = p->sent;
+    frame.flags = tetris_is_game_over_r(&p->game) ? DELTA_GAME_OVER : 0;
+
+    buf[0] = VERSUS_TICK;
+    size = delta_encode(&p->enc, &frame, tetris_changed_rows_r(&p->game), buf + 1);
+    tetris_sync_r(&p->game);
+
+    return player_send(p, buf, size + 1);
+}
+
+
+/**
+ * \brief  两个加入的玩家开始一局
+ *
+ * \retval true  成功
+ *         false 内存不足, 两个玩家都没有改变
+ */
+static bool match_start(player_t *a, player_t *b)
+{
+    match_t *m, **list;
+    uint32_t s, size;
+    player_t *p;
+    uint8_t i;
+
+    if (match_count == match_size)
+    {
+        size = match_size ? match_size * 2 : 256;
+        list = realloc(match_list, size * sizeof(match_list[0]));
+        if (list == NULL)
+            return false;
+        match_list = list;
+        match_size = size;
+    }
+
+    m = malloc(sizeof(*m));
+    if (m == NULL)
+        return false;
+
+    s = xorshift(&seed);
+
+    m->player[0] = a;
+    m->player[1] = b;
+    m->seed = xorshift(&seed) | 1;
+    m->index = match_count;
+    match_list[match_count++] = m;
+    matches_started++;
+
+    for (i = 0; i < 2; i++)
+    {
+        p = m->player[i];
+        p->match = m;
+        p->opponent = m->player[i ^ 1];
+        p->lines = 0;
+        p->sent = 0;
+        p->garbage = 0;
+        p->key_count = 0;
+        delta_encoder_init(&p->enc, 0);
+        tetris_init_r(&p->game, &player_ops, p, s);
+    }
+
+    return true;
+}
+
+
+/**
+ * \brief  加入等待队列的末尾
+ */
+static void wait_push(player_t *p)
+{
+    p->waiting = true;
+    p->wait_next = NULL;
+
+    if (wait_tail == NULL)
+        wait_head = p;
+    else
+        wait_tail->wait_next = p;
+    wait_tail = p;
+
+    return;
+}
+
+
+/**
+ * \brief  从等待队列中移走, 如断开连接时
+ */
+static void wait_remove(player_t *p)
+{
+    player_t **link = &wait_head, *prev = NULL;
+
+    if (!p->waiting)
+        return;
+
+    while (*link != p)
+    {
+        prev = *link;
+        link = &prev->wait_next;
+    }
+
+    *link = p->wait_next;
+    if (wait_tail == p)
+        wait_tail = prev;
+    p->waiting = false;
+    p->wait_next = NULL;
+
+    return;
+}
+
+
+/**
+ * \brief  等待队列中的玩家两两开始一局
+ *         内存不足时两个玩家留在队首, 下一个tick再试
+ */
+static void match_pair(void)
+{
+    player_t *a, *b;
+
+    while (wait_head != NULL && wait_head->wait_next != NULL)
+    {
+        a = wait_head;
+        b = a->wait_next;
+        if (!match_start(a, b))
+            return;
+
+        wait_remove(a);
+        wait_remove(b);
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  结束一局, loser为NULL时双方都输(同一个tick结束)
+ */
+static void match_end(match_t *m, const player_t *loser)
+{
+    uint8_t msg[2] = {VERSUS_RESULT, 0};
+    player_t *p[2] = {m->player[0], m->player[1]};
+    uint8_t i;
+
+    match_list[m->index] = match_list[--match_count];
+    match_list[m->index]->index = m->index;
+    matches_finished++;
+
+    for (i = 0; i < 2; i++)
+    {
+        if (p[i] != NULL)
+        {
+            p[i]->match = NULL;
+            p[i]->opponent = NULL;
+        }
+    }
+
+    for (i = 0; i < 2; i++)
+    {
+        if (p[i] != NULL && p[i]->fd >= 0)
+        {
+            msg[1] = (loser != NULL && loser != p[i]) ? 1 : 0;
+            player_send(p[i], msg, sizeof(msg));
+        }
+    }
+
+    free(m);
+
+    return;
+}
+
+
+/**
+ * \brief  断开连接, 对局中断开的一方输
+ */
+static void player_close(player_t *p)
+{
+    match_t *m = p->match;
+
+    if (p->fd < 0)
+        return;
+
+    wait_remove(p);
+
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, p->fd, NULL);
+    close(p->fd);
+    players[p->fd] = NULL;
+    p->fd = -1;
+    connected--;
+
+    if (m != NULL)
+    {
+        m->player[m->player[0] == p ? 0 : 1] = NULL;
+        match_end(m, p);
+    }
+
+    free(p);
+
+    return;
+}
+
+
+/**
+ * \brief  处理收到的命令
+ */
+static void player_read(player_t *p)
+{
+    uint8_t buf[256];
+    ssize_t n, i;
+
+    n = recv(p->fd, buf, sizeof(buf), 0);
+    if (n <= 0)
+    {
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+            player_close(p);
+        return;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        if (buf[i] == VERSUS_JOIN)
+        {
+            if (p->match != NULL || p->waiting)
+                continue;
+
+            wait_push(p);
+            match_pair();
+        }
+        else if (p->match != NULL && p->key_count < sizeof(p->key))
+        {
+            // 按键留到tick中处理, 一个tick中多余的按键丢掉
+            p->key[p->key_count++] = buf[i];
+        }
+    }
+
+    return;
+}
+
+
+static void player_accept(void)
+{
+    struct epoll_event ev;
+    player_t *p, **list;
+    int fd;
+
+    while ((fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+    {
+        if (fd >= players_size)
+        {
+            int size = players_size ? players_size : 1024;
+
+            while (size <= fd)
+                size *= 2;
+            list = realloc(players, size * sizeof(players[0]));
+            if (list == NULL)
+            {
+                close(fd);
+                continue;
+            }
+            players = list;
+            memset(players + players_size, 0, (size - players_size) * sizeof(players[0]));
+            players_size = size;
+        }
+
+        p = calloc(1, sizeof(*p));
+        if (p == NULL)
+        {
+            close(fd);
+            continue;
+        }
+
+        p->fd = fd;
+        players[fd] = p;
+        connected++;
+
+        ev.events = EPOLLIN;
+        ev.data.u64 = (uint64_t)fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  响应一个按键
+ */
+static void player_key(player_t *p, uint8_t key)
+{
+    switch (key)
+    {
+    case 'l':
+        tetris_move_r(&p->game, dire_left);
+        break;
+    case 'r':
+        tetris_move_r(&p->game, dire_right);
+        break;
+    case 'u':
+        tetris_move_r(&p->game, dire_rotate);
+        break;
+    case 'd':
+        tetris_move_r(&p->game, dire_down);
+        break;
+    case ' ':
+        while (tetris_move_r(&p->game, dire_down));
+        break;
+    default:
+        break;
+    }
+
+    return;
+}
+
+
+/**
+ * \brief  一局的一个tick
+ */
+static void match_tick(match_t *m)
+{
+    player_t *p;
+    bool over[2];
+    uint8_t i, k;
+
+    for (i = 0; i < 2; i++)
+    {
+        p = m->player[i];
+        for (k = 0; k < p->key_count && !tetris_is_game_over_r(&p->game); k++)
+            player_key(p, p->key[k]);
+        p->key_count = 0;
+
+        if (tick % fall_ticks == 0 && !tetris_is_game_over_r(&p->game))
+            tetris_move_r(&p->game, dire_down);
+    }
+
+    // 两边都处理完才推入垃圾行, 与处理顺序无关
+    for (i = 0; i < 2; i++)
+    {
+        p = m->player[i];
+        if (p->garbage != 0)
+        {
+            tetris_add_garbage_r(&p->game, p->garbage, (uint8_t)(xorshift(&m->seed) % TETRIS_MAP_WIDTH));
+            p->garbage = 0;
+        }
+        over[i] = tetris_is_game_over_r(&p->game);
+    }
+
+    // 发送可能断开连接并结束这一局
+    for (i = 0; i < 2; i++)
+    {
+        if (!player_send_tick(m->player[i]))
+            return;
+    }
+
+    if (over[0] || over[1])
+        match_end(m, (over[0] && over[1]) ? NULL : m->player[over[0] ? 0 : 1]);
+
+    return;
+}
+
+
+static void server_tick(void)
+{
+    uint64_t start = clock_ns();
+    uint32_t i;
+
+    // 之前内存不足没能开始的对局
+    match_pair();
+
+    // 结束的一局从表中移走, 由最后一局填补, 所以倒序处理
+    for (i = match_count; i > 0; i--)
+    {
+        if (i - 1 < match_count)
+            match_tick(match_list[i - 1]);
+    }
+
+    tick_ns[tick % TICK_SAMPLES] = (uint32_t)(clock_ns() - start);
+    tick++;
+
+    return;
+}
+
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+
+static void report(double seconds)
+{
+    uint32_t n = (tick < TICK_SAMPLES) ? (uint32_t)tick : TICK_SAMPLES;
+
+    printf("%.1f s, %lu ticks (%lu overruns), %lu matches started, %lu finished, %.1f matches/s\n",
+           seconds, (unsigned long)tick, overruns, matches_started, matches_finished,
+           matches_finished / seconds);
+    printf("%u connected, %lu dropped for not reading\n", connected, dropped);
+
+    if (n == 0)
+        return;
+
+    qsort(tick_ns, n, sizeof(tick_ns[0]), compare_u32);
+    printf("tick processing (last %u ticks): p50 %.1f us, p99 %.1f us, max %.1f us\n",
+           n, tick_ns[n / 2] / 1000.0, tick_ns[n - 1 - n / 100] / 1000.0, tick_ns[n - 1] / 1000.0);
+
+    return;
+}
+
+
+/**
+ * \brief  打印用法
+ *
+ * \return 1, 作为main()的返回值
+ */
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-s socket] [-r ticks/s] [-g fall ticks] [-t seconds]\n", name);
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *path = VERSUS_PATH;
+    unsigned long rate = 60, seconds = 0;
+    struct epoll_event ev, events[EVENT_MAX];
+    struct sockaddr_un addr;
+    struct itimerspec its;
+    struct rlimit rl;
+    uint64_t start, expirations;
+    int opt, n, i;
+
+    while ((opt = getopt(argc, argv, "s:r:g:t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            path = optarg;
+            break;
+        case 'r':
+            rate = strtoul(optarg, NULL, 0);
+            break;
+        case 'g':
+            fall_ticks = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            seconds = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+
+    if (optind != argc || rate == 0 || rate > 1000 || fall_ticks == 0
+        || strlen(path) >= sizeof(addr.sun_path))
+        return usage(argv[0]);
+
+    // 每个连接一个fd
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0)
+    {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+    if (listen_fd < 0 || bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0
+        || listen(listen_fd, SOMAXCONN) != 0)
+    {
+        perror(path);
+        return 1;
+    }
+
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    its.it_interval.tv_sec = 0;
+    its.it_interval.tv_nsec = (long)(1000000000u / rate);
+    its.it_value = its.it_interval;
+    timerfd_settime(timer_fd, 0, &its, NULL);
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    ev.events = EPOLLIN;
+    ev.data.u64 = TAG_LISTEN;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+    ev.data.u64 = TAG_TIMER;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev);
+
+    start = clock_ns();
+
+    while (running)
+    {
+        if (seconds != 0 && clock_ns() - start >= seconds * 1000000000ull)
+            break;
+
+        n = epoll_wait(epoll_fd, events, EVENT_MAX, 100);
+
+        for (i = 0; i < n; i++)
+        {
+            if (events[i].data.u64 == TAG_LISTEN)
+            {
+                player_accept();
+            }
+            else if (events[i].data.u64 == TAG_TIMER)
+            {
+                // 处理太慢时不补tick, 只计数
+                if (read(timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations))
+                {
+                    overruns += expirations - 1;
+                    server_tick();
+                }
+            }
+            else
+            {
+                player_t *p = players[events[i].data.u64];
+
+                // 同一批事件中前面的处理可能已经断开了它
+                if (p == NULL)
+                    continue;
+
+                if (events[i].events & EPOLLOUT)
+                    player_flush(p);
+                if (players[events[i].data.u64] == p && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+                    player_read(p);
+            }
+        }
+    }
+
+    report((clock_ns() - start) / 1e9);
+    unlink(path);
+
+    return 0;
+}
+
+
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/
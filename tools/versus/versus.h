@@ -0,0 +1,59 @@
+/**
+  ******************************************************************************
+  * @file    versus.h
+  * @author  ykaidong (http://www.DevLabs.cn)
+  * @version V0.1
+  * @date    2026-10-19
+  * @brief   双人对战服务器与客户端之间的协议
+  * @note    通过Unix domain socket(SOCK_STREAM)通信.
+  *          客户端 -> 服务器: 每个字节一个命令
+  *              VERSUS_JOIN         加入, 与下一个加入的客户端开始一局
+  *              'l' 'r' 'u' 'd' ' ' 按键, 在下一个tick生效
+  *          服务器 -> 客户端:
+  *              VERSUS_TICK + 一个tick的观战数据(见src/delta.c), 自己的地图,
+  *                      每局第一个tick为关键帧; score为发给对手的垃圾行数
+  *              VERSUS_RESULT + 1字节, 1为胜, 0为负; 之后可以再次加入
+  ******************************************************************************
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     ykaidong     the first version
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright(C) 2013-2014 by ykaidong<ykaidong@126.com>
+  *
+  * This program is free software; you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation; either version 2 of the
+  * License, or (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with this program; if not, write to the
+  * Free Software Foundation, Inc.,
+  * 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _VERSUS_H_
+#define _VERSUS_H_
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+#define     VERSUS_PATH         "/tmp/tetris-versus.sock"
+
+#define     VERSUS_JOIN         'J'
+#define     VERSUS_TICK         'T'
+#define     VERSUS_RESULT       'O'
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+#endif
+/************* Copyright(C) 2013 - 2014 DevLabs **********END OF FILE**********/